@@ -3,18 +3,22 @@
 // Andrei Gaponenko, 2012
 //
 // Modifed by Brian Pollack to use shared_ptrs to BFMaps for consistent use across classes.
+//
+// The state of the cache, the map used for the last point, is kept in a
+// BFieldQueryContext owned by the caller, so that one instance of this class
+// can be shared by all threads.  It is not modified after setMaps.
 
 #ifndef BFCacheManager_hh
 #define BFCacheManager_hh
 
-#include <cassert>
-#include <map>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "CLHEP/Vector/ThreeVector.h"
 
 #include "Offline/BFieldGeom/inc/BFMap.hh"
+#include "Offline/BFieldGeom/inc/BFieldQueryContext.hh"
 
 namespace mu2e {
 
@@ -28,94 +32,96 @@ namespace mu2e {
     //
 
     class BFCacheManager {
-        // typedef std::vector<const BFMap*> SequenceType;
-        // typedef std::vector<std::shared_ptr<const BFMap>> SequenceType;
         typedef std::vector<std::shared_ptr<BFMap>> MapContainerType;
-        struct MapList : public MapContainerType {
-            // return the first matching map or 0
-            std::shared_ptr<const BFMap> findMap(const CLHEP::Hep3Vector& x) const {
-                for (MapContainerType::const_iterator i = begin(); i != end(); ++i) {
-                    if ((*i)->isValid(x)) {
-                        return *i;
-                    }
-                }
-                return 0;
-            }
-        };
 
-        // An instance per (any) map, allows to optimize the lookup order of "inner" maps
+        // An instance per (any) map, allows to optimize the lookup order of "inner" maps.
+        // The list holds indices into inner; if "my" map is an inner map, it is not in the list.
         struct CacheElement {
-            std::shared_ptr<const BFMap> myMap;  // the map this instance is attached to
-            // A list of "inner" maps optimized for the "my" map
-            // If "my" map is an inner map, it is not in the list.
-            MapList inner;
-
-            CacheElement(std::shared_ptr<const BFMap> my, const MapList& in)
-                : myMap(my), inner(in) {}
+            std::vector<int> inner;
         };
 
-        // Inner map lists optimized for the last used map
-        mutable const CacheElement* innerForLastInner;
-        mutable const CacheElement* innerForLastOuter;  // never null
+        // Raw pointers to the maps; the shared_ptrs are held by the BFieldManager.
+        // Copying shared_ptrs on every lookup would make all threads write to the
+        // same reference counts.
+        std::vector<BFMap const*> inner;
+        std::vector<BFMap const*> outer;  // in the user-specified order
 
-        // Outer maps in the user-specified order
-        MapList outer;
+        std::vector<CacheElement> innerCache;  // one per inner map
+        std::vector<CacheElement> outerCache;  // one per outer map, then one for "no map"
 
-        typedef std::map<std::shared_ptr<const BFMap>, CacheElement> CacheType;
-        CacheType innerCache;  // keys are all inner maps
-        CacheType outerCache;  // keys are outer maps and 0
-        int counter;
+        // Identifies this instance to the query contexts.
+        std::uint64_t id;
+
+        // First map in the list that contains the point, or -1.
+        int findInner(const CacheElement& e, const CLHEP::Hep3Vector& x) const {
+            for (int i : e.inner) {
+                if (inner[i]->isValid(x)) {
+                    return i;
+                }
+            }
+            return -1;
+        }
 
        public:
         BFCacheManager();
 
         void setMaps(const MapContainerType& innerMaps, const MapContainerType& outerMaps);
 
-        // Returns pointers to an appropriate field map, or 0.
-        std::shared_ptr<const BFMap> findMap(const CLHEP::Hep3Vector& x) const {
-            // First try to find if the point belong to any of the inner maps
+        // Returns pointer to an appropriate field map, or 0.
+        BFMap const* findMap(const CLHEP::Hep3Vector& x, BFieldQueryContext& ctx) const {
+            if (ctx._managerId != id) {
+                ctx._managerId = id;
+                ctx._lastInner = -1;
+                ctx._lastOuter = outer.size();
+            }
 
-            if (innerForLastInner) {  // we were in an inner map last time
+            // First try to find if the point belong to any of the inner maps
+            int newinner;
+            if (ctx._lastInner >= 0) {  // we were in an inner map last time
 
-                if (innerForLastInner->myMap->isValid(x)) {
+                if (inner[ctx._lastInner]->isValid(x)) {
                     // Cache update not needed, we are still in the same inner map
-                    return innerForLastInner->myMap;
+                    return inner[ctx._lastInner];
                 }
 
                 // The lookup order here is optimized
-                std::shared_ptr<const BFMap> newinner = innerForLastInner->inner.findMap(x);
-                if (newinner) {  // Update cache
-                    CacheType::const_iterator p = innerCache.find(newinner);
-                    assert(p != innerCache.end());
-                    innerForLastInner = &p->second;
-                    return newinner;
-                }
+                newinner = findInner(innerCache[ctx._lastInner], x);
             } else {  // We were not in an inner map last time
-
-                // innerForLastOuter is never null
-                std::shared_ptr<const BFMap> newinner = innerForLastOuter->inner.findMap(x);
-                if (newinner) {  // Update cache
-                    CacheType::const_iterator p = innerCache.find(newinner);
-                    assert(p != innerCache.end());
-                    innerForLastInner = &p->second;
-                    return newinner;
-                }
+                newinner = findInner(outerCache[ctx._lastOuter], x);
+            }
+            if (newinner >= 0) {  // Update cache
+                ctx._lastInner = newinner;
+                return inner[newinner];
             }
 
             // The current point is not in any of the inner maps
-            innerForLastInner = 0;
+            ctx._lastInner = -1;
+
+            // The lookup order of the outer maps is always the same.
+            // Keep the inner map lookup optimized.
+            for (std::size_t i = 0; i < outer.size(); ++i) {
+                if (outer[i]->isValid(x)) {
+                    ctx._lastOuter = i;
+                    return outer[i];
+                }
+            }
+            ctx._lastOuter = outer.size();
+            return nullptr;
+        }
 
-            // The lookup order of the outer maps is always the same
-            std::shared_ptr<const BFMap> newouter = outer.findMap(x);
+        // As above, without caching.
+        BFMap const* findMap(const CLHEP::Hep3Vector& x) const {
+            BFieldQueryContext ctx;
+            return findMap(x, ctx);
+        }
 
-            // Keep the inner map lookup optimized
-            if (innerForLastOuter->myMap != newouter) {
-                CacheType::const_iterator p = outerCache.find(newouter);
-                assert(p != outerCache.end());
-                innerForLastOuter = &p->second;
+        bool isInnerMap(BFMap const* map) const {
+            for (auto const* m : inner) {
+                if (m == map) {
+                    return true;
+                }
             }
-
-            return newouter;
+            return false;
         }
     };
 }  // namespace mu2e
@@ -0,0 +1,75 @@
+#ifndef BFieldGeom_BFChebyshevGrid_hh
+#define BFieldGeom_BFChebyshevGrid_hh
+//
+// Piecewise Chebyshev approximation of a vector field on a box.  The box is divided
+// into a regular grid of cells and, in each cell, each field component is a tensor
+// product of Chebyshev polynomials of a fixed degree.  Evaluation costs the same at
+// every point and does not allocate.
+//
+// The approximation is filled from a user supplied sampler that returns the field on
+// a column of points at fixed (x,y); this lets an expensive sampler reuse work that
+// depends only on x and y.
+//
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace mu2e {
+
+    class BFChebyshevGrid {
+       public:
+        // Fill bx, by, bz with the field at (x, y, z[i]) for i < nz.
+        typedef std::function<void(
+            double x, double y, std::size_t nz, double const* z, double* bx, double* by, double* bz)>
+            ColumnSampler;
+
+        BFChebyshevGrid()
+            : _degree(0),
+              _ncx(0),
+              _ncy(0),
+              _ncz(0),
+              _xmin(0.),
+              _ymin(0.),
+              _zmin(0.),
+              _cx(0.),
+              _cy(0.),
+              _cz(0.) {}
+
+        // Fit the field on the box with the given number of cells in each dimension.
+        void fit(double xmin,
+                 double xmax,
+                 double ymin,
+                 double ymax,
+                 double zmin,
+                 double zmax,
+                 unsigned ncx,
+                 unsigned ncy,
+                 unsigned ncz,
+                 unsigned degree,
+                 ColumnSampler const& sampler);
+
+        // Points outside the box are evaluated in the nearest cell.
+        void evaluate(double x, double y, double z, double& bx, double& by, double& bz) const;
+
+        bool empty() const { return _coef.empty(); }
+        unsigned degree() const { return _degree; }
+        unsigned ncells() const { return _ncx * _ncy * _ncz; }
+        std::size_t memoryUsage() const { return _coef.size() * sizeof(double); }
+
+        // Largest degree supported by evaluate.
+        static constexpr unsigned maxDegree = 15;
+
+       private:
+        unsigned _degree;
+        unsigned _ncx, _ncy, _ncz;
+        double _xmin, _ymin, _zmin;
+        double _cx, _cy, _cz;  // cell sizes
+
+        // For each cell, for each of the 3 components, (degree+1)^3 coefficients.
+        std::vector<double> _coef;
+    };
+
+}  // namespace mu2e
+
+#endif /* BFieldGeom_BFChebyshevGrid_hh */
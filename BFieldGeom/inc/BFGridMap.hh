@@ -10,12 +10,21 @@
 // Rewritten in part by Krzysztof Genser to save execution time
 // Rewritten again by Brian Pollack to separate out Grid-like maps from other map types
 //
+// The map can optionally be packed into single precision, structure-of-arrays storage
+// (see packToFloat).  This halves the memory footprint and lets the interpolation
+// kernels run on contiguous per-component arrays.  The same storage can also be a
+// read-only memory mapped file (see BFMapFile and attachMappedFile).
+//
 
 //#include <iosfwd>
+#include <cstdint>
+#include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
 #include "Offline/BFieldGeom/inc/BFMap.hh"
+#include "Offline/BFieldGeom/inc/BFMapFile.hh"
 #include "Offline/BFieldGeom/inc/BFMapType.hh"
 #include "Offline/BFieldGeom/inc/Container3D.hh"
 #include "CLHEP/Vector/ThreeVector.h"
@@ -65,18 +74,80 @@ namespace mu2e {
               _field(_nx, _ny, _nz),
               _isDefined(_nx, _ny, _nz, false),
               _allDefined(false),
-              _interpStyle(style){};
+              _interpStyle(style),
+              _cacheId(newCacheId()){};
 
         ~BFGridMap(){};
 
         virtual bool getBFieldWithStatus(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
 
+        // For the trilinear style, the corner values of the cell that contains the point
+        // are kept in the context, and further points in the same cell are computed from
+        // them.  Other styles do not use the context.
+        virtual bool getBFieldCached(const CLHEP::Hep3Vector&,
+                                     BFieldQueryContext&,
+                                     CLHEP::Hep3Vector&) const;
+
+        // The gradient is the derivative of the interpolating polynomial, so the field
+        // and the gradient come from one pass over the same grid points.  Like the
+        // trilinear polynomial, the trilinear gradient is served from the cell cache.
+        virtual bool getBFieldGradient(const CLHEP::Hep3Vector&,
+                                       BFieldQueryContext&,
+                                       CLHEP::Hep3Vector&,
+                                       double grad[3][3]) const;
+
+        // Evaluate the field at n points given as separate coordinate arrays.
+        // The status of each point is returned in status[i]; points outside the
+        // map get a zero field.  The scale factor is applied, as for single points.
+        virtual void getBFieldBatch(std::size_t n,
+                                    double const* x,
+                                    double const* y,
+                                    double const* z,
+                                    double* bx,
+                                    double* by,
+                                    double* bz,
+                                    bool* status) const;
+
+        // Convert the map to single precision, structure-of-arrays storage and
+        // release the double precision copy. If nValidationPoints > 0, that many
+        // points spread over the map are evaluated with both representations
+        // before the double precision copy is released. Returns the largest
+        // difference in field magnitude found, in tesla.
+        double packToFloat(int nValidationPoints = 0);
+
+        bool isPacked() const { return _packed; }
+
+        // Use the field values of a mapped file, which must have the grid of this map.
+        // The double precision copy is released.
+        void attachMappedFile(std::shared_ptr<const BFMapFile> file);
+
+        bool isMapped() const { return bool(_mappedFile); }
+
+        // Write the map in the format read by BFMapFile.
+        void writeMappedFile(std::string const& filename) const;
+
+        // Approximate number of bytes used to hold the field values.
+        std::size_t memoryUsage() const;
+
         // Validity checker
         virtual bool isValid(const CLHEP::Hep3Vector& point) const;
         bool isValid(const GridPoint& ipoint) const {
             return _field.isValid(ipoint.ix, ipoint.iy, ipoint.iz);
         }
 
+        bool isDefined(unsigned ix, unsigned iy, unsigned iz) const {
+            return _packed ? isDefinedPacked(flatIndex(ix, iy, iz)) : _isDefined(ix, iy, iz);
+        }
+
+        // Field value at one grid point, from whichever storage is in use. Not scaled.
+        CLHEP::Hep3Vector gridValue(unsigned ix, unsigned iy, unsigned iz) const {
+            if (_packed) {
+                std::size_t i = flatIndex(ix, iy, iz);
+                return CLHEP::Hep3Vector(_bxp[i], _byp[i], _bzp[i]);
+            }
+            return _field(ix, iy, iz);
+        }
+
         // Some extra checks for GMC format maps.
         bool isGMCValid(CLHEP::Hep3Vector const& point) const;
 
@@ -125,6 +196,32 @@ namespace mu2e {
         // yet to be defined.
         BFInterpolationStyle _interpStyle;
 
+        // Identifies this map, in its current storage, to the cell cache of BFieldQueryContext.
+        std::uint64_t _cacheId;
+        static std::uint64_t newCacheId();
+
+        // Single precision storage, in the same index order as Container3D.  The pointers
+        // refer either to the vectors, filled by packToFloat, or to the mapped file.
+        bool _packed = false;
+        float const* _bxp = nullptr;
+        float const* _byp = nullptr;
+        float const* _bzp = nullptr;
+        std::vector<float> _bxf;
+        std::vector<float> _byf;
+        std::vector<float> _bzf;
+        std::shared_ptr<const BFMapFile> _mappedFile;
+
+        // One bit per grid point; only consulted when _allDefined is false.
+        std::uint64_t const* _definedp = nullptr;
+        std::vector<std::uint64_t> _definedBits;
+
+        // Fill single precision arrays from the double precision storage.
+        // Returns true if all points are defined.
+        bool fillFloatArrays(std::vector<float>& bx,
+                             std::vector<float>& by,
+                             std::vector<float>& bz,
+                             std::vector<std::uint64_t>& defined) const;
+
         // Functions used internally and by the code that populates the maps.
 
         // method to store the neighbors
@@ -144,8 +241,31 @@ namespace mu2e {
 
         std::size_t iZ(double z) const { return static_cast<int>((z - _zmin) / _dz + 0.5); }
 
+        // Find the trilinear cell containing p, loading it into the context if it is not
+        // already there, and the fractional coordinates t of p in the cell.  The y
+        // coordinate is folded to y>0 for maps with the XZ-plane symmetry.
+        bool loadCell(const CLHEP::Hep3Vector& p, BFieldQueryContext& ctx, double t[3]) const;
+
+        // Field and gradient from the 27 point quadratic stencil; not scaled or flipped.
+        bool quadraticGradient(const CLHEP::Hep3Vector&, double b[3], double grad[3][3]) const;
+
         bool interpolateTriLinear(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
         bool interpolateQuadratic(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
+
+        // Kernels that work on the packed storage.  The result is not scaled.
+        bool packedTriLinear(double px, double py, double pz, double& bx, double& by, double& bz) const;
+        bool packedQuadratic(double px, double py, double pz, double& bx, double& by, double& bz) const;
+
+        // Evaluate with the selected interpolation style; the result is not scaled.
+        bool interpolatePoint(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
+
+        std::size_t flatIndex(unsigned ix, unsigned iy, unsigned iz) const {
+            return (std::size_t(ix) * _ny + iy) * _nz + iz;
+        }
+
+        bool isDefinedPacked(std::size_t i) const {
+            return _allDefined || ((_definedp[i >> 6] >> (i & 63)) & 1u);
+        }
     };
 
     inline BFGridMap::GridPoint BFGridMap::point2grid(const CLHEP::Hep3Vector& pos) const {
@@ -12,11 +12,13 @@
 //
 
 //#include <iosfwd>
+#include <cstddef>
 #include <ostream>
 #include <string>
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
 #include "Offline/BFieldGeom/inc/BFMapType.hh"
 #include "Offline/BFieldGeom/inc/Container3D.hh"
+#include "Offline/BFieldGeom/inc/BFieldQueryContext.hh"
 #include "CLHEP/Vector/ThreeVector.h"
 
 namespace mu2e {
@@ -50,6 +52,56 @@ namespace mu2e {
         // Accessors
         virtual bool getBFieldWithStatus(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const = 0;
 
+        // As getBFieldWithStatus, for a caller that keeps a query context.  Maps that can
+        // reuse work between nearby points override this; the default ignores the context.
+        virtual bool getBFieldCached(const CLHEP::Hep3Vector& point,
+                                     BFieldQueryContext&,
+                                     CLHEP::Hep3Vector& result) const {
+            return getBFieldWithStatus(point, result);
+        }
+
+        // The field and its gradient, grad[i][j] = dB_i/dx_j in tesla/mm, at one point.
+        // Grid maps differentiate their interpolating polynomial; the default takes
+        // forward differences over gradientStep, which costs three more lookups.
+        virtual bool getBFieldGradient(const CLHEP::Hep3Vector& point,
+                                       BFieldQueryContext& ctx,
+                                       CLHEP::Hep3Vector& result,
+                                       double grad[3][3]) const {
+            const bool retval = getBFieldCached(point, ctx, result);
+            for (int j = 0; j < 3; ++j) {
+                CLHEP::Hep3Vector step(0., 0., 0.), b;
+                step[j] = gradientStep;
+                getBFieldCached(point + step, ctx, b);
+                for (int i = 0; i < 3; ++i) {
+                    grad[i][j] = (b[i] - result[i]) / gradientStep;
+                }
+            }
+            return retval;
+        }
+
+        // Step of the finite difference gradient, mm.
+        static constexpr double gradientStep = 0.01;
+
+        // Evaluate the field at n points given as separate coordinate arrays.
+        // The status of each point is returned in status[i].  Maps with a
+        // faster batch evaluation override this; the default loops over points.
+        virtual void getBFieldBatch(std::size_t n,
+                                    double const* x,
+                                    double const* y,
+                                    double const* z,
+                                    double* bx,
+                                    double* by,
+                                    double* bz,
+                                    bool* status) const {
+            CLHEP::Hep3Vector b;
+            for (std::size_t i = 0; i < n; ++i) {
+                status[i] = getBFieldWithStatus(CLHEP::Hep3Vector(x[i], y[i], z[i]), b);
+                bx[i] = b.x();
+                by[i] = b.y();
+                bz[i] = b.z();
+            }
+        }
+
         // Validity checker
         virtual bool isValid(const CLHEP::Hep3Vector& point) const = 0;
 
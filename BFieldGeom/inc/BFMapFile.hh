@@ -0,0 +1,88 @@
+#ifndef BFieldGeom_BFMapFile_hh
+#define BFieldGeom_BFMapFile_hh
+//
+// A pre-gridded, single precision magnetic field map file that is mapped
+// read-only into memory.  The pages of the file are shared by all processes
+// on a host that use the same map, and no parsing is needed at startup.
+//
+// Layout: a fixed size header followed by the Bx, By, Bz arrays of floats,
+// in Container3D index order, and optionally a bitmask of defined points.
+// Each array starts on a page boundary.  The grid is given in the Mu2e
+// coordinate system, units are mm and tesla.
+//
+// Files are written by BFieldManagerMaker when bfield.writeMappedMaps is true.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mu2e {
+
+    struct BFMapFileHeader {
+        char magic[8];             // "MU2EBFMP"
+        std::uint32_t endian;      // BFMapFile::endianMarker, as written by the producing host
+        std::uint32_t version;     // BFMapFile::currentVersion when written
+        std::uint32_t nx, ny, nz;  // grid dimensions
+        std::uint32_t flags;       // see BFMapFile::Flags
+        double xmin, ymin, zmin;   // first grid point
+        double dx, dy, dz;         // grid spacing
+        std::uint64_t offsetBx;    // byte offsets of the arrays from the start of the file
+        std::uint64_t offsetBy;
+        std::uint64_t offsetBz;
+        std::uint64_t offsetDefined;  // 0 if all points are defined
+        std::uint64_t fileSize;
+    };
+
+    class BFMapFile {
+       public:
+        static constexpr std::uint32_t endianMarker = 0x01020304;
+        static constexpr std::uint32_t currentVersion = 1;
+
+        enum Flags : std::uint32_t { flipY = 1, allDefined = 2 };
+
+        // Map the named file read-only.  Throws if the file is not a valid map.
+        explicit BFMapFile(std::string const& filename);
+        ~BFMapFile();
+
+        BFMapFile(BFMapFile const&) = delete;
+        BFMapFile& operator=(BFMapFile const&) = delete;
+
+        BFMapFileHeader const& header() const { return *static_cast<BFMapFileHeader const*>(_addr); }
+
+        float const* bx() const { return array<float>(header().offsetBx); }
+        float const* by() const { return array<float>(header().offsetBy); }
+        float const* bz() const { return array<float>(header().offsetBz); }
+
+        // Null if all points are defined.
+        std::uint64_t const* definedBits() const {
+            return header().offsetDefined ? array<std::uint64_t>(header().offsetDefined) : nullptr;
+        }
+
+        std::string const& filename() const { return _filename; }
+        std::size_t size() const { return _size; }
+
+        // Write a map file. The header grid description and flags must be filled by the
+        // caller; the identification and layout fields are filled here.  definedBits may
+        // be null if all points are defined.
+        static void write(std::string const& filename,
+                          BFMapFileHeader header,
+                          float const* bx,
+                          float const* by,
+                          float const* bz,
+                          std::uint64_t const* definedBits);
+
+       private:
+        std::string _filename;
+        void* _addr;
+        std::size_t _size;
+
+        template <typename T>
+        T const* array(std::uint64_t offset) const {
+            return reinterpret_cast<T const*>(static_cast<char const*>(_addr) + offset);
+        }
+    };
+
+}  // namespace mu2e
+
+#endif /* BFieldGeom_BFMapFile_hh */
@@ -7,6 +7,9 @@
 //
 // Original Brian Pollack, based on work by Krzysztof Genser, Rob Kutschke, Julie Managan, Bob
 // Bernstein.
+//
+// The series can optionally be compiled into a piecewise Chebyshev approximation
+// (see compile), which is then used in place of the series.
 
 //#include <iosfwd>
 #include <cmath>
@@ -15,6 +18,7 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include "Offline/BFieldGeom/inc/BFChebyshevGrid.hh"
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
 #include "Offline/BFieldGeom/inc/BFMap.hh"
 #include "Offline/BFieldGeom/inc/BFMapType.hh"
@@ -49,6 +53,28 @@ namespace mu2e {
 
         virtual void print(std::ostream& os) const;
 
+        // Result of compile.  Deviations are in tesla, before the scale factor.
+        struct CompileReport {
+            unsigned degree = 0;
+            unsigned ncells = 0;
+            std::size_t bytes = 0;
+            int nPoints = 0;
+            double maxDeviation[3] = {0., 0., 0.};
+            double maxDeviationMag = 0.;
+            bool converged = false;
+        };
+
+        // Fit the series with piecewise Chebyshev polynomials of the given degree.
+        // The cells are refined until the largest deviation from the series, found
+        // at nValidationPoints points spread over the map, is below tolerance, or
+        // until the coefficients would exceed maxBytes.
+        CompileReport compile(double tolerance,
+                              unsigned degree,
+                              int nValidationPoints,
+                              std::size_t maxBytes = 256 * 1024 * 1024);
+
+        bool isCompiled() const { return !_cheb.empty(); }
+
        private:
         // objects used to store the fit parameters
         int _ns;
@@ -66,6 +92,18 @@ namespace mu2e {
 
         // evaluate the fit for a given point.
         bool evalFit(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
+
+        // evaluate the series at (x, y, z[i]); the Bessel functions are computed once.
+        void sampleColumn(double x,
+                          double y,
+                          std::size_t nz,
+                          double const* z,
+                          double* bx,
+                          double* by,
+                          double* bz) const;
+
+        // compiled form of the series, used when not empty.
+        BFChebyshevGrid _cheb;
     };  // namespace mu2e
 
 }  // end namespace mu2e
@@ -63,13 +63,37 @@ namespace mu2e {
         // to trigger the map-writing hack inside the BFieldManagerMaker code.
         bool writeBinaries() const { return writeBinaries_; }
 
+        // Write every grid map in the memory mappable format read by BFMapFile.
+        bool writeMappedMaps() const { return writeMappedMaps_; }
+
         int verbosityLevel() const { return verbosityLevel_; }
 
         bool flipBFieldMaps() const { return flipBFieldMaps_; }
 
+        // Store grid maps in single precision, see BFGridMap::packToFloat.
+        bool useFloatStorage() const { return useFloatStorage_; }
+
+        // Number of points at which to compare the single and double precision maps.
+        int floatValidationPoints() const { return floatValidationPoints_; }
+
+        // Compile parametric maps to piecewise polynomials, see BFParamMap::compile.
+        // A tolerance of zero, in tesla, leaves the maps uncompiled.
+        double paramCompileTolerance() const { return paramCompileTolerance_; }
+        unsigned paramCompileDegree() const { return paramCompileDegree_; }
+        int paramCompileValidationPoints() const { return paramCompileValidationPoints_; }
+
        private:
         BFieldConfig()
-            : scaleFactor_(1.), writeBinaries_(false), verbosityLevel_(1), flipBFieldMaps_(false) {}
+            : scaleFactor_(1.),
+              writeBinaries_(false),
+              writeMappedMaps_(false),
+              verbosityLevel_(1),
+              flipBFieldMaps_(false),
+              useFloatStorage_(false),
+              floatValidationPoints_(0),
+              paramCompileTolerance_(0.),
+              paramCompileDegree_(8),
+              paramCompileValidationPoints_(1000) {}
 
         // GMC, G4BL or possible future types.
         BFMapType mapType_;
@@ -95,8 +119,14 @@ namespace mu2e {
         CLHEP::Hep3Vector dsGradientValue_;
 
         bool writeBinaries_;
+        bool writeMappedMaps_;
         int verbosityLevel_;
         bool flipBFieldMaps_;
+        bool useFloatStorage_;
+        int floatValidationPoints_;
+        double paramCompileTolerance_;
+        unsigned paramCompileDegree_;
+        int paramCompileValidationPoints_;
     };
 
 }  // namespace mu2e
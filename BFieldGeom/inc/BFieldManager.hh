@@ -13,8 +13,10 @@
 //
 
 // C++ includes
+#include <cstddef>
 #include <set>
 #include <string>
+#include <vector>
 
 // Includes from Mu2e
 #include "Offline/BFieldGeom/inc/BFCacheManager.hh"
@@ -23,6 +25,7 @@
 #include "Offline/BFieldGeom/inc/BFMap.hh"
 #include "Offline/BFieldGeom/inc/BFMapType.hh"
 #include "Offline/BFieldGeom/inc/BFParamMap.hh"
+#include "Offline/BFieldGeom/inc/BFieldQueryContext.hh"
 #include "Offline/DataProducts/inc/XYZVec.hh"
 #include "Offline/Mu2eInterfaces/inc/Detector.hh"
 
@@ -38,10 +41,16 @@ namespace mu2e {
         // Maps for various parts of the detector.
         typedef std::vector<std::shared_ptr<BFMap>> MapContainerType;
 
-        // Get field at an arbitrary point.
-        bool getBFieldWithStatus(const CLHEP::Hep3Vector&, CLHEP::Hep3Vector&) const;
+        // Get field at an arbitrary point.  The versions that take a context remember
+        // the map, and for grid maps the cell, used for the previous point; callers that
+        // make many queries, such as steppers and fitters, should keep one context per
+        // thread.  The versions without a context do not cache anything.
+        bool getBFieldWithStatus(const CLHEP::Hep3Vector& pos, CLHEP::Hep3Vector& result) const {
+            BFieldQueryContext ctx;
+            return getBFieldWithStatus(pos, ctx, result);
+        }
         bool getBFieldWithStatus(const CLHEP::Hep3Vector&,
-                                 BFCacheManager const&,
+                                 BFieldQueryContext&,
                                  CLHEP::Hep3Vector&) const;
 
         // Just return zero for out of range.
@@ -52,14 +61,20 @@ namespace mu2e {
             return result;
         }
 
-        CLHEP::Hep3Vector getBField(const CLHEP::Hep3Vector& pos,
-                                    BFCacheManager const& cmgr) const {
+        CLHEP::Hep3Vector getBField(const CLHEP::Hep3Vector& pos, BFieldQueryContext& ctx) const {
             // Default c'tor sets all components to zero - which is what we need here.
             CLHEP::Hep3Vector result;
-            getBFieldWithStatus(pos, cmgr, result);
+            getBFieldWithStatus(pos, ctx, result);
             return result;
         }
 
+        // Get the field and its gradient, grad[i][j] = dB_i/dx_j in tesla/mm, with one
+        // map lookup.  Out of range points get a zero field and gradient.
+        bool getBFieldGradient(const CLHEP::Hep3Vector&,
+                               BFieldQueryContext&,
+                               CLHEP::Hep3Vector&,
+                               double grad[3][3]) const;
+
         XYZVec getBField(const XYZVec& pos) const {
           // Default c'tor sets all components to zero - which is what we need here.
           CLHEP::Hep3Vector b;
@@ -71,7 +86,28 @@ namespace mu2e {
           return result;
         }
 
-        BFCacheManager cacheManager() const { return cm_; }
+        // Get the field at n points.  The map is selected once for each run of
+        // consecutive points that fall in the same map, and the map evaluates the
+        // whole run in one call.  Points outside of all maps get a zero field.
+        // status may be null; if not, it receives one entry per point.
+        void getBFieldBatch(CLHEP::Hep3Vector const* points,
+                            std::size_t n,
+                            CLHEP::Hep3Vector* fields,
+                            bool* status = nullptr) const {
+            BFieldQueryContext ctx;
+            getBFieldBatch(points, n, ctx, fields, status);
+        }
+        void getBFieldBatch(CLHEP::Hep3Vector const* points,
+                            std::size_t n,
+                            BFieldQueryContext& ctx,
+                            CLHEP::Hep3Vector* fields,
+                            bool* status = nullptr) const;
+
+        void getBFieldBatch(std::vector<CLHEP::Hep3Vector> const& points,
+                            std::vector<CLHEP::Hep3Vector>& fields) const {
+            fields.resize(points.size());
+            getBFieldBatch(points.data(), points.size(), fields.data());
+        }
 
         const MapContainerType& getInnerMaps() const { return innerMaps_; }
         MapContainerType& getInnerMaps() { return innerMaps_; }
@@ -126,7 +162,8 @@ namespace mu2e {
                                                   BFMapType::enum_type type,
                                                   double scaleFactor);
 
-        // Handles caching and overlap resolution logic
+        // Handles caching and overlap resolution logic.  Not modified by queries, so that
+        // one instance serves all threads; the per-thread state is in BFieldQueryContext.
         BFCacheManager cm_;
 
     };  // end class BFieldManager
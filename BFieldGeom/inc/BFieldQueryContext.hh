@@ -0,0 +1,63 @@
+#ifndef BFieldGeom_BFieldQueryContext_hh
+#define BFieldGeom_BFieldQueryContext_hh
+//
+// State carried from one magnetic field query to the next: which map served the
+// last point and, for trilinear grid maps, the field at the corners of the last
+// grid cell.  Queries that stay in the same cell are served from the corner values
+// without touching the map.
+//
+// The maps and the BFieldManager are shared by all threads and never modified by
+// a query; all of the mutable state lives here.  A context must therefore only be
+// used by one thread at a time.  Give each thread, or each object that is only
+// used on one thread, such as a G4MagneticField or a track fitter, its own.
+//
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mu2e {
+
+    class BFieldQueryContext {
+       public:
+        BFieldQueryContext()
+            : _managerId(0),
+              _lastInner(-1),
+              _lastOuter(-1),
+              _cellMapId(0),
+              _cellBase(0),
+              _cellHits(0),
+              _cellMisses(0) {}
+
+        // Forget all cached state.
+        void reset() { *this = BFieldQueryContext(); }
+
+        // Number of queries served from, or which had to reload, the cell cache.
+        unsigned long cellHits() const { return _cellHits; }
+        unsigned long cellMisses() const { return _cellMisses; }
+
+       private:
+        friend class BFCacheManager;
+        friend class BFGridMap;
+
+        // Map selection, see BFCacheManager::findMap.  The indices refer to the maps
+        // of the BFCacheManager with id _managerId and are ignored for any other one.
+        std::uint64_t _managerId;
+        int _lastInner;  // inner map of the last point, or -1
+        int _lastOuter;  // outer map of the last point outside all inner maps
+
+        // Trilinear cell cache, see BFGridMap::getBFieldCached.  The cell is identified
+        // by the id of the map and the flat index of its lowest corner.  The field in
+        // the cell is stored, unscaled, as the coefficients of
+        // b = c0 + c1*tx + c2*ty + c3*tx*ty + tz*(c4 + c5*tx + c6*ty + c7*tx*ty)
+        // for each component, where tx, ty, tz are the fractional cell coordinates.
+        std::uint64_t _cellMapId;
+        std::size_t _cellBase;
+        double _cellCoef[3][8];
+
+        unsigned long _cellHits;
+        unsigned long _cellMisses;
+    };
+
+}  // namespace mu2e
+
+#endif /* BFieldGeom_BFieldQueryContext_hh */
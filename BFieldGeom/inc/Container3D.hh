@@ -205,6 +205,14 @@ namespace mu2e {
       }
     }
 
+    // Recover the memory.
+    void cleart(){
+      _nx = 0;
+      _ny = 0;
+      _nz = 0;
+      std::vector<bool>().swap(_vec);
+    }
+
   private:
 
     // Dimensions of the grid.
@@ -1,50 +1,48 @@
 // Andrei Gaponenko, 2012
 
+#include <atomic>
+
 #include "Offline/BFieldGeom/inc/BFCacheManager.hh"
 
 namespace mu2e {
 
-    BFCacheManager::BFCacheManager():
-    innerForLastInner(0),
-    innerForLastOuter(0),
-    counter(0)
-    {
-        outerCache.insert( std::make_pair<std::shared_ptr<const BFMap>>(0, CacheElement(0, MapList())) );
-        CacheType::const_iterator p = outerCache.find(0);
-        assert(p != outerCache.end());
-        innerForLastOuter = &p->second;
-    }
+    namespace {
+        // Ids start at 1; a default constructed BFieldQueryContext has id 0.
+        std::atomic<std::uint64_t> nextId(1);
+    }  // namespace
+
+    BFCacheManager::BFCacheManager() : outerCache(1), id(nextId++) {}
 
     void BFCacheManager::setMaps(const MapContainerType& innerMaps,
                                  const MapContainerType& outerMaps) {
-        typedef MapContainerType::const_iterator Iter;
-
-        // All inner maps in the input order
-        MapList defaultInnerList;
-        for (Iter i = innerMaps.begin(); i != innerMaps.end(); ++i) {
-            defaultInnerList.push_back(*i);
+        inner.clear();
+        outer.clear();
+        for (auto const& m : innerMaps) {
+            inner.push_back(m.get());
         }
-
-        // The fixed-order outer map list
-        for (Iter i = outerMaps.begin(); i != outerMaps.end(); ++i) {
-            this->outer.push_back(*i);
+        for (auto const& m : outerMaps) {
+            outer.push_back(m.get());
         }
 
-        // Now populate the cache lookup structures
-
-        for (Iter i = innerMaps.begin(); i != innerMaps.end(); ++i) {
-            // or can assign a dedicated innerList for this map, e.g. using hints from FHICL
-            innerCache.insert(std::make_pair(*i, CacheElement(*i, defaultInnerList)));
+        // Now populate the cache lookup structures.
+        // Or can assign a dedicated inner list for each map, e.g. using hints from FHICL.
+        innerCache.assign(inner.size(), CacheElement());
+        for (std::size_t i = 0; i < inner.size(); ++i) {
+            for (std::size_t j = 0; j < inner.size(); ++j) {
+                if (j != i) {
+                    innerCache[i].inner.push_back(j);
+                }
+            }
         }
 
-        for (Iter i = outerMaps.begin(); i != outerMaps.end(); ++i) {
-            // or can assign a dedicated innerList for this map, e.g. using hints from FHICL
-            outerCache.insert(std::make_pair(*i, CacheElement(*i, defaultInnerList)));
+        // All inner maps in the input order
+        CacheElement defaultElement;
+        for (std::size_t j = 0; j < inner.size(); ++j) {
+            defaultElement.inner.push_back(j);
         }
+        outerCache.assign(outer.size() + 1, defaultElement);
 
-        CacheType::iterator p = outerCache.find(0);
-        assert(p != outerCache.end());
-        p->second = CacheElement(0, defaultInnerList);
-        innerForLastOuter = &p->second;
+        // Contexts filled for the previous maps must not be used with the new ones.
+        id = nextId++;
     }
 }  // namespace mu2e
@@ -0,0 +1,187 @@
+//
+// Piecewise Chebyshev approximation of a vector field on a box.
+//
+
+// C++ includes
+#include <algorithm>
+#include <cmath>
+
+// Framework includes
+#include "cetlib_except/exception.h"
+
+// Mu2e includes
+#include "Offline/BFieldGeom/inc/BFChebyshevGrid.hh"
+
+namespace mu2e {
+
+    namespace {
+
+        // Chebyshev polynomials T_0 .. T_degree at t.
+        inline void chebyshev(double t, unsigned degree, double T[]) {
+            T[0] = 1.;
+            if (degree > 0)
+                T[1] = t;
+            for (unsigned k = 2; k <= degree; ++k) {
+                T[k] = 2. * t * T[k - 1] - T[k - 2];
+            }
+        }
+
+        // Cell index and local coordinate in [-1,1] along one dimension.
+        inline unsigned locate(double x, double xmin, double cell, unsigned ncell, double& t) {
+            int i = std::floor((x - xmin) / cell);
+            i = std::min(std::max(i, 0), int(ncell) - 1);
+            t = 2. * (x - xmin - i * cell) / cell - 1.;
+            return i;
+        }
+    }  // namespace
+
+    void BFChebyshevGrid::fit(double xmin,
+                              double xmax,
+                              double ymin,
+                              double ymax,
+                              double zmin,
+                              double zmax,
+                              unsigned ncx,
+                              unsigned ncy,
+                              unsigned ncz,
+                              unsigned degree,
+                              ColumnSampler const& sampler) {
+        if (degree > maxDegree || ncx == 0 || ncy == 0 || ncz == 0) {
+            throw cet::exception("GEOM")
+                << "BFChebyshevGrid: bad configuration, degree " << degree << " cells " << ncx
+                << " " << ncy << " " << ncz << "\n";
+        }
+
+        _degree = degree;
+        _ncx = ncx;
+        _ncy = ncy;
+        _ncz = ncz;
+        _xmin = xmin;
+        _ymin = ymin;
+        _zmin = zmin;
+        _cx = (xmax - xmin) / ncx;
+        _cy = (ymax - ymin) / ncy;
+        _cz = (zmax - zmin) / ncz;
+
+        const unsigned N = degree + 1;
+        const std::size_t N3 = std::size_t(N) * N * N;
+        _coef.assign(std::size_t(ncells()) * 3 * N3, 0.);
+
+        // Chebyshev-Gauss nodes in [-1,1] and the matrix of the discrete cosine transform
+        // that turns values at the nodes into coefficients.
+        std::vector<double> node(N), dct(N * N);
+        for (unsigned j = 0; j < N; ++j) {
+            node[j] = std::cos(M_PI * (j + 0.5) / N);
+        }
+        for (unsigned a = 0; a < N; ++a) {
+            for (unsigned j = 0; j < N; ++j) {
+                dct[a * N + j] = (a == 0 ? 1. : 2.) / N * std::cos(M_PI * a * (j + 0.5) / N);
+            }
+        }
+
+        // All z nodes, cell by cell, so that each (x,y) column is sampled once.
+        std::vector<double> zs(std::size_t(ncz) * N);
+        for (unsigned kz = 0; kz < ncz; ++kz) {
+            for (unsigned l = 0; l < N; ++l) {
+                zs[kz * N + l] = zmin + (kz + 0.5 * (node[l] + 1.)) * _cz;
+            }
+        }
+        std::vector<double> cbx(zs.size()), cby(zs.size()), cbz(zs.size());
+
+        // Field values at the nodes for one (x,y) cell: [comp][kz][j][k][l].
+        std::vector<double> values(3 * zs.size() * N * N);
+        std::vector<double> tmp1(N3), tmp2(N3);
+
+        for (unsigned kx = 0; kx < ncx; ++kx) {
+            for (unsigned ky = 0; ky < ncy; ++ky) {
+                for (unsigned j = 0; j < N; ++j) {
+                    const double x = xmin + (kx + 0.5 * (node[j] + 1.)) * _cx;
+                    for (unsigned k = 0; k < N; ++k) {
+                        const double y = ymin + (ky + 0.5 * (node[k] + 1.)) * _cy;
+                        sampler(x, y, zs.size(), zs.data(), cbx.data(), cby.data(), cbz.data());
+                        double const* col[3] = {cbx.data(), cby.data(), cbz.data()};
+                        for (unsigned c = 0; c < 3; ++c) {
+                            for (unsigned kz = 0; kz < ncz; ++kz) {
+                                for (unsigned l = 0; l < N; ++l) {
+                                    values[((std::size_t(c) * ncz + kz) * N3) + (j * N + k) * N + l] =
+                                        col[c][kz * N + l];
+                                }
+                            }
+                        }
+                    }
+                }
+
+                // Transform along z, then y, then x.
+                for (unsigned kz = 0; kz < ncz; ++kz) {
+                    const std::size_t cell = (std::size_t(kx) * ncy + ky) * ncz + kz;
+                    for (unsigned c = 0; c < 3; ++c) {
+                        double const* f = &values[(std::size_t(c) * ncz + kz) * N3];
+                        for (unsigned j = 0; j < N; ++j)
+                            for (unsigned k = 0; k < N; ++k)
+                                for (unsigned cc = 0; cc < N; ++cc) {
+                                    double s(0.);
+                                    for (unsigned l = 0; l < N; ++l)
+                                        s += dct[cc * N + l] * f[(j * N + k) * N + l];
+                                    tmp1[(j * N + k) * N + cc] = s;
+                                }
+                        for (unsigned j = 0; j < N; ++j)
+                            for (unsigned b = 0; b < N; ++b)
+                                for (unsigned cc = 0; cc < N; ++cc) {
+                                    double s(0.);
+                                    for (unsigned k = 0; k < N; ++k)
+                                        s += dct[b * N + k] * tmp1[(j * N + k) * N + cc];
+                                    tmp2[(j * N + b) * N + cc] = s;
+                                }
+                        double* out = &_coef[(cell * 3 + c) * N3];
+                        for (unsigned a = 0; a < N; ++a)
+                            for (unsigned b = 0; b < N; ++b)
+                                for (unsigned cc = 0; cc < N; ++cc) {
+                                    double s(0.);
+                                    for (unsigned j = 0; j < N; ++j)
+                                        s += dct[a * N + j] * tmp2[(j * N + b) * N + cc];
+                                    out[(a * N + b) * N + cc] = s;
+                                }
+                    }
+                }
+            }
+        }
+    }
+
+    void BFChebyshevGrid::evaluate(
+        double x, double y, double z, double& bx, double& by, double& bz) const {
+        double tx, ty, tz;
+        const unsigned ix = locate(x, _xmin, _cx, _ncx, tx);
+        const unsigned iy = locate(y, _ymin, _cy, _ncy, ty);
+        const unsigned iz = locate(z, _zmin, _cz, _ncz, tz);
+
+        double Tx[maxDegree + 1], Ty[maxDegree + 1], Tz[maxDegree + 1];
+        chebyshev(tx, _degree, Tx);
+        chebyshev(ty, _degree, Ty);
+        chebyshev(tz, _degree, Tz);
+
+        const unsigned N = _degree + 1;
+        const std::size_t N3 = std::size_t(N) * N * N;
+        const std::size_t cell = (std::size_t(ix) * _ncy + iy) * _ncz + iz;
+        double const* cx = &_coef[cell * 3 * N3];
+        double const* cy = cx + N3;
+        double const* cz = cy + N3;
+
+        bx = by = bz = 0.;
+        for (unsigned a = 0; a < N; ++a) {
+            for (unsigned b = 0; b < N; ++b) {
+                const double wab = Tx[a] * Ty[b];
+                const std::size_t row = (a * N + b) * N;
+                double sx(0.), sy(0.), sz(0.);
+                for (unsigned c = 0; c < N; ++c) {
+                    sx += Tz[c] * cx[row + c];
+                    sy += Tz[c] * cy[row + c];
+                    sz += Tz[c] * cz[row + c];
+                }
+                bx += wab * sx;
+                by += wab * sy;
+                bz += wab * sz;
+            }
+        }
+    }
+
+}  // namespace mu2e
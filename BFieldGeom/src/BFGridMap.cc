@@ -9,6 +9,9 @@
 // methods.
 
 // C++ includes
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 
@@ -28,6 +31,50 @@ using namespace std;
 
 namespace mu2e {
 
+    namespace {
+
+        // Number of points processed together by the batch kernel.
+        constexpr std::size_t batchChunk = 64;
+
+        // Weighted sum of the eight corners of the cell whose lowest corner is c0.
+        // The weights are ordered as (x,y,z) = 000, 100, 010, 110, 001, 101, 011, 111.
+        inline double blend8(float const* b,
+                             std::size_t c0,
+                             std::size_t sx,
+                             std::size_t sy,
+                             double const w[8]) {
+            return w[0] * b[c0] + w[1] * b[c0 + sx] + w[2] * b[c0 + sy] + w[3] * b[c0 + sx + sy] +
+                   w[4] * b[c0 + 1] + w[5] * b[c0 + sx + 1] + w[6] * b[c0 + sy + 1] +
+                   w[7] * b[c0 + sx + sy + 1];
+        }
+
+        inline void trilinearWeights(double tx, double ty, double tz, double w[8]) {
+            const double ux(1. - tx), uy(1. - ty), uz(1. - tz);
+            w[0] = ux * uy * uz;
+            w[1] = tx * uy * uz;
+            w[2] = ux * ty * uz;
+            w[3] = tx * ty * uz;
+            w[4] = ux * uy * tz;
+            w[5] = tx * uy * tz;
+            w[6] = ux * ty * tz;
+            w[7] = tx * ty * tz;
+        }
+
+        // Lagrange weights for nodes at 0, 1, 2; the same polynomial as gmcpoly2.
+        inline void lagrange3(double t, double w[3]) {
+            w[0] = 0.5 * (t - 1.) * (t - 2.);
+            w[1] = -t * (t - 2.);
+            w[2] = 0.5 * t * (t - 1.);
+        }
+
+        // Their derivatives with respect to t.
+        inline void dlagrange3(double t, double w[3]) {
+            w[0] = t - 1.5;
+            w[1] = 2. - 2. * t;
+            w[2] = t - 0.5;
+        }
+    }  // namespace
+
     // function to determine if the point is in the map; take into account Y-symmetry
     bool BFGridMap::isValid(CLHEP::Hep3Vector const& point) const {
         if (point.x() < _xmin || point.x() > _xmax) {
@@ -153,21 +200,258 @@ namespace mu2e {
 
     bool BFGridMap::getBFieldWithStatus(const CLHEP::Hep3Vector& testpoint,
                                         CLHEP::Hep3Vector& result) const {
-        bool retval(false);
+        bool retval = interpolatePoint(testpoint, result);
+        result *= _scaleFactor;
+        return retval;
+    }
 
-        if (_interpStyle == BFInterpolationStyle::trilinear) {
-            retval = interpolateTriLinear(testpoint, result);
+    std::uint64_t BFGridMap::newCacheId() {
+        // Ids start at 1; a default constructed BFieldQueryContext has id 0.
+        static std::atomic<std::uint64_t> nextId(1);
+        return nextId++;
+    }
+
+    // Same cell and weights as packedTriLinear.  On a cache miss the eight corners are
+    // loaded into the context; every query in the cell then costs 7 FMAs per component.
+    bool BFGridMap::loadCell(const CLHEP::Hep3Vector& p,
+                             BFieldQueryContext& ctx,
+                             double t[3]) const {
+        const double py = _flipy ? std::abs(p.y()) : p.y();
+        const double ux = (p.x() - _xmin) / _dx;
+        const double uy = (py - _ymin) / _dy;
+        const double uz = (p.z() - _zmin) / _dz;
+        int i = floor(ux);
+        int j = floor(uy);
+        int k = floor(uz);
+
+        if (i < 0 || i >= int(_nx) || j < 0 || j >= int(_ny) || k < 0 || k >= int(_nz)) {
+            if (_warnIfOutside) {
+                mf::LogWarning("GEOM")
+                    << "Point is outside of the valid region of the map: " << _key << "\n"
+                    << "Point in input coordinates: " << p << "\n";
+            }
+            return false;
+        }
+
+        // A point on the upper face of the map belongs to the last cell.
+        i = std::min(i, int(_nx) - 2);
+        j = std::min(j, int(_ny) - 2);
+        k = std::min(k, int(_nz) - 2);
+
+        const std::size_t c0 = flatIndex(i, j, k);
+        if (ctx._cellMapId != _cacheId || ctx._cellBase != c0) {
+            ++ctx._cellMisses;
+            ctx._cellMapId = _cacheId;
+            ctx._cellBase = c0;
+            float const* packed[3] = {_bxp, _byp, _bzp};
+            for (int c = 0; c < 3; ++c) {
+                // Corners ordered as in trilinearWeights.
+                double v[8];
+                for (int l = 0; l < 8; ++l) {
+                    const int di(l & 1), dj((l >> 1) & 1), dk(l >> 2);
+                    v[l] = _packed ? packed[c][flatIndex(i + di, j + dj, k + dk)]
+                                   : _field(i + di, j + dj, k + dk)[c];
+                }
+                double* a = ctx._cellCoef[c];
+                a[0] = v[0];
+                a[1] = v[1] - v[0];
+                a[2] = v[2] - v[0];
+                a[3] = v[3] - v[2] - v[1] + v[0];
+                a[4] = v[4] - v[0];
+                a[5] = v[5] - v[4] - v[1] + v[0];
+                a[6] = v[6] - v[4] - v[2] + v[0];
+                a[7] = v[7] - v[6] - v[5] + v[4] - v[3] + v[2] + v[1] - v[0];
+            }
+        } else {
+            ++ctx._cellHits;
+        }
+
+        t[0] = ux - i;
+        t[1] = uy - j;
+        t[2] = uz - k;
+        return true;
+    }
+
+    bool BFGridMap::getBFieldCached(const CLHEP::Hep3Vector& p,
+                                    BFieldQueryContext& ctx,
+                                    CLHEP::Hep3Vector& result) const {
+        if (_interpStyle != BFInterpolationStyle::trilinear) {
+            return getBFieldWithStatus(p, result);
+        }
+
+        double t[3];
+        if (!loadCell(p, ctx, t)) {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            return false;
+        }
+
+        const double tx(t[0]), ty(t[1]), tz(t[2]);
+        double b[3];
+        for (int c = 0; c < 3; ++c) {
+            double const* a = ctx._cellCoef[c];
+            const double lo = (a[0] + a[1] * tx) + (a[2] + a[3] * tx) * ty;
+            const double hi = (a[4] + a[5] * tx) + (a[6] + a[7] * tx) * ty;
+            b[c] = _scaleFactor * (lo + hi * tz);
+        }
+        if (_flipy && p.y() < 0.) {
+            b[1] = -b[1];
+        }
+        result = CLHEP::Hep3Vector(b[0], b[1], b[2]);
+        return true;
+    }
 
+    bool BFGridMap::getBFieldGradient(const CLHEP::Hep3Vector& p,
+                                      BFieldQueryContext& ctx,
+                                      CLHEP::Hep3Vector& result,
+                                      double grad[3][3]) const {
+        double b[3];
+        bool retval(false);
+        if (_interpStyle == BFInterpolationStyle::trilinear) {
+            double t[3];
+            retval = loadCell(p, ctx, t);
+            if (retval) {
+                const double tx(t[0]), ty(t[1]), tz(t[2]);
+                for (int c = 0; c < 3; ++c) {
+                    double const* a = ctx._cellCoef[c];
+                    const double lo = (a[0] + a[1] * tx) + (a[2] + a[3] * tx) * ty;
+                    const double hi = (a[4] + a[5] * tx) + (a[6] + a[7] * tx) * ty;
+                    b[c] = lo + hi * tz;
+                    grad[c][0] = ((a[1] + a[3] * ty) + (a[5] + a[7] * ty) * tz) / _dx;
+                    grad[c][1] = ((a[2] + a[3] * tx) + (a[6] + a[7] * tx) * tz) / _dy;
+                    grad[c][2] = hi / _dz;
+                }
+            }
         } else if (_interpStyle == BFInterpolationStyle::meco) {
-            retval = interpolateQuadratic(testpoint, result);
+            retval = quadraticGradient(p, b, grad);
+            if (!retval && _warnIfOutside) {
+                mf::LogWarning("GEOM")
+                    << "Point is outside of the valid region of the map: " << _key << "\n"
+                    << "Point in input coordinates: " << p << "\n";
+            }
+        } else {
+            return BFMap::getBFieldGradient(p, ctx, result, grad);
+        }
+
+        if (!retval) {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+            for (int i = 0; i < 3; ++i) {
+                grad[i][0] = grad[i][1] = grad[i][2] = 0.;
+            }
+            return false;
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            b[i] *= _scaleFactor;
+            for (int j = 0; j < 3; ++j) {
+                grad[i][j] *= _scaleFactor;
+            }
+        }
+        // The map holds y>0; below the plane By and d/dy change sign.
+        if (_flipy && p.y() < 0.) {
+            b[1] = -b[1];
+            for (int i = 0; i < 3; ++i) {
+                grad[1][i] = -grad[1][i];
+                grad[i][1] = -grad[i][1];
+            }
+        }
+        result = CLHEP::Hep3Vector(b[0], b[1], b[2]);
+        return true;
+    }
 
+    bool BFGridMap::interpolatePoint(const CLHEP::Hep3Vector& testpoint,
+                                     CLHEP::Hep3Vector& result) const {
+        if (!_packed) {
+            if (_interpStyle == BFInterpolationStyle::trilinear) {
+                return interpolateTriLinear(testpoint, result);
+            } else if (_interpStyle == BFInterpolationStyle::meco) {
+                return interpolateQuadratic(testpoint, result);
+            }
         } else {
-            throw cet::exception("GEOM")
-                << "Unrecognized option for interpolation into the BField: " << _interpStyle
-                << "\n";
+            double bx(0.), by(0.), bz(0.);
+            bool retval(false);
+            if (_interpStyle == BFInterpolationStyle::trilinear) {
+                retval = packedTriLinear(testpoint.x(), testpoint.y(), testpoint.z(), bx, by, bz);
+            } else if (_interpStyle == BFInterpolationStyle::meco) {
+                retval = packedQuadratic(testpoint.x(), testpoint.y(), testpoint.z(), bx, by, bz);
+            } else {
+                throw cet::exception("GEOM")
+                    << "Unrecognized option for interpolation into the BField: " << _interpStyle
+                    << "\n";
+            }
+            if (!retval && _warnIfOutside) {
+                mf::LogWarning("GEOM")
+                    << "Point is outside of the valid region of the map: " << _key << "\n"
+                    << "Point in input coordinates: " << testpoint << "\n";
+            }
+            result = CLHEP::Hep3Vector(bx, by, bz);
+            return retval;
+        }
+        throw cet::exception("GEOM") << "Unrecognized option for interpolation into the BField: "
+                                     << _interpStyle << "\n";
+    }
+
+    void BFGridMap::getBFieldBatch(std::size_t n,
+                                   double const* x,
+                                   double const* y,
+                                   double const* z,
+                                   double* bx,
+                                   double* by,
+                                   double* bz,
+                                   bool* status) const {
+        // Only the packed trilinear case has a dedicated batch kernel.
+        if (!_packed || _interpStyle != BFInterpolationStyle::trilinear) {
+            BFMap::getBFieldBatch(n, x, y, z, bx, by, bz, status);
+            return;
+        }
+
+        const std::size_t sx = std::size_t(_ny) * _nz;
+        const std::size_t sy = _nz;
+        const double nxm2(_nx - 2.), nym2(_ny - 2.), nzm2(_nz - 2.);
+        const double invdx(1. / _dx), invdy(1. / _dy), invdz(1. / _dz);
+
+        std::size_t base[batchChunk];
+        double tx[batchChunk], ty[batchChunk], tz[batchChunk];
+        bool inside[batchChunk];
+
+        for (std::size_t start = 0; start < n; start += batchChunk) {
+            const std::size_t m = std::min(batchChunk, n - start);
+
+            // Pass 1: cell indices and fractions.  There are no data dependent
+            // branches here so that the compiler can vectorize the loop.
+            for (std::size_t l = 0; l < m; ++l) {
+                const double py = _flipy ? std::abs(y[start + l]) : y[start + l];
+                const double ux = (x[start + l] - _xmin) * invdx;
+                const double uy = (py - _ymin) * invdy;
+                const double uz = (z[start + l] - _zmin) * invdz;
+                const double fi = std::floor(ux), fj = std::floor(uy), fk = std::floor(uz);
+                inside[l] = fi >= 0. && fi < _nx && fj >= 0. && fj < _ny && fk >= 0. && fk < _nz;
+
+                // A point on the upper face of the map belongs to the last cell.
+                const double ci = std::min(std::max(fi, 0.), nxm2);
+                const double cj = std::min(std::max(fj, 0.), nym2);
+                const double ck = std::min(std::max(fk, 0.), nzm2);
+                tx[l] = ux - ci;
+                ty[l] = uy - cj;
+                tz[l] = uz - ck;
+                base[l] = std::size_t(ci) * sx + std::size_t(cj) * sy + std::size_t(ck);
+            }
+
+            // Pass 2: gather the corners of each cell and blend them.
+            for (std::size_t l = 0; l < m; ++l) {
+                const std::size_t i = start + l;
+                status[i] = inside[l];
+                if (!inside[l]) {
+                    bx[i] = by[i] = bz[i] = 0.;
+                    continue;
+                }
+                double w[8];
+                trilinearWeights(tx[l], ty[l], tz[l], w);
+                const double sign = (_flipy && y[i] < 0.) ? -1. : 1.;
+                bx[i] = _scaleFactor * blend8(_bxp, base[l], sx, sy, w);
+                by[i] = sign * _scaleFactor * blend8(_byp, base[l], sx, sy, w);
+                bz[i] = _scaleFactor * blend8(_bzp, base[l], sx, sy, w);
+            }
         }
-        result *= _scaleFactor;
-        return retval;
     }
 
     // The algorithm is:
@@ -379,6 +663,311 @@ namespace mu2e {
         return true;
     }
 
+    // Same algorithm as interpolateTriLinear, on the packed storage.
+    bool BFGridMap::packedTriLinear(
+        double px, double py, double pz, double& bx, double& by, double& bz) const {
+        const bool flip = _flipy && py < 0.;
+        if (_flipy)
+            py = std::abs(py);
+
+        const double ux = (px - _xmin) / _dx;
+        const double uy = (py - _ymin) / _dy;
+        const double uz = (pz - _zmin) / _dz;
+        int i = floor(ux);
+        int j = floor(uy);
+        int k = floor(uz);
+
+        if (i < 0 || i >= int(_nx) || j < 0 || j >= int(_ny) || k < 0 || k >= int(_nz)) {
+            bx = by = bz = 0.;
+            return false;
+        }
+
+        // A point on the upper face of the map belongs to the last cell.
+        i = std::min(i, int(_nx) - 2);
+        j = std::min(j, int(_ny) - 2);
+        k = std::min(k, int(_nz) - 2);
+
+        double w[8];
+        trilinearWeights(ux - i, uy - j, uz - k, w);
+
+        const std::size_t sx = std::size_t(_ny) * _nz;
+        const std::size_t sy = _nz;
+        const std::size_t c0 = flatIndex(i, j, k);
+        bx = blend8(_bxp, c0, sx, sy, w);
+        by = blend8(_byp, c0, sx, sy, w);
+        bz = blend8(_bzp, c0, sx, sy, w);
+        if (flip)
+            by = -by;
+        return true;
+    }
+
+    // Same algorithm as interpolateQuadratic, on the packed storage.  The three
+    // one-dimensional Lagrange interpolations are folded into one 27 point sum.
+    bool BFGridMap::packedQuadratic(
+        double px, double py, double pz, double& bx, double& by, double& bz) const {
+        bx = by = bz = 0.;
+
+        const bool flip = _flipy && py < 0.;
+        if (_flipy)
+            py = std::abs(py);
+
+        if (!isValid(CLHEP::Hep3Vector(px, py, pz))) {
+            return false;
+        }
+
+        // Indices of the nearest grid point, moved just inside the edges.
+        unsigned int ix = static_cast<int>((px - _xmin) / _dx + 0.5);
+        unsigned int iy = static_cast<int>((py - _ymin) / _dy + 0.5);
+        unsigned int iz = static_cast<int>((pz - _zmin) / _dz + 0.5);
+        ix = std::min(std::max(ix, 1u), _nx - 2);
+        iy = std::min(std::max(iy, 1u), _ny - 2);
+        iz = std::min(std::max(iz, 1u), _nz - 2);
+
+        const std::size_t sx = std::size_t(_ny) * _nz;
+        const std::size_t sy = _nz;
+        const std::size_t c0 = flatIndex(ix - 1, iy - 1, iz - 1);
+
+        if (!_allDefined) {
+            for (int a = 0; a != 3; ++a) {
+                for (int b = 0; b != 3; ++b) {
+                    for (int c = 0; c != 3; ++c) {
+                        if (!isDefinedPacked(c0 + a * sx + b * sy + c))
+                            return false;
+                    }
+                }
+            }
+        }
+
+        double wx[3], wy[3], wz[3];
+        lagrange3((px - _xmin) / _dx - (ix - 1.), wx);
+        lagrange3((py - _ymin) / _dy - (iy - 1.), wy);
+        lagrange3((pz - _zmin) / _dz - (iz - 1.), wz);
+
+        for (int a = 0; a != 3; ++a) {
+            for (int b = 0; b != 3; ++b) {
+                const double wab = wx[a] * wy[b];
+                const std::size_t row = c0 + a * sx + b * sy;
+                for (int c = 0; c != 3; ++c) {
+                    const double w = wab * wz[c];
+                    bx += w * _bxp[row + c];
+                    by += w * _byp[row + c];
+                    bz += w * _bzp[row + c];
+                }
+            }
+        }
+
+        if (flip)
+            by = -by;
+        return true;
+    }
+
+    // Same stencil as packedQuadratic, from either storage, with the derivatives of
+    // the Lagrange weights giving the gradient.
+    bool BFGridMap::quadraticGradient(const CLHEP::Hep3Vector& p,
+                                      double b[3],
+                                      double grad[3][3]) const {
+        const double px(p.x()), pz(p.z());
+        const double py = _flipy ? std::abs(p.y()) : p.y();
+        if (!isValid(CLHEP::Hep3Vector(px, py, pz))) {
+            return false;
+        }
+
+        unsigned int ix = static_cast<int>((px - _xmin) / _dx + 0.5);
+        unsigned int iy = static_cast<int>((py - _ymin) / _dy + 0.5);
+        unsigned int iz = static_cast<int>((pz - _zmin) / _dz + 0.5);
+        ix = std::min(std::max(ix, 1u), _nx - 2);
+        iy = std::min(std::max(iy, 1u), _ny - 2);
+        iz = std::min(std::max(iz, 1u), _nz - 2);
+
+        double t[3] = {(px - _xmin) / _dx - (ix - 1.), (py - _ymin) / _dy - (iy - 1.),
+                       (pz - _zmin) / _dz - (iz - 1.)};
+        double w[3][3], dw[3][3];
+        for (int d = 0; d < 3; ++d) {
+            lagrange3(t[d], w[d]);
+            dlagrange3(t[d], dw[d]);
+        }
+
+        for (int c = 0; c < 3; ++c) {
+            b[c] = grad[c][0] = grad[c][1] = grad[c][2] = 0.;
+        }
+        for (int a = 0; a != 3; ++a) {
+            for (int e = 0; e != 3; ++e) {
+                for (int f = 0; f != 3; ++f) {
+                    if (!_allDefined && !isDefined(ix - 1 + a, iy - 1 + e, iz - 1 + f)) {
+                        return false;
+                    }
+                    const CLHEP::Hep3Vector v = gridValue(ix - 1 + a, iy - 1 + e, iz - 1 + f);
+                    const double wv = w[0][a] * w[1][e] * w[2][f];
+                    const double wx = dw[0][a] * w[1][e] * w[2][f];
+                    const double wy = w[0][a] * dw[1][e] * w[2][f];
+                    const double wz = w[0][a] * w[1][e] * dw[2][f];
+                    for (int c = 0; c < 3; ++c) {
+                        b[c] += wv * v[c];
+                        grad[c][0] += wx * v[c];
+                        grad[c][1] += wy * v[c];
+                        grad[c][2] += wz * v[c];
+                    }
+                }
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            grad[c][0] /= _dx;
+            grad[c][1] /= _dy;
+            grad[c][2] /= _dz;
+        }
+        return true;
+    }
+
+    bool BFGridMap::fillFloatArrays(std::vector<float>& bx,
+                                    std::vector<float>& by,
+                                    std::vector<float>& bz,
+                                    std::vector<std::uint64_t>& defined) const {
+        const std::size_t npoints = std::size_t(_nx) * _ny * _nz;
+        bx.resize(npoints);
+        by.resize(npoints);
+        bz.resize(npoints);
+        defined.assign((npoints + 63) / 64, 0);
+
+        bool allDefined(true);
+        for (unsigned ix = 0; ix < _nx; ++ix) {
+            for (unsigned iy = 0; iy < _ny; ++iy) {
+                for (unsigned iz = 0; iz < _nz; ++iz) {
+                    const std::size_t i = flatIndex(ix, iy, iz);
+                    CLHEP::Hep3Vector const& b = _field(ix, iy, iz);
+                    bx[i] = b.x();
+                    by[i] = b.y();
+                    bz[i] = b.z();
+                    if (_isDefined(ix, iy, iz)) {
+                        defined[i >> 6] |= std::uint64_t(1) << (i & 63);
+                    } else {
+                        allDefined = false;
+                    }
+                }
+            }
+        }
+        if (allDefined) {
+            std::vector<std::uint64_t>().swap(defined);
+        }
+        return allDefined;
+    }
+
+    double BFGridMap::packToFloat(int nValidationPoints) {
+        if (_packed) {
+            return 0.;
+        }
+
+        _allDefined = fillFloatArrays(_bxf, _byf, _bzf, _definedBits);
+        _bxp = _bxf.data();
+        _byp = _byf.data();
+        _bzp = _bzf.data();
+        _definedp = _definedBits.data();
+
+        // Compare the two representations at points spread over the map.  The
+        // points come from an additive recurrence, which covers the box evenly.
+        double maxDiff(0.);
+        int nMismatch(0);
+        const bool known = _interpStyle == BFInterpolationStyle::trilinear ||
+                           _interpStyle == BFInterpolationStyle::meco;
+        for (int n = 0; known && n < nValidationPoints; ++n) {
+            const double u = std::fmod(0.5 + 0.8191725133961645 * (n + 1), 1.);
+            const double v = std::fmod(0.5 + 0.6710436067037893 * (n + 1), 1.);
+            const double t = std::fmod(0.5 + 0.5497004779019703 * (n + 1), 1.);
+            double py = _ymin + v * (_ymax - _ymin);
+            if (_flipy && n % 2)
+                py = -py;
+            const CLHEP::Hep3Vector p(_xmin + u * (_xmax - _xmin), py, _zmin + t * (_zmax - _zmin));
+
+            CLHEP::Hep3Vector bd;
+            double bx, by, bz;
+            bool okd, okf;
+            if (_interpStyle == BFInterpolationStyle::trilinear) {
+                okd = interpolateTriLinear(p, bd);
+                okf = packedTriLinear(p.x(), p.y(), p.z(), bx, by, bz);
+            } else {
+                okd = interpolateQuadratic(p, bd);
+                okf = packedQuadratic(p.x(), p.y(), p.z(), bx, by, bz);
+            }
+            if (okd != okf) {
+                ++nMismatch;
+            } else if (okd) {
+                maxDiff = std::max(maxDiff, (bd - CLHEP::Hep3Vector(bx, by, bz)).mag());
+            }
+        }
+        maxDiff *= std::abs(_scaleFactor);
+
+        _field.cleart();
+        _isDefined.cleart();
+        _packed = true;
+        _cacheId = newCacheId();
+
+        if (nValidationPoints > 0) {
+            mf::LogInfo("GEOM") << "BFGridMap " << _key << " packed to single precision. Checked "
+                                << nValidationPoints << " points, max |dB| = " << maxDiff
+                                << " T, status mismatches " << nMismatch << "\n";
+        }
+        return maxDiff;
+    }
+
+    void BFGridMap::attachMappedFile(std::shared_ptr<const BFMapFile> file) {
+        BFMapFileHeader const& h = file->header();
+        if (h.nx != _nx || h.ny != _ny || h.nz != _nz) {
+            throw cet::exception("GEOM")
+                << "BFGridMap::attachMappedFile: the grid of " << file->filename()
+                << " does not match the map " << _key << "\n";
+        }
+        _mappedFile = file;
+        _bxp = file->bx();
+        _byp = file->by();
+        _bzp = file->bz();
+        _definedp = file->definedBits();
+        _allDefined = (_definedp == nullptr);
+        _flipy = h.flags & BFMapFile::flipY;
+
+        std::vector<float>().swap(_bxf);
+        std::vector<float>().swap(_byf);
+        std::vector<float>().swap(_bzf);
+        std::vector<std::uint64_t>().swap(_definedBits);
+        _field.cleart();
+        _isDefined.cleart();
+        _packed = true;
+        _cacheId = newCacheId();
+    }
+
+    void BFGridMap::writeMappedFile(std::string const& filename) const {
+        BFMapFileHeader h{};
+        h.nx = _nx;
+        h.ny = _ny;
+        h.nz = _nz;
+        h.flags = _flipy ? BFMapFile::flipY : 0;
+        h.xmin = _xmin;
+        h.ymin = _ymin;
+        h.zmin = _zmin;
+        h.dx = _dx;
+        h.dy = _dy;
+        h.dz = _dz;
+
+        if (_packed) {
+            BFMapFile::write(filename, h, _bxp, _byp, _bzp, _allDefined ? nullptr : _definedp);
+        } else {
+            std::vector<float> bx, by, bz;
+            std::vector<std::uint64_t> defined;
+            bool allDefined = fillFloatArrays(bx, by, bz, defined);
+            BFMapFile::write(filename, h, bx.data(), by.data(), bz.data(),
+                             allDefined ? nullptr : defined.data());
+        }
+    }
+
+    std::size_t BFGridMap::memoryUsage() const {
+        if (_packed) {
+            // For a mapped file these pages are shared with other processes.
+            const std::size_t npoints = std::size_t(_nx) * _ny * _nz;
+            return 3 * npoints * sizeof(float) +
+                   (_allDefined ? 0 : (npoints + 63) / 64 * sizeof(std::uint64_t));
+        }
+        const std::size_t npoints = std::size_t(_nx) * _ny * _nz;
+        return npoints * sizeof(CLHEP::Hep3Vector) + npoints / 8;
+    }
+
     bool BFGridMap::getNeighborPointBF(const CLHEP::Hep3Vector& testpoint,
                                        CLHEP::Hep3Vector neighborPoints[3],
                                        CLHEP::Hep3Vector neighborBF[3][3][3]) const {
@@ -428,7 +1017,7 @@ namespace mu2e {
 
         // check if the point had a field defined
 
-        if (!_isDefined(ix, iy, iz)) {
+        if (!isDefined(ix, iy, iz)) {
             if (_warnIfOutside) {
                 mf::LogWarning("GEOM")
                     << "Point's field is not defined in the map: " << _key << "\n"
@@ -446,7 +1035,7 @@ namespace mu2e {
                 unsigned int yindex = iy + j - 1;
                 for (int k = 0; k != 3; ++k) {
                     unsigned int zindex = iz + k - 1;
-                    if (!_isDefined(xindex, yindex, zindex)) {
+                    if (!isDefined(xindex, yindex, zindex)) {
                         if (_warnIfOutside) {
                             mf::LogWarning("GEOM")
                                 << "Point's neighboring field is not defined in the map: " << _key
@@ -457,7 +1046,7 @@ namespace mu2e {
                         }
                         return false;
                     }
-                    neighborBF[i][j][k] = _field(xindex, yindex, zindex);
+                    neighborBF[i][j][k] = gridValue(xindex, yindex, zindex);
                     // Reassign y sign
                     if (_flipy && sign == -1) {
                         neighborBF[i][j][k].setY(-neighborBF[i][j][k].y());
@@ -487,11 +1076,11 @@ namespace mu2e {
              << endl;
         cout << "Distance:       " << _dx << " " << _dy << " " << _dz << endl;
 
-        cout << "Field at the edges: " << _field(0, 0, 0) << ", " << _field(_nx - 1, 0, 0) << ", "
-             << _field(0, _ny - 1, 0) << ", " << _field(0, 0, _nz - 1) << ", "
-             << _field(_nx - 1, _ny - 1, 0) << ", " << _field(_nx - 1, _ny - 1, _nz - 1) << endl;
+        cout << "Field at the edges: " << gridValue(0, 0, 0) << ", " << gridValue(_nx - 1, 0, 0) << ", "
+             << gridValue(0, _ny - 1, 0) << ", " << gridValue(0, 0, _nz - 1) << ", "
+             << gridValue(_nx - 1, _ny - 1, 0) << ", " << gridValue(_nx - 1, _ny - 1, _nz - 1) << endl;
 
-        cout << "Field in the middle: " << _field(_nx / 2, _ny / 2, _nz / 2) << endl;
+        cout << "Field in the middle: " << gridValue(_nx / 2, _ny / 2, _nz / 2) << endl;
 
         if (_warnIfOutside) {
             cout << "Will warn if outside of the valid region." << endl;
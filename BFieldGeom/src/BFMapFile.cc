@@ -0,0 +1,187 @@
+//
+// A pre-gridded, single precision magnetic field map file that is mapped
+// read-only into memory.
+//
+
+// C++ includes
+#include <cstring>
+#include <vector>
+
+// Includes from C ( needed for mmap and block IO ).
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// Framework includes
+#include "cetlib_except/exception.h"
+
+// Mu2e includes
+#include "Offline/BFieldGeom/inc/BFMapFile.hh"
+
+namespace mu2e {
+
+    namespace {
+
+        const char magicString[8] = {'M', 'U', '2', 'E', 'B', 'F', 'M', 'P'};
+
+        // Arrays start on page boundaries.
+        constexpr std::uint64_t pageSize = 4096;
+
+        std::uint64_t roundUp(std::uint64_t n) { return (n + pageSize - 1) / pageSize * pageSize; }
+
+        // Write n bytes and then pad with zeros to the next page boundary.
+        void writePadded(int fd, void const* buf, std::size_t n, std::string const& filename) {
+            char const* p = static_cast<char const*>(buf);
+            std::size_t left = n;
+            while (left > 0) {
+                ssize_t s = ::write(fd, p, left);
+                if (s < 0) {
+                    int errsave = errno;
+                    throw cet::exception("GEOM")
+                        << "BFMapFile::write Error writing " << filename << "  errno: " << errsave
+                        << " " << strerror(errsave) << "\n";
+                }
+                p += s;
+                left -= s;
+            }
+            std::vector<char> pad(roundUp(n) - n, 0);
+            if (!pad.empty() && ::write(fd, pad.data(), pad.size()) != ssize_t(pad.size())) {
+                int errsave = errno;
+                throw cet::exception("GEOM") << "BFMapFile::write Error padding " << filename
+                                             << "  errno: " << errsave << " " << strerror(errsave)
+                                             << "\n";
+            }
+        }
+    }  // namespace
+
+    BFMapFile::BFMapFile(std::string const& filename)
+        : _filename(filename), _addr(nullptr), _size(0) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            int errsave = errno;
+            throw cet::exception("GEOM") << "BFMapFile: Error opening " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+
+        struct stat info;
+        if (fstat(fd, &info)) {
+            int errsave = errno;
+            close(fd);
+            throw cet::exception("GEOM") << "BFMapFile: Error doing fstat() on " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+        _size = info.st_size;
+        if (_size < sizeof(BFMapFileHeader)) {
+            close(fd);
+            throw cet::exception("GEOM")
+                << "BFMapFile: " << filename << " is too short to hold a header.\n";
+        }
+
+        // The mapping stays valid after the descriptor is closed.
+        _addr = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+        int errsave = errno;
+        close(fd);
+        if (_addr == MAP_FAILED) {
+            _addr = nullptr;
+            throw cet::exception("GEOM") << "BFMapFile: Error doing mmap() on " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+
+        // From here on, unmap before throwing.
+        BFMapFileHeader const& h = header();
+        std::string problem;
+        if (std::memcmp(h.magic, magicString, sizeof(magicString)) != 0) {
+            problem = "not a Mu2e field map file";
+        } else if (h.endian != endianMarker) {
+            problem = "endian mismatch; regenerate the file on this architecture";
+        } else if (h.version > currentVersion) {
+            problem = "written by a newer version of the code";
+        } else if (h.fileSize != _size) {
+            problem = "file size does not match the size recorded in the header";
+        } else {
+            const std::uint64_t nbytes = std::uint64_t(h.nx) * h.ny * h.nz * sizeof(float);
+            for (std::uint64_t off : {h.offsetBx, h.offsetBy, h.offsetBz}) {
+                if (off % pageSize != 0 || off + nbytes > _size) {
+                    problem = "field array lies outside of the file";
+                }
+            }
+            const std::uint64_t nwords = (std::uint64_t(h.nx) * h.ny * h.nz + 63) / 64;
+            if (h.offsetDefined != 0 &&
+                (h.offsetDefined % pageSize != 0 ||
+                 h.offsetDefined + nwords * sizeof(std::uint64_t) > _size)) {
+                problem = "definedness mask lies outside of the file";
+            }
+            if ((h.offsetDefined == 0) != bool(h.flags & allDefined)) {
+                problem = "definedness mask does not match the flags";
+            }
+        }
+        if (!problem.empty()) {
+            munmap(_addr, _size);
+            _addr = nullptr;
+            throw cet::exception("GEOM") << "BFMapFile: " << filename << ": " << problem << "\n";
+        }
+    }
+
+    BFMapFile::~BFMapFile() {
+        if (_addr) {
+            munmap(_addr, _size);
+        }
+    }
+
+    void BFMapFile::write(std::string const& filename,
+                          BFMapFileHeader header,
+                          float const* bx,
+                          float const* by,
+                          float const* bz,
+                          std::uint64_t const* definedBits) {
+        const std::uint64_t npoints = std::uint64_t(header.nx) * header.ny * header.nz;
+        const std::uint64_t nbytes = npoints * sizeof(float);
+        const std::uint64_t nmask = (npoints + 63) / 64 * sizeof(std::uint64_t);
+
+        std::memcpy(header.magic, magicString, sizeof(magicString));
+        header.endian = endianMarker;
+        header.version = currentVersion;
+        header.offsetBx = roundUp(sizeof(BFMapFileHeader));
+        header.offsetBy = header.offsetBx + roundUp(nbytes);
+        header.offsetBz = header.offsetBy + roundUp(nbytes);
+        if (definedBits) {
+            header.flags &= ~allDefined;
+            header.offsetDefined = header.offsetBz + roundUp(nbytes);
+            header.fileSize = header.offsetDefined + roundUp(nmask);
+        } else {
+            header.flags |= allDefined;
+            header.offsetDefined = 0;
+            header.fileSize = header.offsetBz + roundUp(nbytes);
+        }
+
+        mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+        int flags = O_CREAT | O_WRONLY | O_TRUNC | O_EXCL;
+        int fd = open(filename.c_str(), flags, mode);
+        if (fd < 0) {
+            int errsave = errno;
+            if (errsave == EEXIST) {
+                throw cet::exception("GEOM")
+                    << "BFMapFile::write Error opening " << filename << "  File already exists.\n";
+            }
+            throw cet::exception("GEOM") << "BFMapFile::write Error opening " << filename
+                                         << "  errno: " << errsave << " " << strerror(errsave)
+                                         << "\n";
+        }
+
+        writePadded(fd, &header, sizeof(header), filename);
+        writePadded(fd, bx, nbytes, filename);
+        writePadded(fd, by, nbytes, filename);
+        writePadded(fd, bz, nbytes, filename);
+        if (definedBits) {
+            writePadded(fd, definedBits, nmask, filename);
+        }
+        close(fd);
+    }
+
+}  // namespace mu2e
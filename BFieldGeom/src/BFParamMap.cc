@@ -7,6 +7,7 @@
 // Bernstein.
 
 // C++ includes
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 
@@ -44,7 +45,21 @@ namespace mu2e {
                                          CLHEP::Hep3Vector& result) const {
         bool retval(false);
 
-        retval = evalFit(testpoint, result);
+        if (_cheb.empty()) {
+            retval = evalFit(testpoint, result);
+        } else if (isValid(testpoint)) {
+            double bx, by, bz;
+            _cheb.evaluate(testpoint.x(), testpoint.y(), testpoint.z(), bx, by, bz);
+            result = CLHEP::Hep3Vector(bx, by, bz);
+            retval = true;
+        } else {
+            if (_warnIfOutside) {
+                mf::LogWarning("GEOM")
+                    << "Point is outside of the valid region of the map: " << _key << "\n"
+                    << "Point in input coordinates: " << testpoint << "\n";
+            }
+            result = CLHEP::Hep3Vector(0, 0, 0);
+        }
 
         /*
         } else {
@@ -76,7 +91,6 @@ namespace mu2e {
         double cos_nphi, cos_kmsz;
         double sin_nphi, sin_kmsz;
         double abp, abm;
-        vector<double> out(3, 0);
         phi = atan2(p.y(), p.x() + 3896);
         r = sqrt(pow(p.x() + 3896, 2) + pow(p.y(), 2));
         double abs_r = abs(r);
@@ -122,6 +136,113 @@ namespace mu2e {
         return true;
     }
 
+    void BFParamMap::sampleColumn(double x,
+                                  double y,
+                                  std::size_t nz,
+                                  double const* z,
+                                  double* bx,
+                                  double* by,
+                                  double* bz) const {
+        // Same series as evalFit.  Everything but the z dependence is computed once.
+        const double phi = atan2(y, x + 3896);
+        const double abs_r = sqrt(pow(x + 3896, 2) + pow(y, 2));
+        const double cp = cos(phi);
+        const double sp = sin(phi);
+
+        // Bessel terms pre-multiplied by everything that does not depend on z.
+        vector<double> cr(_ns * _ms), cz(_ns * _ms), cphi(_ns * _ms);
+        for (int n = 0; n < _ns; ++n) {
+            const double cos_nphi = cos(n * phi + _Ds[n]);
+            const double sin_nphi = -sin(n * phi + _Ds[n]);
+            for (int m = 0; m < _ms; ++m) {
+                const double tmp_rho = _kms[n][m] * abs_r;
+                const double iv = gsl_sf_bessel_In(n, tmp_rho);
+                const double ivp = (tmp_rho == 0)
+                                       ? 0.5 * (gsl_sf_bessel_In(n - 1, 0) + gsl_sf_bessel_In(n + 1, 0))
+                                       : (n / tmp_rho) * iv + gsl_sf_bessel_In(n + 1, tmp_rho);
+                cr[n * _ms + m] = cos_nphi * ivp * _kms[n][m];
+                cz[n * _ms + m] = cos_nphi * iv * _kms[n][m];
+                cphi[n * _ms + m] = (abs_r > 1e-10) ? n * sin_nphi * (1 / abs_r) * iv : 0.;
+            }
+        }
+
+        vector<double> cos_kmsz(_ms), sin_kmsz(_ms);
+        for (std::size_t i = 0; i < nz; ++i) {
+            // The wave numbers do not depend on n; see calcConstants.
+            for (int m = 0; m < _ms; ++m) {
+                cos_kmsz[m] = cos(_kms[0][m] * z[i]);
+                sin_kmsz[m] = sin(_kms[0][m] * z[i]);
+            }
+            double br(0.0), bphi(0.0), bzz(0.0);
+            for (int n = 0; n < _ns; ++n) {
+                for (int m = 0; m < _ms; ++m) {
+                    const double abp = _As[n][m] * cos_kmsz[m] + _Bs[n][m] * sin_kmsz[m];
+                    const double abm = -_As[n][m] * sin_kmsz[m] + _Bs[n][m] * cos_kmsz[m];
+                    br += cr[n * _ms + m] * abp;
+                    bzz += cz[n * _ms + m] * abm;
+                    bphi += cphi[n * _ms + m] * abp;
+                }
+            }
+            bx[i] = br * cp - bphi * sp;
+            by[i] = br * sp + bphi * cp;
+            bz[i] = bzz;
+        }
+    }
+
+    BFParamMap::CompileReport BFParamMap::compile(double tolerance,
+                                                  unsigned degree,
+                                                  int nValidationPoints,
+                                                  std::size_t maxBytes) {
+        _cheb = BFChebyshevGrid();
+
+        // Start from cells of about 400 mm and halve them until the tolerance is met.
+        const double startCell = 400.;
+        unsigned ncx = std::max(1., std::ceil((_xmax - _xmin) / startCell));
+        unsigned ncy = std::max(1., std::ceil((_ymax - _ymin) / startCell));
+        unsigned ncz = std::max(1., std::ceil((_zmax - _zmin) / startCell));
+        const std::size_t bytesPerCell = 3 * std::size_t(std::pow(degree + 1, 3)) * sizeof(double);
+
+        auto sampler = [this](double x, double y, std::size_t nz, double const* z, double* bx,
+                              double* by, double* bz) { sampleColumn(x, y, nz, z, bx, by, bz); };
+
+        CompileReport report;
+        report.degree = degree;
+        report.nPoints = nValidationPoints;
+        while (true) {
+            _cheb.fit(_xmin, _xmax, _ymin, _ymax, _zmin, _zmax, ncx, ncy, ncz, degree, sampler);
+            report.ncells = _cheb.ncells();
+            report.bytes = _cheb.memoryUsage();
+
+            // Compare with the series at points that cover the box evenly.
+            std::fill(report.maxDeviation, report.maxDeviation + 3, 0.);
+            report.maxDeviationMag = 0.;
+            for (int n = 0; n < nValidationPoints; ++n) {
+                const CLHEP::Hep3Vector p(
+                    _xmin + fmod(0.5 + 0.8191725133961645 * (n + 1), 1.) * (_xmax - _xmin),
+                    _ymin + fmod(0.5 + 0.6710436067037893 * (n + 1), 1.) * (_ymax - _ymin),
+                    _zmin + fmod(0.5 + 0.5497004779019703 * (n + 1), 1.) * (_zmax - _zmin));
+                CLHEP::Hep3Vector exact;
+                evalFit(p, exact);
+                double b[3];
+                _cheb.evaluate(p.x(), p.y(), p.z(), b[0], b[1], b[2]);
+                for (int i = 0; i < 3; ++i) {
+                    report.maxDeviation[i] = std::max(report.maxDeviation[i], abs(b[i] - exact[i]));
+                }
+                report.maxDeviationMag = std::max(
+                    report.maxDeviationMag, (CLHEP::Hep3Vector(b[0], b[1], b[2]) - exact).mag());
+            }
+
+            report.converged = report.maxDeviationMag <= tolerance;
+            if (report.converged || 8 * std::size_t(ncx) * ncy * ncz * bytesPerCell > maxBytes) {
+                break;
+            }
+            ncx *= 2;
+            ncy *= 2;
+            ncz *= 2;
+        }
+        return report;
+    }
+
     void BFParamMap::print(std::ostream& os) const {
         os << "Magnetic Field Info: " << _key << endl;
 
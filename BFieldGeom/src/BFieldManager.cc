@@ -20,27 +20,89 @@ namespace mu2e {
     // Get field at an arbitrary point. This code figures out which map to use
     // and looks up the field in that map.
     bool BFieldManager::getBFieldWithStatus(const CLHEP::Hep3Vector& point,
+                                            BFieldQueryContext& ctx,
                                             CLHEP::Hep3Vector& result) const {
-        return getBFieldWithStatus(point, cm_, result);
-    }
+        BFMap const* m = cm_.findMap(point, ctx);
 
+        if (m) {
+            m->getBFieldCached(point, ctx, result);
+        } else {
+            result = CLHEP::Hep3Vector(0., 0., 0.);
+        }
 
-    // Get field at an arbitrary point. This code figures out which map to use
-    // and looks up the field in that map.
-    bool BFieldManager::getBFieldWithStatus(const CLHEP::Hep3Vector& point,
-                                            BFCacheManager const& cmgr,
-                                            CLHEP::Hep3Vector& result) const {
-        auto m = cmgr.findMap(point);
+        return (m != 0);
+    }
+
+    bool BFieldManager::getBFieldGradient(const CLHEP::Hep3Vector& point,
+                                          BFieldQueryContext& ctx,
+                                          CLHEP::Hep3Vector& result,
+                                          double grad[3][3]) const {
+        BFMap const* m = cm_.findMap(point, ctx);
 
         if (m) {
-            m->getBFieldWithStatus(point, result);
+            m->getBFieldGradient(point, ctx, result, grad);
         } else {
             result = CLHEP::Hep3Vector(0., 0., 0.);
+            for (int i = 0; i < 3; ++i) {
+                grad[i][0] = grad[i][1] = grad[i][2] = 0.;
+            }
         }
 
         return (m != 0);
     }
 
+    void BFieldManager::getBFieldBatch(CLHEP::Hep3Vector const* points,
+                                       std::size_t n,
+                                       BFieldQueryContext& ctx,
+                                       CLHEP::Hep3Vector* fields,
+                                       bool* status) const {
+        // Points are handed to the maps in chunks of at most this size.
+        constexpr std::size_t chunk = 64;
+        double x[chunk], y[chunk], z[chunk], bx[chunk], by[chunk], bz[chunk];
+        bool ok[chunk];
+
+        std::size_t i = 0;
+        while (i < n) {
+            BFMap const* map = cm_.findMap(points[i], ctx);
+            if (!map) {
+                fields[i] = CLHEP::Hep3Vector(0., 0., 0.);
+                if (status) {
+                    status[i] = false;
+                }
+                ++i;
+                continue;
+            }
+
+            // Extend the run of points served by this map.  Inner maps do not overlap
+            // so a point inside one belongs to it.  Outer maps may overlap each other
+            // and the inner maps, so those need the full lookup.
+            const bool inner = cm_.isInnerMap(map);
+            std::size_t end = i + 1;
+            while (end < n && end - i < chunk) {
+                if (inner ? !map->isValid(points[end])
+                          : cm_.findMap(points[end], ctx) != map) {
+                    break;
+                }
+                ++end;
+            }
+
+            const std::size_t nrun = end - i;
+            for (std::size_t k = 0; k < nrun; ++k) {
+                x[k] = points[i + k].x();
+                y[k] = points[i + k].y();
+                z[k] = points[i + k].z();
+            }
+            map->getBFieldBatch(nrun, x, y, z, bx, by, bz, ok);
+            for (std::size_t k = 0; k < nrun; ++k) {
+                fields[i + k] = CLHEP::Hep3Vector(bx[k], by[k], bz[k]);
+                // As in getBFieldWithStatus, the status says whether a map was found.
+                if (status) {
+                    status[i + k] = true;
+                }
+            }
+            i = end;
+        }
+    }
 
     std::shared_ptr<BFGridMap> BFieldManager::addBFGridMap(MapContainerType* mapContainer,
                                                            const std::string& key,
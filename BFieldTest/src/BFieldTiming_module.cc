@@ -0,0 +1,280 @@
+//
+// Time magnetic field lookups.
+//
+// The points are drawn uniformly inside a box given in the module parameter set:
+//
+//   bftiming : { module_type : BFieldTiming
+//                xmin : -4700 xmax : -3100 ymin : -800 ymax : 800 zmin : 3500 zmax : 14000
+//                npoints : 1000000 seed : 1 maxThreads : 8 stepLength : 5 }
+//
+// The box is in Mu2e coordinates.  The job prints the time per point for single point
+// and batch lookups through the BFieldManager and, for each grid map, the time per
+// point for the batch interpolation, along with the memory used by each grid map.
+// Run the job with bfield.floatStorage set to true and to false to compare the two
+// storage modes.
+//
+// It then times lookups along random walks with steps of stepLength mm, which look
+// like the queries of a stepper or a fitter, on 1, 2, 4, ... maxThreads threads.
+// Each thread walks its own path with its own BFieldQueryContext.
+//
+// Finally it times the field plus gradient along a walk, as needed by the KinKal fit,
+// from BFieldManager::getBFieldGradient and from finite differences over a batch of
+// four points, and prints the largest difference between the two gradients.
+//
+
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
+
+#include "Offline/BFieldGeom/inc/BFGridMap.hh"
+#include "Offline/BFieldGeom/inc/BFieldManager.hh"
+#include "Offline/GeometryService/inc/GeomHandle.hh"
+
+#include "CLHEP/Vector/ThreeVector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace mu2e {
+
+    class BFieldTiming : public art::EDAnalyzer {
+       public:
+        explicit BFieldTiming(const fhicl::ParameterSet& pset)
+            : art::EDAnalyzer(pset),
+              xmin_(pset.get<double>("xmin")),
+              xmax_(pset.get<double>("xmax")),
+              ymin_(pset.get<double>("ymin")),
+              ymax_(pset.get<double>("ymax")),
+              zmin_(pset.get<double>("zmin")),
+              zmax_(pset.get<double>("zmax")),
+              npoints_(pset.get<unsigned>("npoints", 1000000)),
+              seed_(pset.get<unsigned>("seed", 1)),
+              maxThreads_(pset.get<unsigned>("maxThreads", 8)),
+              stepLength_(pset.get<double>("stepLength", 5.)) {}
+
+        void beginRun(const art::Run& run);
+        void analyze(const art::Event&){};
+
+       private:
+        double xmin_, xmax_, ymin_, ymax_, zmin_, zmax_;
+        unsigned npoints_;
+        unsigned seed_;
+        unsigned maxThreads_;
+        double stepLength_;
+
+        // A random walk of npoints_ points inside the box.
+        std::vector<CLHEP::Hep3Vector> randomWalk(unsigned seed) const;
+
+        void timeThreads(BFieldManager const& bfmgr) const;
+        void timeGradient(BFieldManager const& bfmgr) const;
+    };
+
+    std::vector<CLHEP::Hep3Vector> BFieldTiming::randomWalk(unsigned seed) const {
+        std::mt19937 engine(seed);
+        std::uniform_real_distribution<double> fx(xmin_, xmax_), fy(ymin_, ymax_),
+            fz(zmin_, zmax_);
+        std::normal_distribution<double> step(0., stepLength_ / std::sqrt(3.));
+        std::vector<CLHEP::Hep3Vector> points(npoints_);
+        CLHEP::Hep3Vector p(fx(engine), fy(engine), fz(engine));
+        for (auto& q : points) {
+            // Reflect at the faces of the box.
+            auto reflect = [](double v, double lo, double hi) {
+                return v < lo ? 2 * lo - v : (v > hi ? 2 * hi - v : v);
+            };
+            p = CLHEP::Hep3Vector(reflect(p.x() + step(engine), xmin_, xmax_),
+                                  reflect(p.y() + step(engine), ymin_, ymax_),
+                                  reflect(p.z() + step(engine), zmin_, zmax_));
+            q = p;
+        }
+        return points;
+    }
+
+    void BFieldTiming::timeThreads(BFieldManager const& bfmgr) const {
+        typedef std::chrono::steady_clock Clock;
+        std::vector<std::vector<CLHEP::Hep3Vector>> walks;
+        for (unsigned t = 0; t < maxThreads_; ++t) {
+            walks.push_back(randomWalk(seed_ + 1 + t));
+        }
+
+        // 1, 2, 4, ... and maxThreads_.
+        std::vector<unsigned> counts;
+        for (unsigned n = 1; n < maxThreads_; n *= 2) {
+            counts.push_back(n);
+        }
+        counts.push_back(maxThreads_);
+
+        double single(0.);
+        for (unsigned nthreads : counts) {
+            std::vector<double> sums(nthreads, 0.);
+            std::vector<unsigned long> hits(nthreads, 0), misses(nthreads, 0);
+            auto work = [&](unsigned t) {
+                BFieldQueryContext ctx;
+                double sum(0.);
+                for (auto const& p : walks[t]) {
+                    sum += bfmgr.getBField(p, ctx).z();
+                }
+                sums[t] = sum;
+                hits[t] = ctx.cellHits();
+                misses[t] = ctx.cellMisses();
+            };
+
+            auto t0 = Clock::now();
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < nthreads; ++t) {
+                threads.emplace_back(work, t);
+            }
+            for (auto& th : threads) {
+                th.join();
+            }
+            auto t1 = Clock::now();
+
+            // Points per second summed over all threads.
+            const double rate =
+                nthreads * double(npoints_) / std::chrono::duration<double>(t1 - t0).count();
+            if (nthreads == 1) {
+                single = rate;
+            }
+            const double nhits = std::accumulate(hits.begin(), hits.end(), 0.);
+            const double nmisses = std::accumulate(misses.begin(), misses.end(), 0.);
+            std::cout << "BFieldTiming: " << nthreads << " threads, steps of " << stepLength_
+                      << " mm: " << rate / 1e6 << " Mpoints/s, speedup " << rate / single
+                      << ", cell cache hit rate "
+                      << (nhits + nmisses > 0 ? nhits / (nhits + nmisses) : 0.)
+                      << " (checksum " << std::accumulate(sums.begin(), sums.end(), 0.) << ")"
+                      << std::endl;
+        }
+    }
+
+    void BFieldTiming::timeGradient(BFieldManager const& bfmgr) const {
+        typedef std::chrono::steady_clock Clock;
+        const std::vector<CLHEP::Hep3Vector> walk = randomWalk(seed_);
+        const double h = BFMap::gradientStep;
+
+        BFieldQueryContext ctx;
+        double sum(0.);
+        double grad[3][3];
+        auto t0 = Clock::now();
+        for (auto const& p : walk) {
+            CLHEP::Hep3Vector b;
+            bfmgr.getBFieldGradient(p, ctx, b, grad);
+            sum += b.z() + grad[2][2];
+        }
+        auto t1 = Clock::now();
+        const double nsAnalytic =
+            std::chrono::duration<double, std::nano>(t1 - t0).count() / walk.size();
+
+        BFieldQueryContext ctxfd;
+        double sumfd(0.);
+        CLHEP::Hep3Vector points[4], fields[4];
+        t0 = Clock::now();
+        for (auto const& p : walk) {
+            points[0] = p;
+            points[1] = p + CLHEP::Hep3Vector(h, 0., 0.);
+            points[2] = p + CLHEP::Hep3Vector(0., h, 0.);
+            points[3] = p + CLHEP::Hep3Vector(0., 0., h);
+            bfmgr.getBFieldBatch(points, 4, ctxfd, fields);
+            sumfd += fields[0].z() + (fields[3].z() - fields[0].z()) / h;
+        }
+        t1 = Clock::now();
+        const double nsDiff =
+            std::chrono::duration<double, std::nano>(t1 - t0).count() / walk.size();
+
+        // The finite differences are only comparable away from cell faces, where the
+        // interpolated gradient is discontinuous; the median difference is reported.
+        std::vector<double> diffs;
+        for (unsigned i = 0; i < walk.size(); i += 97) {
+            CLHEP::Hep3Vector b;
+            bfmgr.getBFieldGradient(walk[i], ctx, b, grad);
+            double diff(0.);
+            for (int j = 0; j < 3; ++j) {
+                CLHEP::Hep3Vector step(0., 0., 0.);
+                step[j] = h;
+                const CLHEP::Hep3Vector db =
+                    (bfmgr.getBField(walk[i] + step, ctx) - b) / h;
+                for (int k = 0; k < 3; ++k) {
+                    diff = std::max(diff, std::abs(db[k] - grad[k][j]));
+                }
+            }
+            diffs.push_back(diff);
+        }
+        std::nth_element(diffs.begin(), diffs.begin() + diffs.size() / 2, diffs.end());
+
+        std::cout << "BFieldTiming: field and gradient, steps of " << stepLength_
+                  << " mm: getBFieldGradient " << nsAnalytic << " ns/point, finite differences "
+                  << nsDiff << " ns/point, median difference "
+                  << (diffs.empty() ? 0. : diffs[diffs.size() / 2]) << " T/mm (checksums " << sum
+                  << " " << sumfd << ")" << std::endl;
+    }
+
+    void BFieldTiming::beginRun(const art::Run& run) {
+        GeomHandle<BFieldManager> bfmgr;
+
+        std::mt19937 engine(seed_);
+        std::uniform_real_distribution<double> fx(xmin_, xmax_), fy(ymin_, ymax_),
+            fz(zmin_, zmax_);
+        std::vector<double> x(npoints_), y(npoints_), z(npoints_);
+        for (unsigned i = 0; i < npoints_; ++i) {
+            x[i] = fx(engine);
+            y[i] = fy(engine);
+            z[i] = fz(engine);
+        }
+
+        typedef std::chrono::steady_clock Clock;
+        auto nsPerPoint = [this](Clock::time_point t0, Clock::time_point t1) {
+            return std::chrono::duration<double, std::nano>(t1 - t0).count() / npoints_;
+        };
+
+        // The sum keeps the compiler from discarding the lookups.
+        double sum(0.);
+        auto t0 = Clock::now();
+        for (unsigned i = 0; i < npoints_; ++i) {
+            sum += bfmgr->getBField(CLHEP::Hep3Vector(x[i], y[i], z[i])).z();
+        }
+        auto t1 = Clock::now();
+        std::cout << "BFieldTiming: BFieldManager::getBField " << nsPerPoint(t0, t1)
+                  << " ns/point (checksum " << sum << ")" << std::endl;
+
+        std::vector<CLHEP::Hep3Vector> points(npoints_), fields;
+        for (unsigned i = 0; i < npoints_; ++i) {
+            points[i] = CLHEP::Hep3Vector(x[i], y[i], z[i]);
+        }
+        t0 = Clock::now();
+        bfmgr->getBFieldBatch(points, fields);
+        t1 = Clock::now();
+        std::cout << "BFieldTiming: BFieldManager::getBFieldBatch " << nsPerPoint(t0, t1)
+                  << " ns/point" << std::endl;
+
+        std::vector<double> bx(npoints_), by(npoints_), bz(npoints_);
+        std::unique_ptr<bool[]> status(new bool[npoints_]);
+        for (auto const* maps : {&bfmgr->getInnerMaps(), &bfmgr->getOuterMaps()}) {
+            for (auto const& m : *maps) {
+                auto grid = std::dynamic_pointer_cast<const BFGridMap>(m);
+                if (!grid) {
+                    continue;
+                }
+                t0 = Clock::now();
+                grid->getBFieldBatch(npoints_, x.data(), y.data(), z.data(), bx.data(), by.data(),
+                                     bz.data(), status.get());
+                t1 = Clock::now();
+                std::cout << "BFieldTiming: " << grid->getKey()
+                          << (grid->isPacked() ? " (float)" : " (double)") << " batch "
+                          << nsPerPoint(t0, t1) << " ns/point, " << grid->memoryUsage()
+                          << " bytes" << std::endl;
+            }
+        }
+
+        timeThreads(*bfmgr);
+        timeGradient(*bfmgr);
+    }
+
+}  // namespace mu2e
+
+DEFINE_ART_MODULE(mu2e::BFieldTiming);
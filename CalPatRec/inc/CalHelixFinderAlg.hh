@@ -40,7 +40,9 @@ namespace mu2e {
     enum { kMaxNHits = 10000 } ;
 
 //-----------------------------------------------------------------------------
-// data members
+// data members. The state of a helix search is kept in CalHelixFinderData,
+// so that several time clusters can be searched concurrently; during a search
+// only the diagnostic buffers (_diag > 0) are written
 //-----------------------------------------------------------------------------
     const Tracker*            _tracker;
     const Calorimeter*         _calorimeter;
@@ -48,11 +50,6 @@ namespace mu2e {
     //    const CalTimePeak*         fTimePeak;
     //    const TimeCluster*         fTimeCluster; //needed for debugging
     
-    float                     fCaloTime;
-    float                     fCaloX;   
-    float                     fCaloY;   
-    float                     fCaloZ;   
-    
     //    std::vector<CalHelixPoint> _xyzp;        // normally includes only hits from the time peak
 //-----------------------------------------------------------------------------
 // for diagnostics purposes save several states of _xyzp (only if _diag > 0)
@@ -87,8 +84,6 @@ namespace mu2e {
 
     SaveResults_t        _results[6];      // diagnostic buffers
 
-    int                  fUseDefaultDfDz;
-
     int                  _diag;
     int                  _debug;
     int                  _debug2;
@@ -99,7 +94,6 @@ namespace mu2e {
     int                  _minNHits;     // minimum # of hits for a helix candidate
                                         // 2014-03-10 Gianipez and P. Murat: limit
                                         // the dfdz value in the pattern-recognition stage
-    float               _mpDfDz;
     float               _absMpDfDz;         // absolute value of most probable expected dphi/dz
     int                 _initDfDz;
     float               _dzOverHelPitchCut; //cut on the ratio between the Dz and the predicted helix-pitch used in ::findDfDz(...)
@@ -113,9 +107,6 @@ namespace mu2e {
     float               _maxXDPhi;     // max normalized hit residual in phi (findRZ)
     float               _maxPanelToHelixDPhi;  // max dphi between the helix prediction and a given tracker plane
 
-    float               _hdfdz;        // estimated d(phi)/dz value
-    float               _sdfdz;        // estimated d(phi)/dz error
-    float               _hphi0;
 					// 201-03-31 Gianipez added for changing the value of the
 					// squared distance requed bewtween a straw hit and its predicted 
 					// position used in the patter recognition procedure
@@ -133,11 +124,6 @@ namespace mu2e {
     bool                 _usetarget;     // constrain to target when initializing
     float                _maxZTripletSearch; //maximum z allowed for the hit used to search the best triplet
     mutable float       _bz;            // cached value of Field Z component at the tracker origin
-//-----------------------------------------------------------------------------
-// cached value of radius and pitch sign: these depend on the particle type
-// and direction
-//-----------------------------------------------------------------------------
-    float    _rmin, _rmax, _smin, _smax, _dfdzsign;
 //-----------------------------------------------------------------------------//
 // store the paramters value of the most reliable track candidate
 //-----------------------------------------------------------------------------//
@@ -152,15 +138,9 @@ namespace mu2e {
     // indices, distance from prediction and distance along z axis from the seeding hit
     // of the hits found in the pattern recognition
 
-    int       _phiCorrectedDefined;
-
     float    _dfdzErr;                 // error on dfdz by ::findDfDz
     float    _minarea2;
 //-----------------------------------------------------------------------------
-// checkpoints, used for debugging
-//-----------------------------------------------------------------------------
-    int       _findTrackLoopIndex;
-//-----------------------------------------------------------------------------
 // functions
 //-----------------------------------------------------------------------------
   public:
@@ -195,7 +175,8 @@ namespace mu2e {
 				const XYZVec& HelCenter, 
 				float                   Radius);
 
-    bool   calculateTrackParameters(const XYZVec& p1, 
+    bool   calculateTrackParameters(CalHelixFinderData& Helix,
+                                    const XYZVec& p1, 
 				    const XYZVec& p2,
                                     const XYZVec& p3,
 				    XYZVec&       Center, 
@@ -304,7 +285,7 @@ namespace mu2e {
 
     // void   resolve2PiAmbiguity  (CalHelixFinderData& Helix,const XYZVec& Center, float DfDz, float Phi0);
 
-    void   resetTrackParamters  ();
+    void   resetTrackParamters  (CalHelixFinderData& Helix);
 //-----------------------------------------------------------------------------
 // save intermediate results in diagnostics mode
 //-----------------------------------------------------------------------------
@@ -152,6 +152,24 @@ namespace mu2e {
     float             _dfdz;
     float             _fz0;
 //-----------------------------------------------------------------------------
+// state of the search in CalHelixFinderAlg, set by findHelix:
+// calorimeter cluster position in the tracker frame, radius and pitch range
+// for the helicity searched, and the last dphi/dz estimate
+//-----------------------------------------------------------------------------
+    float             _caloTime;
+    float             _caloX;
+    float             _caloY;
+    float             _caloZ;
+
+    float             _rmin, _rmax, _smin, _smax, _dfdzsign;
+    float             _mpDfDz;          // most probable dphi/dz, signed
+
+    float             _hdfdz;           // estimated d(phi)/dz value
+    float             _hphi0;
+    int               _useDefaultDfDz;
+    int               _phiCorrectedDefined;
+    int               _findTrackLoopIndex; // checkpoint, used for debugging
+//-----------------------------------------------------------------------------
 // diagnostics, histogramming
 //-----------------------------------------------------------------------------
     Diag_t             _diag;
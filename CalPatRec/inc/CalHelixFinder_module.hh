@@ -75,6 +75,16 @@ namespace mu2e {
   class ModuleHistToolBase;
 
   class CalHelixFinder : public art::EDFilter {
+  public:
+//-----------------------------------------------------------------------------
+// result of the helix search in one time cluster
+//-----------------------------------------------------------------------------
+    struct TimeClusterResult_t {
+      int                     nGoodHits;
+      int                     indexBest;        // as returned by pickBestHelix, -1 if no helix found
+      std::vector<HelixSeed>  seeds;
+    };
+
   protected:
 //-----------------------------------------------------------------------------
 // data members
@@ -85,6 +95,7 @@ namespace mu2e {
     int                                   _debugLevel;
     int                                   _printfreq;
     int                                   _useAsFilter; //allows to use the module as a produer or as a filter
+    bool                                  _parallelTimeClusters; // search the time clusters concurrently
 //-----------------------------------------------------------------------------
 // event object labels
 //-----------------------------------------------------------------------------
@@ -155,6 +166,9 @@ namespace mu2e {
 			     const StrawHitFlagCollection*      ShFlagCollection);
     
     int  goodHitsTimeCluster(const TimeCluster* TimeCluster);
+
+    void findHelices       (int IPeak, CalHelixFinderData& HfResult, TimeClusterResult_t& Result);
+    void fillDiagnostics   (CalHelixFinderData& HfResult, TimeClusterResult_t& Result);
     
     void pickBestHelix(std::vector<HelixSeed>& HelVec, int &Index_best);
   };
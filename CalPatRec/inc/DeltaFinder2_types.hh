@@ -19,6 +19,7 @@ namespace fhicl {
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
 #include "Offline/TrackerGeom/inc/Straw.hh"
+#include "Offline/GeneralUtilities/inc/SmallVector.hh"
 
 namespace mu2e {
   class Panel;
@@ -46,7 +47,8 @@ namespace mu2e {
     enum {
       kNStations      = 20,
       kNFaces         =  4,
-      kNPanelsPerFace =  3
+      kNPanelsPerFace =  3,
+      kMaxHitsPerFace =  8                     // hits per face stored in a seed without heap allocation
     };
     
     struct HitData_t {
@@ -145,8 +147,8 @@ namespace mu2e {
       float                          fChi21;             // chi2's of the two initial hits
       float                          fChi22;
       PanelZ_t*                      panelz   [kNFaces];
-      std::vector<const HitData_t*>  hitlist  [kNFaces];
-      std::vector<McPart_t*>         fMcPart  [kNFaces];
+      SmallVector<const HitData_t*,kMaxHitsPerFace> hitlist[kNFaces];
+      SmallVector<McPart_t*,kMaxHitsPerFace>        fMcPart[kNFaces]; // list parallel to hitlist
       XYZVec                         CofM;
       float                          fMinTime;          // min and max times of the included hits
       float                          fMaxTime;
@@ -246,7 +248,7 @@ namespace mu2e {
       const Tracker*                tracker;
       std::string                   strawDigiMCCollectionTag;
       std::string                   ptrStepPointMCVectorCollectionTag;
-      std::vector<DeltaSeed*>       seedHolder [kNStations];
+      std::vector<DeltaSeed*>       seedHolder [kNStations]; // seeds are stored in the module, valid for one event
       std::vector<DeltaCandidate>   deltaCandidateHolder;
       PanelZ_t                      oTracker[kNStations][kNFaces][kNPanelsPerFace];
       int                           stationUsed[kNStations];
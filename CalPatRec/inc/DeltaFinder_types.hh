@@ -15,6 +15,7 @@ namespace fhicl {
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
 #include "Offline/TrackerGeom/inc/Straw.hh"
 #include "Offline/TrackerGeom/inc/Tracker.hh"
+#include "Offline/GeneralUtilities/inc/SmallVector.hh"
 
 namespace mu2e {
   class Panel;
@@ -41,7 +42,8 @@ namespace mu2e {
     enum {
       kNStations      = StrawId::_nplanes/2,   // number of tracking stations
       kNFaces         = StrawId::_nfaces*2 ,   // N(faces) per station (4)
-      kNPanelsPerFace = StrawId::_npanels/2    // = 3
+      kNPanelsPerFace = StrawId::_npanels/2,   // = 3
+      kMaxHitsPerFace = 8                      // hits per face stored in a seed without heap allocation
     };
     
     struct HitData_t {
@@ -75,11 +77,20 @@ namespace mu2e {
     struct PanelZ_t {
       int                              fNHits  ; // guess, total number of ComboHits
       std::vector<HitData_t>           fHitData;
+      std::vector<float>               fTime;       // hit times, in time order
+      std::vector<int>                 fTimeOrder;  // indices of fHitData, in time order
       const Panel*                     fPanel;      // backward pointer to the tracker panel
       double                           wx;          // direction cosines of the wires, assumed to be all the same
       double                           wy;
       double                           phi;         // phi angle of the wire
       double                           z;           // 
+//-----------------------------------------------------------------------------
+// build the time index of fHitData, after all hits have been added.
+// HitsInTimeWindow returns the indices of the hits with TMin <= time <= TMax,
+// in the order of fHitData
+//-----------------------------------------------------------------------------
+      void  IndexHits       ();
+      void  HitsInTimeWindow(double TMin, double TMax, std::vector<int>& List) const;
     }; 
 
 //-----------------------------------------------------------------------------
@@ -140,8 +151,8 @@ namespace mu2e {
       float                          fChi21;             // chi2's of the two initial hits
       float                          fChi22;
       PanelZ_t*                      panelz   [kNFaces];
-      std::vector<const HitData_t*>  hitlist  [kNFaces];
-      std::vector<McPart_t*>         fMcPart  [kNFaces];
+      SmallVector<const HitData_t*,kMaxHitsPerFace> hitlist[kNFaces];
+      SmallVector<McPart_t*,kMaxHitsPerFace>        fMcPart[kNFaces]; // list parallel to hitlist
       CLHEP::Hep3Vector              CofM;
       float                          fMinTime;          // min and max times of the included hits
       float                          fMaxTime;
@@ -241,7 +252,7 @@ namespace mu2e {
       const Tracker*                tracker;
       std::string                   strawDigiMCCollectionTag;
       std::string                   ptrStepPointMCVectorCollectionTag;
-      std::vector<DeltaSeed*>       seedHolder [kNStations];
+      std::vector<DeltaSeed*>       seedHolder [kNStations]; // seeds are stored in the module, valid for one event
       std::vector<DeltaCandidate>   deltaCandidateHolder;
       PanelZ_t                      oTracker[kNStations][kNFaces][kNPanelsPerFace];
       int                           stationUsed[kNStations];
@@ -212,20 +212,20 @@ namespace mu2e {
     //check presence of a cluster
     const CaloCluster* cl = Helix._timeCluster->caloCluster().get();
     if (cl == NULL){
-      fCaloTime = -9999.;
-      fCaloX    = -9999.;
-      fCaloY    = -9999.;
-      fCaloZ    = -9999.;
+      Helix._caloTime = -9999.;
+      Helix._caloX    = -9999.;
+      Helix._caloY    = -9999.;
+      Helix._caloZ    = -9999.;
       return;
     }
     //fill the calorimeter cluster info
     Hep3Vector  gpos = _calorimeter->geomUtil().diskToMu2e(cl->diskID(),cl->cog3Vector());
     Hep3Vector  tpos = _calorimeter->geomUtil().mu2eToTracker(gpos);
-    fCaloTime        = cl->time();
-    fCaloX           = tpos.x();
-    fCaloY           = tpos.y();
+    Helix._caloTime        = cl->time();
+    Helix._caloX           = tpos.x();
+    Helix._caloY           = tpos.y();
     float     offset = _calorimeter->caloInfo().getDouble("diskCaseZLength")/2. + (_calorimeter->caloInfo().getDouble("BPPipeZOffset") + _calorimeter->caloInfo().getDouble("BPHoleZLength")+ _calorimeter->caloInfo().getDouble("FEEZLength"))/2. - _calorimeter->caloInfo().getDouble("FPCarbonZLength") - _calorimeter->caloInfo().getDouble("FPFoamZLength");
-    fCaloZ           = tpos.z()-offset;
+    Helix._caloZ           = tpos.z()-offset;
   }
 
 
@@ -250,17 +250,17 @@ namespace mu2e {
 //  compute the allowed radial range for this fit
 //-----------------------------------------------------------------------------
     float pb = fabs((CLHEP::c_light*1e-3)/(bz()*Helix._tpart.charge()));
-    _rmin = _pmin/(pb*sqrt(1.0+_tdmax*_tdmax));
-    _rmax = _pmax/(pb*sqrt(1.0+_tdmin*_tdmin));
+    Helix._rmin = _pmin/(pb*sqrt(1.0+_tdmax*_tdmax));
+    Helix._rmax = _pmax/(pb*sqrt(1.0+_tdmin*_tdmin));
 //-----------------------------------------------------------------------------
 //  particle charge, field, and direction affect the pitch range
 //-----------------------------------------------------------------------------
-    _dfdzsign = Helix._helicity == Helicity::poshel ? 1 : -1;// copysign(1.0,-Helix._tpart.charge()*Helix._fdir.dzdt()*bz());
+    Helix._dfdzsign = Helix._helicity == Helicity::poshel ? 1 : -1;// copysign(1.0,-Helix._tpart.charge()*Helix._fdir.dzdt()*bz());
     
-    _smax     = _dfdzsign/(_rmax*_tdmax);
-    _smin     = _dfdzsign/(_rmin*_tdmin);
+    Helix._smax     = Helix._dfdzsign/(Helix._rmax*_tdmax);
+    Helix._smin     = Helix._dfdzsign/(Helix._rmin*_tdmin);
 
-    _mpDfDz   = _dfdzsign*_absMpDfDz;
+    Helix._mpDfDz   = Helix._dfdzsign*_absMpDfDz;
 //-----------------------------------------------------------------------------
 // call down
 //-----------------------------------------------------------------------------
@@ -280,7 +280,7 @@ namespace mu2e {
 // 2014-11-09 gianipez: reset the track candidate parameters if a new time peak is used!
 // so the previous candidate should not be compared to the new one at this level
 //-----------------------------------------------------------------------------
-    resetTrackParamters();
+    resetTrackParamters(Helix);
 //-----------------------------------------------------------------------------
 // save results in the very beginning
 //-----------------------------------------------------------------------------
@@ -305,7 +305,7 @@ namespace mu2e {
     if (Helix._nStrawHits < _minNHits ) {
       Helix._fit = TrkErrCode(TrkErrCode::fail,1); // small number of hits
     }
-    else if ((Helix._radius < _rmin) || (Helix._radius > _rmax)) {
+    else if ((Helix._radius < Helix._rmin) || (Helix._radius > Helix._rmax)) {
       Helix._fit = TrkErrCode(TrkErrCode::fail,2); // initialization failure
     }
     else if ((Helix._nXYSh < _minNHits) || (Helix._sxy.chi2DofCircle() > _chi2xyMax)) {
@@ -758,8 +758,8 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
 // calorimeter cluster - point number nstations+1
 //-----------------------------------------------------------------------------
-    float zCl     = fCaloZ;
-    float phiCl   = polyAtan2(fCaloY-center->y(),fCaloX-center->x());
+    float zCl     = Helix._caloZ;
+    float phiCl   = polyAtan2(Helix._caloY-center->y(),Helix._caloX-center->x());
     if (phiCl < 0) phiCl += 2*M_PI;
 
     phiVec[nstations] = phiCl;
@@ -841,7 +841,7 @@ namespace mu2e {
 
 	dphi = phiVec[j]-phi_ref;
 	dz   = zVec[j] - z_ref;
-	float dphidz =dphi/dz*_dfdzsign; //HERE
+	float dphidz =dphi/dz*Helix._dfdzsign; //HERE
 	
 	weight = nhits[i] + nhits[j];
 //-----------------------------------------------------------------------------
@@ -926,8 +926,8 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
 // Part 2: perform a more accurate estimate - straight line fit
 //-----------------------------------------------------------------------------
-    if (nstations_with_hits < 2) _hdfdz = _mpDfDz;                                 
-    else                         _hdfdz = xmp*_dfdzsign;
+    if (nstations_with_hits < 2) Helix._hdfdz = Helix._mpDfDz;                                 
+    else                         Helix._hdfdz = xmp*Helix._dfdzsign;
 //-----------------------------------------------------------------------------
 // last step - determine phi0 = phi(z=0)
 //-----------------------------------------------------------------------------
@@ -938,7 +938,7 @@ namespace mu2e {
       if (nhits[i] == 0) continue;
 
       if (sn == 0) { // first station with hits gives the "2*PI normalization";
-	phi0 = phiVec[i]-zVec[i]*_hdfdz;
+	phi0 = phiVec[i]-zVec[i]*Helix._hdfdz;
 	sdphi = 0;
 	sn    = 1;
       }
@@ -946,13 +946,13 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
 // for all points different from the first one need to choose the turn number
 //-----------------------------------------------------------------------------
-	dphi = phiVec[i]-(phi0+zVec[i]*_hdfdz);
+	dphi = phiVec[i]-(phi0+zVec[i]*Helix._hdfdz);
 	float dphi_min = dphi;
 
 	int n= 0;
 	while (1) {
 	  n += 1;
-	  float dphi = phiVec[i]+2*M_PI*n-(phi0+zVec[i]*_hdfdz);
+	  float dphi = phiVec[i]+2*M_PI*n-(phi0+zVec[i]*Helix._hdfdz);
 	  if (fabs(dphi) < fabs(dphi_min)) dphi_min = dphi;
 	  else break;
 	}
@@ -960,7 +960,7 @@ namespace mu2e {
 	n=0;
 	while (1) {
 	  n -= 1;
-	  float dphi = phiVec[i]+2*M_PI*n-(phi0+zVec[i]*_hdfdz);
+	  float dphi = phiVec[i]+2*M_PI*n-(phi0+zVec[i]*Helix._hdfdz);
 	  if (fabs(dphi) < fabs(dphi_min)) dphi_min = dphi;
 	  else break;
 	}
@@ -970,14 +970,14 @@ namespace mu2e {
       }
     }
 
-    _hphi0 = phi0 + sdphi/sn;
+    Helix._hphi0 = phi0 + sdphi/sn;
 
     if (Diag_flag > 0){
       Helix._diag.nStationPairs = nstations_with_hits;
     }
 
     if (_debug > 5) {
-      printf("[CalHelixFinderAlg::findDfDz] END: _hdfdz = %9.5f _hphi0 = %9.6f ", _hdfdz, _hphi0);
+      printf("[CalHelixFinderAlg::findDfDz] END: _hdfdz = %9.5f _hphi0 = %9.6f ", Helix._hdfdz, Helix._hphi0);
     }
 
     return 1;
@@ -1221,9 +1221,9 @@ namespace mu2e {
       helCenter = XYZVec( Helix._sxy.x0(), Helix._sxy.y0(), 0);
     }
 
-    float zCl   = fCaloZ;
-    float dx    = (fCaloX - helCenter.x());
-    float dy    = (fCaloY - helCenter.y());
+    float zCl   = Helix._caloZ;
+    float dx    = (Helix._caloX - helCenter.x());
+    float dy    = (Helix._caloY - helCenter.y());
     float phiCl = polyAtan2(dy, dx);
     if (phiCl < 0) phiCl = phiCl + 2*M_PI;
 
@@ -1344,7 +1344,7 @@ namespace mu2e {
 	   (faceHitChi2 < 2.) &&
 	   ( (fabs(phiZInfo.dfdz - Helix._szphi.dfdz()) < 8.e-4) ) &&//  || //require that the new value of dfdz is
 				 //close to the starting one. update dfdz only if:
-	   ((Helix._szphi.dfdz()*_dfdzsign) > 0.) && //{                    // 1. the points browsed are more the half
+	   ((Helix._szphi.dfdz()*Helix._dfdzsign) > 0.) && //{                    // 1. the points browsed are more the half
 	   (phiZInfo.dz >=_mindist ) ){
 	phiZInfo.dfdz  = Helix._szphi.dfdz();                     //    delta hits could have moved dfdz to negative value!
 	phiZInfo.phi0  = Helix._szphi.phi0();                     // 2. and require dfdz to be positivie! scattered hits or
@@ -1353,7 +1353,7 @@ namespace mu2e {
 	
       }
     }//end face loop
-    _phiCorrectedDefined = 1;
+    Helix._phiCorrectedDefined = 1;
 
     if (_debug > 5) {
       printf("[CalHelixFinderAlg::doLinearFitPhiZ:BEFORE_CLEANUP] Helix: phi_0 = %5.3f dfdz = %5.5f chi2N = %5.3f points removed = %4i\n",
@@ -1441,7 +1441,7 @@ namespace mu2e {
       success = true;
     }
     //----------------------------------------------------------------------//
-   if ((Helix._szphi.dfdz()*_dfdzsign) < 0.) { 
+   if ((Helix._szphi.dfdz()*Helix._dfdzsign) < 0.) { 
       success = false;
     }
     else if (success) {                               // update helix results
@@ -1557,7 +1557,7 @@ namespace mu2e {
 
     float clPhi(-9999.);
 
-    if (fCaloTime > 0) clPhi = polyAtan2(fCaloY,fCaloX);
+    if (Helix._caloTime > 0) clPhi = polyAtan2(Helix._caloY,Helix._caloX);
 
     const vector<StrawHitIndex>& shIndices = Helix._timeCluster->hits();
     ChannelID cx, co;
@@ -2052,28 +2052,34 @@ namespace mu2e {
 
     int    useMPVdfdz(1), useIntelligentWeight(1);//, nHitsTested(0);
 
-    if (_debug != 0) printf("[CalHelixFinderAlg::doPatternRecognition:BEGIN] fUseDefaultDfDz = %i\n",fUseDefaultDfDz);
+    if (_debug != 0) printf("[CalHelixFinderAlg::doPatternRecognition:BEGIN] fUseDefaultDfDz = %i\n",Helix._useDefaultDfDz);
 
-    if (_debug2 == 0){
-      _debug2 = _debug;
-      _debug  = 0;
+//-----------------------------------------------------------------------------
+// the debug printout of the triplet search is enabled by debugLevel2 only.
+// Nothing is written when the debug is off, as the searches may run concurrently
+//-----------------------------------------------------------------------------
+    int restoreDebug(0);
+    if ((_debug2 == 0) && (_debug != 0)) {
+      _debug2      = _debug;
+      _debug       = 0;
+      restoreDebug = 1;
     }
 
     CalHelixFinderData tripletHelix(Helix);
     tripletHelix._helix = NULL;//FIXME!
 
-    _findTrackLoopIndex = 1; 		// debugging
+    tripletHelix._findTrackLoopIndex = 1; // debugging, used by findTrack
     searchBestTriplet(Helix, tripletHelix);
     //-----------------------------------------------------------------------------
     // 2014-11-09 gianipez: if no track was found requiring the recalculation of dfdz
     // look for a track candidate using the default value of dfdz and the target center
     //-----------------------------------------------------------------------------
-    _findTrackLoopIndex = 2; 		// *DEBUGGING*
-    if (fUseDefaultDfDz == 0) {
+    tripletHelix._findTrackLoopIndex = 2; // *DEBUGGING*
+    if (Helix._useDefaultDfDz == 0) {
       searchBestTriplet(Helix, tripletHelix, useMPVdfdz);
    }
 
-    if (_debug == 0){
+    if (restoreDebug) {
       _debug  = _debug2;
       _debug2 = 0;
     }
@@ -2133,8 +2139,8 @@ namespace mu2e {
       rs = findDfDz(Helix, HitInfo_t(0,0,-1));
       
       if (rs == 1) {			// update Helix Z-phi part
-	Helix._dfdz = _hdfdz;
-	Helix._fz0  = _hphi0;
+	Helix._dfdz = Helix._hdfdz;
+	Helix._fz0  = Helix._hphi0;
       }
     }
 
@@ -2275,7 +2281,7 @@ namespace mu2e {
     Helix._nXYSh = 0;
     Helix._nComboHits = 0;
 
-    Helix._sxy.addPoint(fCaloX,fCaloY,1./100.);
+    Helix._sxy.addPoint(Helix._caloX,Helix._caloY,1./100.);
     Helix._nXYSh += 1;
     Helix._nComboHits += 1;
 //-------------------------------------------------------------------------------
@@ -2764,7 +2770,7 @@ namespace mu2e {
 
 	  drChi2  = (dr*dr)*wt;
 	  
-	  if ((UsePhiResiduals == 1) && (_phiCorrectedDefined)) {
+	  if ((UsePhiResiduals == 1) && (Helix._phiCorrectedDefined)) {
 	    phi_pred = Helix._zFace[f]*dfdz + phi0;
 	    dphi     = phi_pred - hit->_hphi;
 	    phiwt    = calculatePhiWeight(*hit, helCenter, r, 0, banner);
@@ -3014,7 +3020,7 @@ namespace mu2e {
     bool removeTarget(true);            // avoid the recalculation of dfdz
 					// and helix parameters in case when
                                         // others strawhit candidates are found
-    float dfdz = _mpDfDz;		// tanLambda/radius (set to most probable);
+    float dfdz = Helix._mpDfDz;		// tanLambda/radius (set to most probable);
 //----------------------------------------------------------------------
 // calculate helix paramters using the center of the stopping target,
 // the EMC cluster which seeded the CalTimePeak and the seeding strawhit.
@@ -3026,9 +3032,9 @@ namespace mu2e {
 
     XYZVec p1(0.,0.,0.);	       // target, z(ST) = 5971. - 10200. is not used
     XYZVec p2(seedHit->_pos);          // seed hit
-    XYZVec p3(fCaloX,fCaloY,fCaloZ);   // cluster
+    XYZVec p3(Helix._caloX,Helix._caloY,Helix._caloZ);   // cluster
     
-    if (!calculateTrackParameters(p1,p2,p3,center,radius,phi0,dfdz))    return;  
+    if (!calculateTrackParameters(Helix,p1,p2,p3,center,radius,phi0,dfdz))    return;  
     
 //--------------------------------------------------------------------------------
 // gianipez test 2019-09-28
@@ -3037,7 +3043,7 @@ namespace mu2e {
     if (_initDfDz == 1){
       int res = findDfDz(Helix, SeedIndex);
       if (res ==1 ) {
-	dfdz = _hdfdz;    
+	dfdz = Helix._hdfdz;    
       }
     }
     float     tollMax = fabs(2.*M_PI/dfdz);
@@ -3046,7 +3052,7 @@ namespace mu2e {
 // 2014-11-05 gianipez set dfdz equal to the most probable value for CE 
 //------------------------------------------------------------------------------
     if (UseMPVDfDz ==1 ) {
-      dfdz    = _hdfdz;			// _mpDfDz; 
+      dfdz    = Helix._hdfdz;			// _mpDfDz; 
       tollMax = fabs(2.*M_PI/dfdz);
     }
 
@@ -3232,7 +3238,7 @@ namespace mu2e {
 	  calculateDphiDz_2(Helix,SeedIndex,NComboHits,center.x(),center.y(),dfdz);
 	}
 	else if (UseMPVDfDz ==1) {
-	  dfdz = _hdfdz;
+	  dfdz = Helix._hdfdz;
 	}
 
 	if (_debug > 10) {
@@ -3251,7 +3257,7 @@ namespace mu2e {
 	  //-----------------------------------------------------------------------------
 	  if (_debug > 10) printf("[%s:DEF3] dfdz = %8.5f outside the limits. Continue the search\n",name.data(),dfdz);
 	  p1.SetXYZ(0.,0.,0.);
-	  dfdz = _mpDfDz;
+	  dfdz = Helix._mpDfDz;
 	}
 	else {
 	  //-----------------------------------------------------------------------------
@@ -3318,11 +3324,11 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
     int rs = findDfDz(Helix, SeedIndex);
     if (rs ==1 ) {
-      Helix._dfdz = _hdfdz;
-      Helix._fz0  = _hphi0;
+      Helix._dfdz = Helix._hdfdz;
+      Helix._fz0  = Helix._hphi0;
 					// fill diag vector
-      dfdzRes[1]  = _hdfdz;
-      dphi0Res[1] = _hphi0;
+      dfdzRes[1]  = Helix._hdfdz;
+      dphi0Res[1] = Helix._hphi0;
     }
 //-----------------------------------------------------------------------------
 // 2015-01-23 G. Pezzu and P. Murat: when it fails, doLinearFitPhiZ returns negative value
@@ -3366,8 +3372,8 @@ namespace mu2e {
       // }
     }
     else {
-      dfdz_end = _hdfdz;
-      phi0_end = _hphi0;
+      dfdz_end = Helix._hdfdz;
+      phi0_end = Helix._hphi0;
     }
 
     if (_debug > 10) {
@@ -3424,7 +3430,7 @@ namespace mu2e {
     Helix._dfdz   = dfdz_end;
 	
     if (_diag > 0){
-      Helix._diag.loopId_4           = _findTrackLoopIndex;
+      Helix._diag.loopId_4           = Helix._findTrackLoopIndex;
       Helix._diag.radius_5           = Helix._radius;
       Helix._diag.n_rescued_points_9 = rescuedPoints;
 
@@ -3483,7 +3489,8 @@ namespace mu2e {
   //-----------------------------------------------------------------------------
   // helix parameters are defined at Z=p2.z, Phi0 corresponds to p2
   //-----------------------------------------------------------------------------
-  bool CalHelixFinderAlg::calculateTrackParameters(const XYZVec&   p1       ,
+  bool CalHelixFinderAlg::calculateTrackParameters(CalHelixFinderData& Helix,
+						   const XYZVec&   p1       ,
 						   const XYZVec&   p2       ,
 						   const XYZVec&   p3       ,
 						   XYZVec&         Center   ,
@@ -3556,34 +3563,34 @@ namespace mu2e {
 // number of turns
 //-----------------------------------------------------------------------------
     float dphi32 = polyAtan2(dy3,dx3) - Phi0;
-    if (dphi32*_dfdzsign < 0.) dphi32 += 2.*M_PI;
+    if (dphi32*Helix._dfdzsign < 0.) dphi32 += 2.*M_PI;
 
     //    float exp_dphi = _mpDfDz*dz32;
 
     //check id DfDz is within the range 
-    if ( (fabs(DfDz32) < _minDfDz) || (fabs(DfDz32) > _maxDfDz)) DfDz32 = _mpDfDz;
+    if ( (fabs(DfDz32) < _minDfDz) || (fabs(DfDz32) > _maxDfDz)) DfDz32 = Helix._mpDfDz;
 
     DfDz32 = dphi32/dz32; 
 
-    float   diff      = fabs(DfDz32 - _mpDfDz);
-    float   diff_plus = fabs( (dphi32 + 2.*M_PI)/dz32 -_mpDfDz );
+    float   diff      = fabs(DfDz32 - Helix._mpDfDz);
+    float   diff_plus = fabs( (dphi32 + 2.*M_PI)/dz32 -Helix._mpDfDz );
     while ( diff_plus < diff ){
       dphi32  = dphi32 + 2.*M_PI;
       DfDz32      = dphi32/dz32;
-      diff      = fabs(DfDz32 - _mpDfDz);
-      diff_plus = fabs( (dphi32 + 2.*M_PI)/dz32 -_mpDfDz );
+      diff      = fabs(DfDz32 - Helix._mpDfDz);
+      diff_plus = fabs( (dphi32 + 2.*M_PI)/dz32 -Helix._mpDfDz );
     }
     
-    float   diff_minus = fabs( (dphi32 - 2.*M_PI)/dz32 -_mpDfDz );
+    float   diff_minus = fabs( (dphi32 - 2.*M_PI)/dz32 -Helix._mpDfDz );
     while ( diff_minus < diff ){
       dphi32   = dphi32 - 2.*M_PI;
       DfDz32       = dphi32/dz32;
-      diff       = fabs(DfDz32 - _mpDfDz);
-      diff_minus = fabs( (dphi32 - 2.*M_PI)/dz32 -_mpDfDz );
+      diff       = fabs(DfDz32 - Helix._mpDfDz);
+      diff_minus = fabs( (dphi32 - 2.*M_PI)/dz32 -Helix._mpDfDz );
     }
 
     //check id DfDz is within the range 
-    if ( (fabs(DfDz32) < _minDfDz) || (fabs(DfDz32) > _maxDfDz)) DfDz32 = _mpDfDz;
+    if ( (fabs(DfDz32) < _minDfDz) || (fabs(DfDz32) > _maxDfDz)) DfDz32 = Helix._mpDfDz;
 
     if (_debug > 5) {
 //-----------------------------------------------------------------------------
@@ -3592,7 +3599,7 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
       float d0     = sqrt(x0*x0+y0*y0)-Radius;
       float phi00  = polyAtan2(y0,x0);                    // sign taken into account 
-      float tandip = DfDz32*_dfdzsign*Radius;             // signs of DfDz32 and _dfdzsign should be the same
+      float tandip = DfDz32*Helix._dfdzsign*Radius;             // signs of DfDz32 and _dfdzsign should be the same
       float dphi   = phi00-Phi0;
       if (dphi < 0) dphi += 2*M_PI;                        // *FIXME* right-handed helix
 
@@ -4103,14 +4110,15 @@ void CalHelixFinderAlg::plotXY(int ISet) {
 // indices on the xyzp vector of: the straw hit seeding the search,
 // the second strawhit used for recalculating the dfdz value
 //---------------------------------------------------------------------------
-  void CalHelixFinderAlg::resetTrackParamters() {
+  void CalHelixFinderAlg::resetTrackParamters(CalHelixFinderData& Helix) {
 
-    fUseDefaultDfDz = 0;
-    _hphi0                  = -9999.;
+    Helix._useDefaultDfDz      = 0;
+    Helix._phiCorrectedDefined = 0;
+    Helix._hphi0                  = -9999.;
 //-----------------------------------------------------------------------------
 // quality paramters used for doing comparison between several track candidates
 //-----------------------------------------------------------------------------
-    _hdfdz                  = _mpDfDz;
+    Helix._hdfdz                  = Helix._mpDfDz;
   }
 
 }
@@ -14,6 +14,16 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
   CalHelixFinderData::CalHelixFinderData() {
     _helix = NULL;
+
+    _caloTime = _caloX = _caloY = _caloZ = -9999.;
+    _rmin = _rmax = _smin = _smax = _mpDfDz = 0.;
+    _dfdzsign            = 1.;
+    _hdfdz               = 0.;
+    _hphi0               = -9999.;
+    _useDefaultDfDz      = 0;
+    _phiCorrectedDefined = 0;
+    _findTrackLoopIndex  = 0;
+
     _goodhits.reserve(kNMaxChHits);
     _chHitsToProcess. reserve(kNMaxChHits);
   }
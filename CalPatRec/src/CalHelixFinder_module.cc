@@ -43,6 +43,9 @@
 #include "TSystem.h"
 #include "TInterpreter.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace std;
 using namespace boost::accumulators;
 using CLHEP::HepVector;
@@ -58,6 +61,7 @@ namespace mu2e {
     _debugLevel         (pset.get<int>   ("debugLevel"                     )),
     _printfreq          (pset.get<int>   ("printFrequency"                 )),
     _useAsFilter        (pset.get<int>   ("useAsFilter"                    )),
+    _parallelTimeClusters(pset.get<bool> ("parallelTimeClusters"     ,true )),
     _shLabel            (pset.get<string>("StrawHitCollectionLabel"        )),
     _shfLabel           (pset.get<string>("StrawHitFlagCollectionLabel"    )),
     _timeclLabel        (pset.get<string>("TimeClusterCollectionLabel"     )),
@@ -119,6 +123,8 @@ namespace mu2e {
 
     _hfinder.setTracker    (_tracker);
     _hfinder.setCalorimeter(_calorimeter);
+                                        // cache the field before the time clusters are searched concurrently
+    _hfinder.bz();
 
     ChannelID cx, co;
     int       nPlanesPerStation(2);
@@ -228,7 +234,6 @@ namespace mu2e {
     // _data.nseeds[0] = 0;
     // _data.nseeds[1] = 0;
     _iev            = event.id().event();
-    int   nGoodTClusterHits(0);
 
     if ((_debugLevel > 0) && (_iev%_printfreq) == 0) printf("[%s] : START event number %8i\n", oname,_iev);
 
@@ -257,185 +262,191 @@ namespace mu2e {
     _hfResult._shfcol = _shfcol;
 
     _data.nTimePeaks  = _timeclcol->size();
-    for (int ipeak=0; ipeak<_data.nTimePeaks; ipeak++) {
-      const TimeCluster* tc = &_timeclcol->at(ipeak);
-      nGoodTClusterHits     = goodHitsTimeCluster(tc);
-      if ( nGoodTClusterHits < _minNHitsTimeCluster)         continue;
+    {
+      std::vector<TimeClusterResult_t> results(_data.nTimePeaks);
+//-----------------------------------------------------------------------------
+// the time clusters are independent: search them concurrently, each task with
+// its own copy of the search data. The diagnostics and the debug printout need
+// the sequential order
+//-----------------------------------------------------------------------------
+      bool serial = (! _parallelTimeClusters) || (_diagLevel > 0) || (_debugLevel > 0) ||
+	            (_hfinder._diag > 0)       || (_hfinder._debug != 0);
+      if (serial) {
+	for (int ipeak=0; ipeak<_data.nTimePeaks; ipeak++) {
+	  findHelices(ipeak, _hfResult, results[ipeak]);
+	  if ((_diagLevel > 0) && (results[ipeak].indexBest >= 0)) fillDiagnostics(_hfResult, results[ipeak]);
+	}
+      }
+      else {
+	tbb::parallel_for(tbb::blocked_range<int>(0, _data.nTimePeaks),
+			  [&](const tbb::blocked_range<int>& Range) {
+			    CalHelixFinderData hfResult(_hfResult);
+			    for (int ipeak=Range.begin(); ipeak!=Range.end(); ++ipeak) {
+			      findHelices(ipeak, hfResult, results[ipeak]);
+			    }
+			  });
+      }
+//-----------------------------------------------------------------------------
+// fill seed information, in the order of the time clusters
+//-----------------------------------------------------------------------------
+      for (auto& result : results) {
+	int                      index_best     = result.indexBest;
+	std::vector<HelixSeed>&  helix_seed_vec = result.seeds;
+	if ( (index_best>=0) && (index_best < 2) ){
+	  Helicity              hel_best = helix_seed_vec[index_best]._helix._helicity;
+	  HelixSeedCollection*  hcol     = helcols[hel_best].get();
+	  helix_seed_vec[index_best]._status.merge(TrkFitFlag::helixOK);
+	  hcol->push_back(helix_seed_vec[index_best]);
+	} else if (index_best == 2){//both helices need to be saved
+	  
+	  for (unsigned k=0; k<_hels.size(); ++k){
+	    helix_seed_vec[k]._status.merge(TrkFitFlag::helixOK);
+	    Helicity              hel_best = helix_seed_vec[k]._helix._helicity;
+	    HelixSeedCollection*  hcol     = helcols[hel_best].get();
+	    hcol->push_back(helix_seed_vec[k]);
+	  }
+	}
+      }
+    }
+//--------------------------------------------------------------------------------
+// fill histograms
+//--------------------------------------------------------------------------------
+    if (_diagLevel > 0) _hmanager->fillHistograms(&_data);
+//-----------------------------------------------------------------------------
+// put reconstructed tracks into the event record
+//-----------------------------------------------------------------------------
+  END:;
+    int    nseeds(0);// = outseeds->size();
+    for(auto const& hel : _hels ) {
+      nseeds += helcols[hel]->size();
+	// set the flag here: This should be set on initialization FIXME!
+      for(auto & helix : *helcols[hel] ) {
+	helix._status.merge(TrkFitFlag::CPRHelix);
+      }
 
-      //      HelixSeed          helix_seed;
-      std::vector<HelixSeed>          helix_seed_vec;
-      
+      event.put(std::move(helcols[hel]),Helicity::name(hel));
+    }   
+    // event.put(std::move(outseeds));
+//-----------------------------------------------------------------------------
+// filtering
+//-----------------------------------------------------------------------------
+    if (_useAsFilter == 0) return true;
+    else                   return (nseeds >  0);
+ }
+
+//-----------------------------------------------------------------------------
+// helix search in the time cluster IPeak. HfResult holds the state of the
+// search; the module itself is only read, so different time clusters can be
+// searched concurrently, each with its own HfResult
+//-----------------------------------------------------------------------------
+  void CalHelixFinder::findHelices(int IPeak, CalHelixFinderData& HfResult, TimeClusterResult_t& Result) {
+
+    const TimeCluster* tc = &_timeclcol->at(IPeak);
+
+    Result.nGoodHits = goodHitsTimeCluster(tc);
+    Result.indexBest = -1;
+    Result.seeds.clear();
+
+    if (Result.nGoodHits < _minNHitsTimeCluster)                return;
 //-----------------------------------------------------------------------------
 // create track definitions for the helix fit from this initial information
 // track fitting objects for this peak
 //-----------------------------------------------------------------------------
-      _hfResult.clearTempVariables();//clearTimeClusterInfo();
-
-      _hfResult._timeCluster    = tc;
-      _hfResult._timeClusterPtr = art::Ptr<mu2e::TimeCluster>(_timeclcolH,ipeak);
+    HfResult.clearTempVariables();//clearTimeClusterInfo();
 
+    HfResult._timeCluster    = tc;
+    HfResult._timeClusterPtr = art::Ptr<mu2e::TimeCluster>(_timeclcolH,IPeak);
 //-----------------------------------------------------------------------------
 // fill the face-order hits collector
 //-----------------------------------------------------------------------------
-      _hfinder.fillFaceOrderedHits(_hfResult);
+    _hfinder.fillFaceOrderedHits(HfResult);
 //-----------------------------------------------------------------------------
 // Step 1: now loop over the two possible helicities. 
 //         Find initial helical approximation of a track for both hypothesis
 //-----------------------------------------------------------------------------
-      for (size_t i=0; i<_hels.size(); ++i){
-//-----------------------------------------------------------------------------
-// create track definitions for the helix fit from this initial information
-// track fitting objects for this peak
-//-----------------------------------------------------------------------------
-	CalHelixFinderData tmpResult(_hfResult);
-	tmpResult.clearHelixInfo();
+    for (size_t i=0; i<_hels.size(); ++i){
+      CalHelixFinderData tmpResult(HfResult);
+      tmpResult.clearHelixInfo();
 
-	tmpResult._helicity       = _hels[i];
+      tmpResult._helicity       = _hels[i];
 
-	int rc = _hfinder.findHelix(tmpResult);
-	
-	if (!rc)                         continue;
-	HelixSeed     tmp_helix_seed;
+      int rc = _hfinder.findHelix(tmpResult);
 
-	initHelixSeed(tmp_helix_seed, tmpResult);
-	helix_seed_vec.push_back(tmp_helix_seed);
-      }
-      
-      if (helix_seed_vec.size() == 0)                       continue;
-      
+      if (!rc)                         continue;
+      HelixSeed     tmp_helix_seed;
+
+      initHelixSeed(tmp_helix_seed, tmpResult);
+      Result.seeds.push_back(tmp_helix_seed);
+    }
+
+    if (Result.seeds.size() == 0)                               return;
 //-----------------------------------------------------------------------------
 // now select the best helix to avoid duplicates
 //-----------------------------------------------------------------------------
-      int    index_best(-1);
-      pickBestHelix(helix_seed_vec, index_best);
-      
-//-----------------------------------------------------------------------------
-// fill seed information
-//-----------------------------------------------------------------------------
-      if ( (index_best>=0) && (index_best < 2) ){
-	Helicity              hel_best = helix_seed_vec[index_best]._helix._helicity;
-	HelixSeedCollection*  hcol     = helcols[hel_best].get();
-	helix_seed_vec[index_best]._status.merge(TrkFitFlag::helixOK);
-	hcol->push_back(helix_seed_vec[index_best]);
-      } else if (index_best == 2){//both helices need to be saved
-	
-	for (unsigned k=0; k<_hels.size(); ++k){
-	  helix_seed_vec[k]._status.merge(TrkFitFlag::helixOK);
-	  Helicity              hel_best = helix_seed_vec[k]._helix._helicity;
-	  HelixSeedCollection*  hcol     = helcols[hel_best].get();
-	  hcol->push_back(helix_seed_vec[k]);
-	}
-      }
+    pickBestHelix(Result.seeds, Result.indexBest);
+  }
 
-      // helix_seed_vec[index_best]._status.merge(TrkFitFlag::helixOK);
-      // outseeds->push_back(helix_seed_vec[index_best]);
-      if (_diagLevel > 0) {
 //--------------------------------------------------------------------------------
 // fill diagnostic information
 //--------------------------------------------------------------------------------
-	int             nhitsMin(15);
-	double          mm2MeV = (3/10.)*_bz0;
-
-	int loc = _data.nseeds[0];
-	if (loc < _data.maxSeeds()) {
-	  int nhits          = helix_seed_vec[index_best]._hhits.size();
-	  _data.ntclhits[loc]= nGoodTClusterHits;
-	  _data.nhits[loc]   = nhits;
-	  _data.radius[loc]  = helix_seed_vec[index_best].helix().radius();
-	  _data.pT[loc]      = mm2MeV*_data.radius[loc];
-	  _data.p[loc]       = _data.pT[loc]/std::cos( std::atan(helix_seed_vec[index_best].helix().lambda()/_data.radius[loc]));
-
-	  _data.chi2XY[loc]   = _hfResult._sxy.chi2DofCircle();
-	  _data.chi2ZPhi[loc] = _hfResult._szphi.chi2DofLine();
-
-	  _data.nseeds[0]++;
-	  _data.good[loc] = 0;
-	  if (nhits >= nhitsMin) {
-	    _data.nseeds[1]++;
-	    _data.good[loc] = 1;
-	  }
-	  _data.nStationPairs[loc] = _hfResult._diag.nStationPairs;
+  void CalHelixFinder::fillDiagnostics(CalHelixFinderData& HfResult, TimeClusterResult_t& Result) {
+    const char*     oname = "CalHelixFinder::fillDiagnostics";
+    int             nhitsMin(15);
+    double          mm2MeV = (3/10.)*_bz0;
+
+    int loc = _data.nseeds[0];
+    if (loc < _data.maxSeeds()) {
+      int nhits          = Result.seeds[Result.indexBest]._hhits.size();
+      _data.ntclhits[loc]= Result.nGoodHits;
+      _data.nhits[loc]   = nhits;
+      _data.radius[loc]  = Result.seeds[Result.indexBest].helix().radius();
+      _data.pT[loc]      = mm2MeV*_data.radius[loc];
+      _data.p[loc]       = _data.pT[loc]/std::cos( std::atan(Result.seeds[Result.indexBest].helix().lambda()/_data.radius[loc]));
+
+      _data.chi2XY[loc]   = HfResult._sxy.chi2DofCircle();
+      _data.chi2ZPhi[loc] = HfResult._szphi.chi2DofLine();
+
+      _data.nseeds[0]++;
+      _data.good[loc] = 0;
+      if (nhits >= nhitsMin) {
+        _data.nseeds[1]++;
+        _data.good[loc] = 1;
+      }
+      _data.nStationPairs[loc] = HfResult._diag.nStationPairs;
 
-	  _data.dr           [loc] = _hfResult._diag.dr;
-	  _data.shmeanr      [loc] = _hfResult._diag.straw_mean_radius;
-	  _data.chi2d_helix  [loc] = _hfResult._diag.chi2d_helix;
-	  if (_hfResult._diag.chi2d_helix>3) printf("[%s] : chi2Helix = %10.3f event number %8i\n", oname,_hfResult._diag.chi2d_helix,_iev);
+      _data.dr           [loc] = HfResult._diag.dr;
+      _data.shmeanr      [loc] = HfResult._diag.straw_mean_radius;
+      _data.chi2d_helix  [loc] = HfResult._diag.chi2d_helix;
+      if (HfResult._diag.chi2d_helix>3) printf("[%s] : chi2Helix = %10.3f event number %8i\n", oname,HfResult._diag.chi2d_helix,_iev);
 //-----------------------------------------------------------------------------
 // info of the track candidate after the first loop with findtrack on CalHelixFinderAlg::doPatternRecognition
 //-----------------------------------------------------------------------------
-	  _data.loopId       [loc] = _hfResult._diag.loopId_4;
-	  if (_hfResult._diag.loopId_4 == 1) {
-	    _data.chi2d_loop0       [loc] = _hfResult._diag.chi2_dof_circle_12;
-	    _data.chi2d_line_loop0  [loc] = _hfResult._diag.chi2_dof_line_13;
-	    _data.npoints_loop0     [loc] = _hfResult._diag.n_active_11;
+      _data.loopId       [loc] = HfResult._diag.loopId_4;
+      if (HfResult._diag.loopId_4 == 1) {
+        _data.chi2d_loop0       [loc] = HfResult._diag.chi2_dof_circle_12;
+        _data.chi2d_line_loop0  [loc] = HfResult._diag.chi2_dof_line_13;
+        _data.npoints_loop0     [loc] = HfResult._diag.n_active_11;
 
-	  }
-	  if (_hfResult._diag.loopId_4 == 2){
-	    _data.chi2d_loop1       [loc] = _hfResult._diag.chi2_dof_circle_12;
-	    _data.chi2d_line_loop1  [loc] = _hfResult._diag.chi2_dof_line_13;
-	    _data.npoints_loop1     [loc] = _hfResult._diag.n_active_11;
-	  }
+      }
+      if (HfResult._diag.loopId_4 == 2){
+        _data.chi2d_loop1       [loc] = HfResult._diag.chi2_dof_circle_12;
+        _data.chi2d_line_loop1  [loc] = HfResult._diag.chi2_dof_line_13;
+        _data.npoints_loop1     [loc] = HfResult._diag.n_active_11;
+      }
 
 //--------------------------------------------------------------------------------
 // info of the track candidate during the CAlHelixFinderAlg::findTrack loop
 //--------------------------------------------------------------------------------
-	  int   counter(0);
-	  for (unsigned i=0; i<_hfResult._hitsUsed.size(); ++i){
-	    if (_hfResult._hitsUsed[i] != 1)           continue;
-	    ++counter;
-	  }
-	  // for (int f=0; f<StrawId::_ntotalfaces; ++f){
-	  //   FaceZ_t* facez     = &_hfResult._oTracker[f];
-	  //   for (int p=0; p<FaceZ_t::kNPanels; ++p){//for (int p=0; p<CalHelixFinderData::kNTotalPanels; ++p){
-	  // 	PanelZ_t* panelz = &facez->panelZs[p];//&_hfResult._oTracker[p];
-	  // 	int       nhits  = panelz->fNHits;
-	  // 	if (nhits == 0)                                  continue;
-	      
-	  // 	for (int i=0; i<nhits; ++i){   
-	  // 	  //		  ComboHit*	hit = &panelz->_chHitsToProcess.at(i);
-	  // 	  int index = facez->evalUniqueHitIndex(f,p,i);//p*CalHelixFinderData::kNMaxHitsPerPanel + i;
-	  // 	  if (_hfResult._hitsUsed[index] != 1)           continue;
-		
-	  // 	  // double   dzFromSeed = hit->_dzFromSeed;     //distance form the hit used to seed the 3D-search
-	  // 	  // double   drFromPred = hit->_drFromPred;     //distance from prediction
-	  // 	  // _data.hitDzSeed[loc][counter] = dzFromSeed;
-	  // 	  // _data.hitDrPred[loc][counter] = drFromPred;
-	  // 	  ++counter;
-	  // 	}//end loop over the hits within a panel
-	  //   }//end panels loop
-	  // }//end faces loop
-	}
-	else {
-	  printf(" N(seeds) > %i, IGNORE SEED\n",_data.maxSeeds());
-	}
+      int   counter(0);
+      for (unsigned i=0; i<HfResult._hitsUsed.size(); ++i){
+        if (HfResult._hitsUsed[i] != 1)           continue;
+        ++counter;
       }
-      
     }
-//--------------------------------------------------------------------------------
-// fill histograms
-//--------------------------------------------------------------------------------
-    if (_diagLevel > 0) _hmanager->fillHistograms(&_data);
-//-----------------------------------------------------------------------------
-// put reconstructed tracks into the event record
-//-----------------------------------------------------------------------------
-  END:;
-    int    nseeds(0);// = outseeds->size();
-    for(auto const& hel : _hels ) {
-      nseeds += helcols[hel]->size();
-	// set the flag here: This should be set on initialization FIXME!
-      for(auto & helix : *helcols[hel] ) {
-	helix._status.merge(TrkFitFlag::CPRHelix);
-      }
-
-      event.put(std::move(helcols[hel]),Helicity::name(hel));
-    }   
-    // event.put(std::move(outseeds));
-//-----------------------------------------------------------------------------
-// filtering
-//-----------------------------------------------------------------------------
-    if (_useAsFilter == 0) return true;
-    else                   return (nseeds >  0);
- }
+    else {
+      printf(" N(seeds) > %i, IGNORE SEED\n",_data.maxSeeds());
+    }
+  }
 
 //-----------------------------------------------------------------------------
 //
@@ -469,9 +480,9 @@ namespace mu2e {
     HelSeed._helix._rcent    = center.perp();
     HelSeed._helix._fcent    = center.phi();
     HelSeed._helix._radius   = helixRadius;
-    HelSeed._helix._lambda   = 1./dfdz*_hfinder._dfdzsign;
+    HelSeed._helix._lambda   = 1./dfdz*HfResult._dfdzsign;
 
-    HelSeed._helix._fz0      = phi0 - M_PI/2.*_hfinder._dfdzsign -z0*hel->omega()/hel->tanDip() ;
+    HelSeed._helix._fz0      = phi0 - M_PI/2.*HfResult._dfdzsign -z0*hel->omega()/hel->tanDip() ;
 
     HelSeed._helix._helicity = HfResult._helicity;//_dfdzsign > 0 ? Helicity::poshel : Helicity::neghel;
 
@@ -29,6 +29,7 @@
 
 // diagnostics
 #include "Offline/CalPatRec/inc/DeltaFinder2_types.hh"
+#include "Offline/GeneralUtilities/inc/ObjectPool.hh"
 
 // #include "CalPatRec/inc/LsqSums2.hh"
 #include "Offline/Mu2eUtilities/inc/ModuleHistToolBase.hh"
@@ -107,6 +108,7 @@ namespace mu2e {
     float                               _tdbuff; // following Dave - time division buffer
     
     DeltaFinder2Types::Data_t            _data;              // all data used
+    ObjectPool<DeltaSeed>                _seedPool;          // storage of the seeds, reset every event
     int                                 _testOrderPrinted;
 
     double                              _stationToCaloTOF[2][20];
@@ -408,7 +410,7 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
 // new hit needs to be added, create a new "fake" seed for that
 //-----------------------------------------------------------------------------
-	    if (new_seed == NULL) new_seed = new DeltaSeed();
+	    if (new_seed == NULL) new_seed = _seedPool.get();
 	    
 	    new_seed->panelz[face]  = panelz;
 	    new_seed->fNHitsTot    += 1;
@@ -577,11 +579,9 @@ namespace mu2e {
     for (int is=0; is<kNStations; is++) {
       _data.nseeds_per_station[is] = 0;
 
-      for (auto ds=_data.seedHolder[is].begin(); ds!=_data.seedHolder[is].end(); ds++) {
-	delete *ds;
-      }
       _data.seedHolder[is].clear();
     }
+    _seedPool.reset();
 
     _data.deltaCandidateHolder.clear();
 //-----------------------------------------------------------------------------
@@ -951,7 +951,7 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
 // new seed
 //-----------------------------------------------------------------------------
-	      DeltaSeed* seed = new DeltaSeed();
+	      DeltaSeed* seed = _seedPool.get();
 	      seed->fStation             =  Station;
 	      seed->fNumber              =  _data.seedHolder[Station].size();
 	      seed->fType                = 10*Face+f2;
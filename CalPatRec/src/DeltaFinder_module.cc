@@ -30,6 +30,7 @@
 // diagnostics
 
 #include "Offline/CalPatRec/inc/DeltaFinder_types.hh"
+#include "Offline/GeneralUtilities/inc/ObjectPool.hh"
 
 // #include "CalPatRec/inc/LsqSums2.hh"
 #include "Offline/Mu2eUtilities/inc/ModuleHistToolBase.hh"
@@ -108,6 +109,8 @@ namespace mu2e {
     float                               _tdbuff; // following Dave - time division buffer
 
     DeltaFinderTypes::Data_t            _data;              // all data used
+    ObjectPool<DeltaSeed>               _seedPool;          // storage of the seeds, reset every event
+    std::vector<int>                    _hitWindow;         // hits of a panel within a time window
     int                                 _testOrderPrinted;
 
     float                               _stationToCaloTOF[2][20];
@@ -358,6 +361,17 @@ namespace mu2e {
       float sigw = sh->posRes(ComboHit::wire);// shp->posRes(StrawHitPosition::wire);
       pz->fHitData.push_back(HitData_t(sh,/*shp,straw,*/sigw));
     }
+//-----------------------------------------------------------------------------
+// index the hits of each panel in time, the seed and neighbor searches
+// look only at the hits within their time windows
+//-----------------------------------------------------------------------------
+    for (int s=0; s<kNStations; ++s) {
+      for (int f=0; f<kNFaces; ++f) {
+        for (int p=0; p<kNPanelsPerFace; ++p) {
+          _data.oTracker[s][f][p].IndexHits();
+        }
+      }
+    }
 
     return 0;
   }
@@ -382,8 +396,11 @@ namespace mu2e {
 // panel and seed overlap in phi, loop over hits
 //-----------------------------------------------------------------------------
 	  // for (int l=0; l<2; ++l) {
-	    int nhits = panelz->fHitData.size();
-	    for (int h=0; h<nhits; ++h) {
+//-----------------------------------------------------------------------------
+// the time window is 1 ns wider than the cuts below, which stay as they are
+//-----------------------------------------------------------------------------
+	    panelz->HitsInTimeWindow(Delta->T0Min(Station)-1.,Delta->T0Max(Station)+_maxDriftTime+1.,_hitWindow);
+	    for (int h : _hitWindow) {
 	      const HitData_t* hd = &panelz->fHitData[h];
 	      const ComboHit*  sh = hd->fHit;
 //-----------------------------------------------------------------------------
@@ -410,7 +427,7 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
 // new hit needs to be added, create a new "fake" seed for that
 //-----------------------------------------------------------------------------
-	      if (new_seed == NULL) new_seed = new DeltaSeed();
+	      if (new_seed == NULL) new_seed = _seedPool.get();
 
 	      new_seed->panelz[face]  = panelz;
 	      new_seed->fNHitsTot    += 1;
@@ -572,11 +589,9 @@ namespace mu2e {
     for (int is=0; is<kNStations; is++) {
       _data.nseeds_per_station[is] = 0;
 
-      for (auto ds=_data.seedHolder[is].begin(); ds!=_data.seedHolder[is].end(); ds++) {
-        delete *ds;
-      }
       _data.seedHolder[is].clear();
     }
+    _seedPool.reset();
 
     _data.deltaCandidateHolder.clear();
 //-----------------------------------------------------------------------------
@@ -887,8 +902,9 @@ namespace mu2e {
     float maxrad         = minrad;
 
     // for (int l=0; l<2; ++l) {
-    int nh = panelz->fHitData.size();
-    for (int h=0; h<nh; ++h) {
+    vector<int> window;
+    panelz->HitsInTimeWindow(Seed->T0Min()-1.,Seed->T0Max()+_maxDriftTime+1.,window);
+    for (int h : window) {
       HitData_t* hd  = &panelz->fHitData[h];
       if (hd == hd1) continue ;
       const ComboHit* sh = hd->fHit;
@@ -996,8 +1012,12 @@ namespace mu2e {
             // panels do overlap
             //-----------------------------------------------------------------------------
             // for (int l2=0; l2<2;++l2) {
-            int hitsize2 = panelz2->fHitData.size();
-            for (int h2=0; h2<hitsize2;++h2) {
+            //-----------------------------------------------------------------------------
+            // only the hits within _maxDriftTime of the first one can make a seed,
+            // the time window is 1 ns wider than the cut below
+            //-----------------------------------------------------------------------------
+            panelz2->HitsInTimeWindow(ct-_maxDriftTime-1.,ct+_maxDriftTime+1.,_hitWindow);
+            for (int h2 : _hitWindow) {
               HitData_t* hd2 = &panelz2->fHitData[h2];
               const ComboHit* sh2 = hd2->fHit;
               //                  if (sh2->energyDep() >= _maxElectronHitEnergy)  continue;
@@ -1034,7 +1054,7 @@ namespace mu2e {
               //-----------------------------------------------------------------------------
               // new seed
               //-----------------------------------------------------------------------------
-              DeltaSeed* seed = new DeltaSeed();
+              DeltaSeed* seed = _seedPool.get();
               seed->fStation             =  Station;
               seed->fNumber              =  _data.seedHolder[Station].size();
               seed->fType                = 10*Face+f2;
@@ -5,6 +5,9 @@
 
 #include "Offline/CalPatRec/inc/DeltaFinder_types.hh"
 
+#include <algorithm>
+#include <numeric>
+
 namespace mu2e {
   namespace DeltaFinderTypes {
     
@@ -52,5 +55,25 @@ namespace mu2e {
 
       return 0;
     }
+
+//-----------------------------------------------------------------------------
+    void PanelZ_t::IndexHits() {
+      int nh = fHitData.size();
+      fTimeOrder.resize(nh);
+      std::iota(fTimeOrder.begin(),fTimeOrder.end(),0);
+      std::stable_sort(fTimeOrder.begin(),fTimeOrder.end(),
+                       [this](int I1, int I2) { return fHitData[I1].fHit->time() < fHitData[I2].fHit->time(); });
+      fTime.resize(nh);
+      for (int i=0; i<nh; i++) fTime[i] = fHitData[fTimeOrder[i]].fHit->time();
+    }
+
+//-----------------------------------------------------------------------------
+    void PanelZ_t::HitsInTimeWindow(double TMin, double TMax, std::vector<int>& List) const {
+      List.clear();
+      auto first = std::lower_bound(fTime.begin(),fTime.end(),TMin);
+      auto last  = std::upper_bound(first,fTime.end(),TMax);
+      for (auto it=first; it!=last; ++it) List.push_back(fTimeOrder[it-fTime.begin()]);
+      std::sort(List.begin(),List.end());
+    }
   }
 }
@@ -2,13 +2,17 @@
 #define CaloCluster_ClusterFinder_HH_
 //
 // Class to find cluster of simply connected crystals
+//
+// The hits are indexed by crystal in flat arrays, and referred to by their slot, i.e. their position in
+// the list of hits given to fill(). The neighbors are read from the calorimeter flat neighbor table, and
+// the visited crystals are stamped with the cluster number, so nothing is allocated or cleared per cluster.
+// The buffers are kept from one event to the next.
 // 
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
+#include "Offline/CalorimeterGeom/inc/CaloNeighborTable.hh"
 
 #include <vector>
-#include <queue>
-#include <list>
 
 namespace mu2e {
 
@@ -16,28 +20,83 @@ namespace mu2e {
     class ClusterFinder 
     {
          public:
-             using CaloCrystalList = std::list<const CaloHit*>;
-             using CaloCrystalVec  = std::vector<const CaloHit*>;
-
-             ClusterFinder(const Calorimeter&, const CaloHit*, double, double, bool addSecondRing);  
+             ClusterFinder(double ExpandCut, bool addSecondRing);  
              
-             void                   formCluster(std::vector<CaloCrystalList>&);
-             const CaloCrystalList& clusterList() const {return clusterList_;}             
+             // index the hits hits[hitIdx[slot]] by crystal, the hits of a crystal keep the order of hitIdx
+             void           fill(const Calorimeter&, const CaloHitCollection& hits, const std::vector<int>& hitIdx);
+
+             // add to the seed the unused hits of the neighboring crystals for which accept(slot) is true, and expand
+             // from the crystals with a hit above ExpandCut. The slots are in the order they were added, seed first
+             template <class Accept> 
+             void           formCluster(int seedSlot, Accept accept, std::vector<int>& clusterSlots);
+
+             unsigned       nSlots()           const {return hitIdx_.size();}
+             int            hitIndex(int slot) const {return hitIdx_[slot];}
+             const CaloHit& hit(int slot)      const {return (*hits_)[hitIdx_[slot]];}
+             bool           isUsed(int slot)   const {return isUsed_[slot];}
+             void           setUsed(int slot)        {isUsed_[slot] = 1;}
+
+             // slots of the hits of a crystal
+             int            nCrystal()                   const {return crystalOffset_.size()-1;}
+             const int*     crystalBegin(int crystalId)  const {return crystalSlots_.data() + crystalOffset_[crystalId];}
+             const int*     crystalEnd(int crystalId)    const {return crystalSlots_.data() + crystalOffset_[crystalId+1];}
 
 
          private:
-             const Calorimeter*   cal_;
-             const CaloHit*       crystalSeed_;
-             double               seedTime_;
-             CaloCrystalList      clusterList_;
-             std::queue<int>      crystalToVisit_;
-             std::vector<bool>    isVisited_; 
-             double               deltaTime_; 
-             double               ExpandCut_;
-             bool                 addSecondRing_;
+             void           newEpoch();
+
+             const CaloNeighborTable*  neighbors_;
+             const CaloHitCollection*  hits_;
+             double                    ExpandCut_;
+             bool                      addSecondRing_;
+             std::vector<int>          hitIdx_;
+             std::vector<char>         isUsed_;
+             std::vector<unsigned>     crystalOffset_;   // slots of crystal i: crystalSlots_[crystalOffset_[i]] ... [crystalOffset_[i+1]-1]
+             std::vector<int>          crystalSlots_;
+             std::vector<unsigned>     visited_;         // epoch of the last visit of each crystal
+             unsigned                  epoch_;
+             std::vector<int>          crystalToVisit_;  // queue of crystals to visit, read from the front
     };
 
 
+    template <class Accept> 
+    void ClusterFinder::formCluster(int seedSlot, Accept accept, std::vector<int>& clusterSlots)
+    {
+        newEpoch();
+        clusterSlots.clear();
+        crystalToVisit_.clear();
+
+        int seedId = hit(seedSlot).crystalID();
+        isUsed_[seedSlot] = 1;
+        clusterSlots.push_back(seedSlot);
+        visited_[seedId] = epoch_;
+        crystalToVisit_.push_back(seedId);
+
+        for (size_t ivisit=0; ivisit < crystalToVisit_.size(); ++ivisit)
+        {
+            int visitId = crystalToVisit_[ivisit];
+            const int* endNeighbors = neighbors_->end(visitId, addSecondRing_);
+
+            for (const int* it = neighbors_->begin(visitId); it != endNeighbors; ++it)
+            {
+                int iId = *it;
+                if (visited_[iId] == epoch_) continue;
+                visited_[iId] = epoch_;
+
+                bool expand(false);
+                for (unsigned j=crystalOffset_[iId]; j<crystalOffset_[iId+1]; ++j)
+                {
+                    int slot = crystalSlots_[j];
+                    if (isUsed_[slot] || !accept(slot)) continue;
+                    isUsed_[slot] = 1;
+                    clusterSlots.push_back(slot);
+                    if (hit(slot).energyDep() > ExpandCut_) expand = true;
+                }
+                if (expand) crystalToVisit_.push_back(iId);
+            }
+        }
+    }
+
 }
 
 #endif
@@ -5,6 +5,7 @@
 #include "cetlib_except/exception.h"
 #include "fhiclcpp/types/Atom.h"
 
+#include "Offline/CaloCluster/inc/ClusterFinder.hh"
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
 #include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/GeometryService/inc/GeometryService.hh"
@@ -13,10 +14,8 @@
 
 #include <iostream>
 #include <string>
-#include <list>
-#include <set>
 #include <vector>
-#include <queue>
+#include <algorithm>
 
 
 namespace mu2e {
@@ -45,7 +44,11 @@ namespace mu2e {
           ExpandCut_     (config().ExpandCut()),
           deltaTime_     (config().deltaTime()),
           extendSearch_  (config().extendSearch()),
-          diagLevel_     (config().diagLevel())
+          diagLevel_     (config().diagLevel()),
+          finder_        (ExpandCut_, extendSearch_),
+          hits_          (),
+          clusterSlots_  (),
+          clusterList_   ()
         {
            produces<CaloClusterCollection>();
         }
@@ -61,6 +64,10 @@ namespace mu2e {
         double            deltaTime_;
         bool              extendSearch_;
         int               diagLevel_;
+        ClusterFinder     finder_;
+        std::vector<int>  hits_;
+        std::vector<int>  clusterSlots_;
+        std::vector<int>  clusterList_;
 
         void makeClusters(CaloClusterCollection&, const art::Handle<CaloHitCollection>&);
         void fillCluster(const Calorimeter&, const art::Handle<CaloHitCollection>&, const CaloHitCollection&,
@@ -87,72 +94,40 @@ namespace mu2e {
       const CaloHitCollection& caloHits(*caloHitsHandle);
       if (caloHits.empty()) return;
 
-      std::vector<int> hits;
-      hits.reserve(caloHits.size());
+      //time ordered hits, indexed by crystal. The slot of a hit is its position in the time ordered list
+      std::vector<int>& hits = hits_;
+      hits.clear();
       for (unsigned i=0;i<caloHits.size();++i) if (caloHits[i].energyDep() > EnoiseCut_) hits.emplace_back(i);      
       auto functorTime = [&caloHits](int a, int b) {return caloHits[a].time() < caloHits[b].time();};
       std::sort(hits.begin(),hits.end(),functorTime);
+      finder_.fill(cal, caloHits, hits);
 
-      auto iterSeed = hits.begin();
-      while (iterSeed != hits.end())
+      for (int iSeed=0; iSeed < int(hits.size()); ++iSeed)
       {
           //find the first hit above the energy threshold, and the last hit within the required time window
-          const CaloHit& hitSeed = caloHits[*iterSeed];
-          if (*iterSeed==-1 || hitSeed.energyDep()< EminSeed_) {++iterSeed; continue;}
+          const CaloHit& hitSeed = caloHits[hits[iSeed]];
+          if (finder_.isUsed(iSeed) || hitSeed.energyDep()< EminSeed_) continue;
           double timeStart = hitSeed.time();
 
           //find the range around the seed time to search for other hits to form clusters
-          auto iterStart(iterSeed), iterStop(iterSeed);
-          while (iterStop  != hits.end()   && (*iterStop==-1  || caloHits[*iterStop].time() - timeStart < deltaTime_))  ++iterStop;
-          while (iterStart != hits.begin() && (*iterStart==-1 || timeStart - caloHits[*iterStart].time() < deltaTime_)) --iterStart;
-          ++iterStart; 
+          int iStart(iSeed), iStop(iSeed);
+          while (iStop  != int(hits.size()) && (finder_.isUsed(iStop)  || caloHits[hits[iStop]].time() - timeStart < deltaTime_))  ++iStop;
+          while (iStart != 0                && (finder_.isUsed(iStart) || timeStart - caloHits[hits[iStart]].time() < deltaTime_)) --iStart;
+          ++iStart; 
 
           //start the clustering algorithm for the hits between iStart and iStop
-          std::queue<int> crystalToVisit;
-          std::vector<bool> isVisited(cal.nCrystal()); 
-
-          //put the first hit in the cluster list
-          std::vector<int> clusterList{*iterSeed};
-          int seedId = caloHits[*iterSeed].crystalID();
-          crystalToVisit.push(seedId);
-          *iterSeed=-1;
-
-          // loop until all seeds are processed
-          while (!crystalToVisit.empty())
-          {            
-              int visitId = crystalToVisit.front();
-              isVisited[visitId]=true;
-
-              std::vector<int>  neighborsId = cal.crystal(visitId).neighbors();
-              if (extendSearch_) std::copy(cal.nextNeighbors(visitId).begin(), cal.nextNeighbors(visitId).end(), std::back_inserter(neighborsId));
-
-              for (const auto& iId : neighborsId)
-              {
-                  if (isVisited[iId]) continue;
-                  isVisited[iId] = true;
-
-                  //loop over the caloHits, check if one is in the neighbor list and add it to the cluster
-                  for (auto it=iterStart; it != iterStop; ++it)
-                  {
-                      if (*it==-1) continue;
-                      if (caloHits[*it].crystalID() != iId) continue;
-
-                      if (caloHits[*it].energyDep() > ExpandCut_) crystalToVisit.push(iId);
-                      clusterList.push_back(*it);
-                      *it = -1;
-                  }
-               }
-               crystalToVisit.pop();                 
-           }
-
-           auto functorEnergy = [&caloHits](int a, int b) {return caloHits[a].energyDep() > caloHits[b].energyDep();};
-           std::sort(clusterList.begin(),clusterList.end(),functorEnergy);
-
-           fillCluster(cal, caloHitsHandle, caloHits, clusterList, caloClusters );
-
-           ++iterSeed;
-        }      
-   }
+          auto inWindow = [iStart,iStop](int slot) {return slot >= iStart && slot < iStop;};
+          finder_.formCluster(iSeed, inWindow, clusterSlots_);
+
+          clusterList_.clear();
+          for (auto slot : clusterSlots_) clusterList_.push_back(hits[slot]);
+
+          auto functorEnergy = [&caloHits](int a, int b) {return caloHits[a].energyDep() > caloHits[b].energyDep();};
+          std::sort(clusterList_.begin(),clusterList_.end(),functorEnergy);
+
+          fillCluster(cal, caloHitsHandle, caloHits, clusterList_, caloClusters );
+      }      
+  }
 
    
   //----------------------------------------------------------------------------------------------------------
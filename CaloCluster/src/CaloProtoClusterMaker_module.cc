@@ -13,6 +13,8 @@
 // Note 1: Seed do not need to be ordered by energy
 // Note 2: The cluster time is taken as that of the most energetic hit -> potential for improvement (have fun)
 // Note 3: Several optimization obscured the code for little gain, so I sticked to simplicity
+// Note 4: The hits are indexed by crystal once per event in the ClusterFinder, which keeps its buffers
+//         from one event to the next. The seeds are taken in the order of the hit collection
 //
 
 #include "art/Framework/Core/EDProducer.h"
@@ -31,9 +33,9 @@
 
 #include <iostream>
 #include <string>
-#include <list>
-#include <set>
 #include <vector>
+#include <algorithm>
+#include <limits>
 
 
 namespace mu2e {
@@ -41,9 +43,6 @@ namespace mu2e {
   class CaloProtoClusterMaker : public art::EDProducer
   {
      public:
-        typedef std::vector<const CaloHit*>  CaloCrystalVec;
-        typedef std::list<const CaloHit*>    CaloCrystalList;
-        
         struct Config
         {
             using Name    = fhicl::Name;
@@ -67,7 +66,11 @@ namespace mu2e {
           addSecondRing_   (config().addSecondRing()),
           timeCut_         (config().timeCut()),
           deltaTime_       (config().deltaTime()),
-          diagLevel_       (config().diagLevel())
+          diagLevel_       (config().diagLevel()),
+          finder_          (ExpandCut_, addSecondRing_),
+          hitIdx_          (),
+          clusterSlots_    (),
+          clusterHits_     ()
         {
            produces<CaloProtoClusterCollection>("main");
            produces<CaloProtoClusterCollection>("split");
@@ -84,11 +87,16 @@ namespace mu2e {
         double                               timeCut_;
         double                               deltaTime_;
         int                                  diagLevel_;
+        ClusterFinder                        finder_;
+        std::vector<int>                     hitIdx_;
+        std::vector<int>                     clusterSlots_;
+        std::vector<int>                     clusterHits_;
 
         void makeProtoClusters (CaloProtoClusterCollection&,CaloProtoClusterCollection&, const art::Handle<CaloHitCollection>&);
-        void filterByTime      (CaloCrystalList&, const std::vector<double>&);
-        void fillCluster       (CaloProtoClusterCollection&, const CaloCrystalList&,const art::Handle<CaloHitCollection>&);
-        void dump              (const std::string&, const std::vector<CaloCrystalList>&, std::set<const CaloHit*>);
+        void formCluster       (int seedSlot);
+        bool filterByTime      (const CaloHit&, const std::vector<double>&);
+        void fillCluster       (CaloProtoClusterCollection&, const std::vector<int>&,const art::Handle<CaloHitCollection>&);
+        void dump              (const std::string&, double);
   };
 
 
@@ -115,61 +123,48 @@ namespace mu2e {
       if (CaloHits.empty()) return;
 
 
-      //declare and fill the hash map crystal_id -> list of CaloHits
-      std::vector<CaloCrystalList> mainClusterList, splitClusterList, caloIdHitMap(cal.nCrystal());
-      std::set<const CaloHit*> seedList;
-      std::vector<double>      clusterTime;
-
-      //fill data structures
-      for (const auto& hit : CaloHits)
+      //index the hits passing the cuts by crystal, in the order of the collection
+      hitIdx_.clear();
+      for (unsigned i=0; i < CaloHits.size(); ++i)
       {
-          if (hit.energyDep() < EnoiseCut_ || hit.time() < timeCut_) continue;
-          caloIdHitMap[hit.crystalID()].push_back(&hit);
-          if (hit.energyDep() > EminSeed_ ) seedList.insert(&hit);
+          if (CaloHits[i].energyDep() < EnoiseCut_ || CaloHits[i].time() < timeCut_) continue;
+          hitIdx_.push_back(i);
       }
+      finder_.fill(cal, CaloHits, hitIdx_);
       
-      if (diagLevel_ > 2) dump("Init", caloIdHitMap,seedList);
+      if (diagLevel_ > 2) dump("Init", EminSeed_);
        
 
 
       //produce main clusters
-      while( !seedList.empty() )
+      std::vector<double> clusterTime;
+      for (unsigned slot=0; slot < finder_.nSlots(); ++slot)
       {
-          const CaloHit* crystalSeed = *seedList.begin();
-          ClusterFinder finder(cal, crystalSeed, deltaTime_, ExpandCut_, addSecondRing_);
-          finder.formCluster(caloIdHitMap);
-
-          mainClusterList.push_back(finder.clusterList());
-          clusterTime.push_back(crystalSeed->time());
-
-          for (const auto& hit: finder.clusterList()) seedList.erase(hit);
+          if (finder_.isUsed(slot) || finder_.hit(slot).energyDep() <= EminSeed_) continue;
+          formCluster(slot);
+          fillCluster(caloProtoClustersMain,clusterHits_,CaloHitsHandle);
+          clusterTime.push_back(finder_.hit(slot).time());
       }
  
 
-      //filter unneeded hits and fill new seeds
-      for (unsigned i=0; i < caloIdHitMap.size(); ++i ) filterByTime(caloIdHitMap[i], clusterTime);
-      for (const auto& liste: caloIdHitMap) {for (const auto& ptr : liste) seedList.insert(ptr);}
-      if (diagLevel_ > 2) dump("Post filtering", caloIdHitMap,seedList);
+      //filter unneeded hits, the remaining ones are the new seeds
+      for (unsigned slot=0; slot < finder_.nSlots(); ++slot)
+      {
+          if (!finder_.isUsed(slot) && !filterByTime(finder_.hit(slot), clusterTime)) finder_.setUsed(slot);
+      }
+      if (diagLevel_ > 2) dump("Post filtering", std::numeric_limits<double>::lowest());
 
  
  
  
       //produce split-offs clusters
-      while (!seedList.empty())
+      for (unsigned slot=0; slot < finder_.nSlots(); ++slot)
       {
-          const CaloHit* crystalSeed = *seedList.begin();
-          ClusterFinder finder(cal,crystalSeed,deltaTime_, ExpandCut_, addSecondRing_);
-
-          finder.formCluster(caloIdHitMap);
-          splitClusterList.push_back(finder.clusterList());
-
-          for (const auto& hit: finder.clusterList()) seedList.erase(hit);
+          if (finder_.isUsed(slot)) continue;
+          formCluster(slot);
+          fillCluster(caloProtoClustersSplit,clusterHits_,CaloHitsHandle);
       }
 
-      //save the main and split clusters
-      for (auto cluster : mainClusterList)  fillCluster(caloProtoClustersMain,cluster,CaloHitsHandle);
-      for (auto cluster : splitClusterList) fillCluster(caloProtoClustersSplit,cluster,CaloHitsHandle);
-
       //sort these guys
       std::sort(caloProtoClustersMain.begin(),  caloProtoClustersMain.end(), [](const CaloProtoCluster& a, const CaloProtoCluster& b) {return a.time() < b.time();});
       std::sort(caloProtoClustersSplit.begin(), caloProtoClustersSplit.end(),[](const CaloProtoCluster& a, const CaloProtoCluster& b) {return a.time() < b.time();});
@@ -184,34 +179,51 @@ namespace mu2e {
 
 
 
+  //----------------------------------------------------------------------------------------------------------
+  void CaloProtoClusterMaker::formCluster(int seedSlot)
+  {
+      double seedTime = finder_.hit(seedSlot).time();
+      auto inTime = [this,seedTime](int slot) {return std::abs(finder_.hit(slot).time() - seedTime) < deltaTime_;};
+      finder_.formCluster(seedSlot, inTime, clusterSlots_);
+
+      // last added hits first, then make sure to sort proto-cluster by energy
+      std::reverse(clusterSlots_.begin(), clusterSlots_.end());
+      std::stable_sort(clusterSlots_.begin(), clusterSlots_.end(), 
+                       [this](int lhs, int rhs) {return finder_.hit(lhs).energyDep() > finder_.hit(rhs).energyDep();});
+
+      clusterHits_.clear();
+      for (auto slot : clusterSlots_) clusterHits_.push_back(finder_.hitIndex(slot));
+  }
+
+
+
   //----------------------------------------------------------------------------------------------------------
   void CaloProtoClusterMaker::fillCluster(CaloProtoClusterCollection& caloProtoClustersColl, 
-                                          const CaloCrystalList& clusterPtrList,
+                                          const std::vector<int>& clusterHits,
                                           const art::Handle<CaloHitCollection>& CaloHitsHandle)
   {
       const CaloHitCollection& CaloHits(*CaloHitsHandle);
-      const CaloHit* CaloHitBase = &CaloHits.front();
 
       std::vector<art::Ptr<CaloHit>> caloHitsPtrVector;
       double totalEnergy(0),totalEnergyErr(0);
       //double timeW(0),timeWtot(0);
 
-      for (auto clusterPrt : clusterPtrList)
+      for (auto idx : clusterHits)
       {
-          //double weight = 1.0/clusterPrt->timeErr()/clusterPrt->timeErr();
-          //timeW    += weight*clusterPrt->time();
+          const CaloHit& hit = CaloHits[idx];
+          //double weight = 1.0/hit.timeErr()/hit.timeErr();
+          //timeW    += weight*hit.time();
           //timeWtot += weight;
 
-          totalEnergy    += clusterPrt->energyDep();
-          totalEnergyErr += clusterPrt->energyDepErr()*clusterPrt->energyDepErr();
+          totalEnergy    += hit.energyDep();
+          totalEnergyErr += hit.energyDepErr()*hit.energyDepErr();
 
-          size_t idx = (clusterPrt - CaloHitBase);
           caloHitsPtrVector.push_back(art::Ptr<CaloHit>(CaloHitsHandle,idx));
       }
 
       totalEnergyErr = sqrt(totalEnergyErr);
-      double time    = (*clusterPtrList.begin())->time();
-      double timeErr = (*clusterPtrList.begin())->timeErr();
+      double time    = CaloHits[clusterHits.front()].time();
+      double timeErr = CaloHits[clusterHits.front()].timeErr();
       //double time    = timeW/timeWtot;
       //double timeErr = 1.0/sqrt(timeWtot);
 
@@ -219,8 +231,8 @@ namespace mu2e {
 
       if (diagLevel_ > 1)
       {
-          std::cout<<"This cluster contains "<<clusterPtrList.size()<<" crystals, id= ";
-          for (auto clusterPrt : clusterPtrList) std::cout<<clusterPrt->crystalID()<<" ";
+          std::cout<<"This cluster contains "<<clusterHits.size()<<" crystals, id= ";
+          for (auto idx : clusterHits) std::cout<<CaloHits[idx].crystalID()<<" ";
           std::cout<<" with energy="<<totalEnergy<<" and time="<<time<<std::endl;;
       }
   }
@@ -229,38 +241,36 @@ namespace mu2e {
 
 
   //----------------------------------------------------------------------------------------------------------
-  void CaloProtoClusterMaker::filterByTime(CaloCrystalList& liste, const std::vector<double>& clusterTime)
+  bool CaloProtoClusterMaker::filterByTime(const CaloHit& hit, const std::vector<double>& clusterTime)
   {
-      auto it = liste.begin();
-      while (it != liste.end())
-      {
-          const CaloHit* hit = *it;
-          
-          auto itTime = clusterTime.begin();
-          while (itTime != clusterTime.end()){if ( (*itTime - hit->time()) < deltaTime_) break; ++itTime;}
-                    
-          if (itTime == clusterTime.end() ) it = liste.erase(it);
-          else ++it;
-      }
+      for (auto time : clusterTime) {if ( (time - hit.time()) < deltaTime_) return true;}
+      return false;
   }
 
 
 
   //----------------------------------------------------------------------------------------------------------
-  void CaloProtoClusterMaker::dump(const std::string& title, const std::vector<CaloCrystalList>& caloIdHitMap, 
-                                            std::set<const CaloHit*> seedList)
+  void CaloProtoClusterMaker::dump(const std::string& title, double seedEmin)
   {
       std::cout<<title<<std::endl;
       std::cout<<"Cache content"<<std::endl;
-      for (unsigned i=0;i<caloIdHitMap.size();++i)
+      for (int i=0;i<finder_.nCrystal();++i)
       {
-         if (caloIdHitMap[i].empty()) continue;
-         std::cout<<"Crystal idx "<<i<<std::endl;
-         for (auto& ptr : caloIdHitMap[i]) std::cout<<ptr<<" "<<ptr->energyDep()<<"  ";
-         std::cout<<std::endl;
+         bool hasHits(false);
+         for (const int* it = finder_.crystalBegin(i); it != finder_.crystalEnd(i); ++it)
+         {
+            if (finder_.isUsed(*it)) continue;
+            if (!hasHits) std::cout<<"Crystal idx "<<i<<std::endl;
+            hasHits = true;
+            std::cout<<&finder_.hit(*it)<<" "<<finder_.hit(*it).energyDep()<<"  ";
+         }
+         if (hasHits) std::cout<<std::endl;
       }
       std::cout<<"Seeds  "<<std::endl;
-      for (auto& ptr :seedList) std::cout<<ptr<<" ";
+      for (unsigned slot=0; slot < finder_.nSlots(); ++slot)
+      {
+         if (!finder_.isUsed(slot) && finder_.hit(slot).energyDep() > seedEmin) std::cout<<&finder_.hit(slot)<<" ";
+      }
       std::cout<<std::endl;
   }
  
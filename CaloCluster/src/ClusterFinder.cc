@@ -1,73 +1,49 @@
 #include "Offline/CaloCluster/inc/ClusterFinder.hh"
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
-#include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
 
-#include <iostream>
 #include <vector>
 #include <algorithm>
 
 
 namespace mu2e {
 
-	ClusterFinder::ClusterFinder(const Calorimeter& cal, const CaloHit* crystalSeed, double deltaTime, double ExpandCut, bool addSecondRing) : 
-	  cal_(&cal), crystalSeed_(crystalSeed), seedTime_(crystalSeed->time()), clusterList_(), crystalToVisit_(), isVisited_(cal.nCrystal()),
-	  deltaTime_(deltaTime), ExpandCut_(ExpandCut), addSecondRing_(addSecondRing)
+	ClusterFinder::ClusterFinder(double ExpandCut, bool addSecondRing) : 
+	  neighbors_(nullptr), hits_(nullptr), ExpandCut_(ExpandCut), addSecondRing_(addSecondRing), 
+          hitIdx_(), isUsed_(), crystalOffset_(), crystalSlots_(), visited_(), epoch_(0), crystalToVisit_()
 	{}
        
 
-	void ClusterFinder::formCluster(std::vector<CaloCrystalList>& idHitVec)  
+	void ClusterFinder::fill(const Calorimeter& cal, const CaloHitCollection& hits, const std::vector<int>& hitIdx)  
 	{ 
-	    std::fill(isVisited_.begin(), isVisited_.end(), false);
+	    neighbors_ = &cal.neighborTable();
+	    hits_      = &hits;
+	    hitIdx_.assign(hitIdx.begin(), hitIdx.end());
+	    isUsed_.assign(hitIdx_.size(), 0);
 
-	    clusterList_.clear();            
-	    clusterList_.push_front(crystalSeed_);
-	    crystalToVisit_.push(crystalSeed_->crystalID());  
+	    // counting sort of the slots by crystal, crystalOffset_[i] is used as the fill position of crystal i
+	    // and shifted back to the start afterwards
+	    unsigned nCrystal = cal.nCrystal();
+	    crystalOffset_.assign(nCrystal+1, 0);
+	    for (auto idx : hitIdx_) ++crystalOffset_[hits[idx].crystalID()+1];
+	    for (unsigned i=0; i<nCrystal; ++i) crystalOffset_[i+1] += crystalOffset_[i];
 
-	    CaloCrystalList& liste = idHitVec[crystalSeed_->crystalID()];	    
-            liste.erase(std::find(liste.begin(), liste.end(), crystalSeed_));
+	    crystalSlots_.resize(hitIdx_.size());
+	    for (unsigned slot=0; slot<hitIdx_.size(); ++slot) crystalSlots_[crystalOffset_[hits[hitIdx_[slot]].crystalID()]++] = slot;
+	    for (unsigned i=nCrystal; i>0; --i) crystalOffset_[i] = crystalOffset_[i-1];
+	    crystalOffset_[0] = 0;
 
-	    while (!crystalToVisit_.empty())
-	    {            
-		 int visitId         = crystalToVisit_.front();
-		 isVisited_[visitId] = true;
+	    if (visited_.size() != nCrystal) {visited_.assign(nCrystal, 0); epoch_ = 0;}
+	}
 
-		 std::vector<int>  neighborsId = cal_->crystal(visitId).neighbors();
-                 if (addSecondRing_) neighborsId.insert(neighborsId.end(), cal_->nextNeighbors(visitId).begin(), cal_->nextNeighbors(visitId).end());
-		 
-                 for (auto& iId : neighborsId)
-		 {               
-		     if (isVisited_[iId]) continue;
-		     isVisited_[iId] = true;
-		     CaloCrystalList& list = idHitVec[iId];
-		     
-                     auto it=list.begin();
-		     while(it != list.end())
-		     {
-			 CaloHit const* hit = *it;
-			 if (std::abs(hit->time() - seedTime_) < deltaTime_)
-			 { 
-			     if (hit->energyDep() > ExpandCut_) crystalToVisit_.push(iId);
-			     clusterList_.push_front(hit);
-			     it = list.erase(it);   
-			 } 
-			 else ++it;
-		     } 
-                 }
 
-                 crystalToVisit_.pop();                 
-            }
-
-	    // make sure to sort proto0cluster by energy
-	    clusterList_.sort([](const CaloHit* lhs, const CaloHit* rhs) {return lhs->energyDep() > rhs->energyDep();});
-       } 
+	void ClusterFinder::newEpoch()  
+	{ 
+	    if (++epoch_ == 0)
+	    {
+	        std::fill(visited_.begin(), visited_.end(), 0);
+	        epoch_ = 1;
+	    }
+	}
 
 }
-
-
-
-
-
-
-
-
@@ -3,6 +3,9 @@
 // Individual photo-electrons are generated for each readout, including photo-statistic fluctuations
 // Simulate digitization procedure and produce CaloDigis. 
 //
+// With binPETimes, the PEs of a readout are counted in bins of (digitization sample, pulse phase) and the
+// digitized pulse of each non-empty bin is added once, weighted by the count. The pulse only depends on these
+// two numbers, so the waveform is the same up to rounding, at a cost set by the number of bins rather than of PEs.
 //
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Framework/Core/ModuleMacros.h"
@@ -68,6 +71,7 @@ namespace mu2e {
              fhicl::Atom<int>           minPeakADC           { Name("minPeakADC"),             Comment("Minimum ADC hits of local peak to digitize") }; 
              fhicl::Atom<double>        endTimeBuffer        { Name("endTimeBuffer"),          Comment("Number of extra timestamps after end of pulse") }; 
              fhicl::Atom<unsigned>      bufferDigi           { Name("bufferDigi"),             Comment("Number of timeStamps for the buffer digi") }; 
+             fhicl::Atom<bool>          binPETimes           { Name("binPETimes"),             Comment("Add the pulse once per sample and phase bin of PE times"),false }; 
              fhicl::Atom<int>           diagLevel            { Name("diagLevel"),              Comment("Diag Level"),0 };
          };
          
@@ -88,7 +92,12 @@ namespace mu2e {
             generateSpotNoise_ (config().generateSpotNoise()),
             noiseGenerator_    (config().noise_gen_conf(), engine_, 0),
             addRandomNoise_    (config().addRandomNoise()),
-            diagLevel_         (config().diagLevel())
+            binPETimes_        (config().binPETimes()),
+            diagLevel_         (config().diagLevel()),
+            waveform_          (),
+            wfADC_             (),
+            peCounts_          (),
+            peBins_            ()
          {
 	     consumes<EventWindowMarker>(ewMarkerTag_);
              produces<CaloDigiCollection>();
@@ -103,6 +112,7 @@ namespace mu2e {
     private:       
        void makeDigitization  (const CaloShowerROCollection&, CaloDigiCollection&, const EventWindowMarker&);
        void fillROHits        (unsigned iRO, std::vector<double>& waveform, const CaloShowerROCollection&, const ConditionsHandle<CalorimeterCalibrations>&);
+       void fillROHitsBinned  (unsigned iRO, std::vector<double>& waveform, const CaloShowerROCollection&, const ConditionsHandle<CalorimeterCalibrations>&);
        void generateNoise     (std::vector<double>& waveform, unsigned iRO, const ConditionsHandle<CalorimeterCalibrations>&);
        void buildOutputDigi   (unsigned iRO, std::vector<double>& waveform, int pedestal, CaloDigiCollection&);
        void diag0             (unsigned, const std::vector<int>&);
@@ -126,7 +136,12 @@ namespace mu2e {
        CaloNoiseSimGenerator   noiseGenerator_;
        bool                    addRandomNoise_;
        const Calorimeter*      calorimeter_;
+       bool                    binPETimes_;
        int                     diagLevel_;
+       std::vector<double>     waveform_;   // buffers reused for all readouts
+       std::vector<int>        wfADC_;
+       std::vector<unsigned>   peCounts_;   // PE count per (sample, phase) bin, zero outside fillROHitsBinned
+       std::vector<unsigned>   peBins_;     // non-empty bins
   };
 
 
@@ -179,10 +194,12 @@ namespace mu2e {
   
       if (waveformSize<1) throw cet::exception("Rethrow")<< "[CaloMC/CaloDigiMaker] digitization size too short " << std::endl;
        
+      std::vector<double>& waveform = waveform_;
       for (int iRO=0;iRO<nWaveforms;++iRO)
       {
-          std::vector<double> waveform(waveformSize,0.0);
-          fillROHits(iRO, waveform, CaloShowerROs, calorimeterCalibrations);
+          waveform.assign(waveformSize,0.0);
+          if (binPETimes_) fillROHitsBinned(iRO, waveform, CaloShowerROs, calorimeterCalibrations);
+          else             fillROHits(iRO, waveform, CaloShowerROs, calorimeterCalibrations);
           if (addNoise_ &&  generateSpotNoise_) generateNoise(waveform, iRO, calorimeterCalibrations);
           if (addNoise_ && !generateSpotNoise_) noiseGenerator_.addFullNoise(waveform, false);
           buildOutputDigi(iRO, waveform, noiseGenerator_.pedestal(), caloDigiColl);
@@ -215,6 +232,47 @@ namespace mu2e {
   }
 
 
+  // Same as fillROHits, but the PEs are first counted in (start sample, pulse phase) bins
+  //--------------------------------------------------------------------------
+  void CaloDigiMaker::fillROHitsBinned(unsigned iRO, std::vector<double>& waveform, const CaloShowerROCollection& CaloShowerROs,
+                                       const ConditionsHandle<CalorimeterCalibrations>& calorimeterCalibrations)
+  {
+      double   scaleFactor = calorimeterCalibrations->MeV2ADC(iRO)/calorimeterCalibrations->peMeV(iRO);
+      unsigned nPhases     = pulseShape_.nPhases();
+      unsigned nBins       = pulseShape_.nBins();
+      if (peCounts_.size() < waveform.size()*nPhases) peCounts_.resize(waveform.size()*nPhases,0u);
+
+      peBins_.clear();
+      for (const auto& CaloShowerRO : CaloShowerROs)
+      {
+          unsigned SiPMID = CaloShowerRO.SiPMID();
+          if (SiPMID != iRO) continue;
+          for (const float PEtime : CaloShowerRO.PETime())
+          {        
+              float    time        = PEtime - blindTime_ + startTimeBuffer_;         
+              if (time < 0) continue;
+              unsigned startSample = unsigned(time/digiSampling_);
+              if (startSample >= waveform.size()) continue;
+
+              unsigned bin = startSample*nPhases + pulseShape_.phase(time);
+              if (peCounts_[bin]++ == 0) peBins_.push_back(bin);
+          }
+      }
+
+      for (auto bin : peBins_)
+      {
+          unsigned      startSample = bin/nPhases;
+          unsigned      nSamples    = std::min(nBins, unsigned(waveform.size())-startSample);
+          const double* pulse       = pulseShape_.phasePulse(bin%nPhases);
+          double        weight      = peCounts_[bin]*scaleFactor;
+          double*       wf          = waveform.data() + startSample;
+
+          for (unsigned i=0; i<nSamples; ++i) wf[i] += pulse[i]*weight;
+          peCounts_[bin] = 0;
+      }
+  }
+
+
   //----------------------------------------------------------------------------------------------------------
   void CaloDigiMaker::generateNoise(std::vector<double>& waveform, unsigned iRO, 
                                     const ConditionsHandle<CalorimeterCalibrations>& calorimeterCalibrations)
@@ -266,8 +324,8 @@ namespace mu2e {
   void CaloDigiMaker::buildOutputDigi(unsigned iRO, std::vector<double>& waveform, int pedestal, CaloDigiCollection& caloDigiColl)
   {
        // round the waveform into non-null integers and apply maxADC cut
-       std::vector<int> wf;
-       wf.reserve(waveform.size());
+       std::vector<int>& wf = wfADC_;
+       wf.clear();
        for (const auto& val : waveform)
        { 
           if (val < pedestal) wf.emplace_back(0);
@@ -0,0 +1,38 @@
+//
+// Flat table of the crystal neighbors (compressed sparse row): the first ring and then the second ring
+// of each crystal are stored one after the other in a single array, so both rings are also contiguous.
+// The order of the ids is that of Crystal::neighbors() followed by Crystal::nextNeighbors()
+//
+
+#ifndef CalorimeterGeom_CaloNeighborTable_hh
+#define CalorimeterGeom_CaloNeighborTable_hh
+
+#include "Offline/CalorimeterGeom/inc/Crystal.hh"
+#include <vector>
+
+namespace mu2e {
+
+     class CaloNeighborTable {
+
+	  public:
+
+             CaloNeighborTable() : offsets_(1,0), ids_() {}
+
+             void        fill(const std::vector<const Crystal*>& crystals);
+
+             int         nCrystal()                                  const {return (offsets_.size()-1)/2;}
+             const int*  begin(int crystalId)                        const {return ids_.data() + offsets_[2*crystalId];}
+             // end of the first ring, or of the second ring if secondRing is true
+             const int*  end(int crystalId, bool secondRing=false)   const {return ids_.data() + offsets_[2*crystalId + (secondRing ? 2 : 1)];}
+
+
+	 private:
+
+             std::vector<unsigned> offsets_; //start of the first ring, start of the second ring, ... for each crystal
+             std::vector<int>      ids_;
+     };
+
+}
+
+
+#endif 
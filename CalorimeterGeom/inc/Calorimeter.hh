@@ -13,6 +13,7 @@
 #include "Offline/CalorimeterGeom/inc/CaloIDMapper.hh"
 #include "Offline/CalorimeterGeom/inc/Disk.hh"
 #include "Offline/CalorimeterGeom/inc/Crystal.hh"
+#include "Offline/CalorimeterGeom/inc/CaloNeighborTable.hh"
 
 #include "CLHEP/Vector/ThreeVector.h"
 #include <vector>
@@ -48,6 +49,7 @@ namespace mu2e {
            virtual const std::vector<int>&  neighbors(int crystalId, bool rawMap=false)                     const = 0;
            virtual const std::vector<int>&  nextNeighbors(int crystalId, bool rawMap=false)                 const = 0;
            virtual       std::vector<int>   neighborsByLevel(int crystalId, int level, bool rawMap = false) const = 0; 
+           virtual const CaloNeighborTable& neighborTable()                                                  const = 0;
            virtual int                      crystalIdxFromPosition(const CLHEP::Hep3Vector& pos)            const = 0;
            virtual int                      nearestIdxFromPosition(const CLHEP::Hep3Vector& pos)            const = 0;
 
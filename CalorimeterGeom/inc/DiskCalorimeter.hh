@@ -14,6 +14,7 @@
 #include "Offline/CalorimeterGeom/inc/CaloGeomUtil.hh"
 #include "Offline/CalorimeterGeom/inc/Disk.hh"
 #include "Offline/CalorimeterGeom/inc/Crystal.hh"
+#include "Offline/CalorimeterGeom/inc/CaloNeighborTable.hh"
 
 #include "CLHEP/Vector/ThreeVector.h"
 
@@ -59,6 +60,7 @@ namespace mu2e {
             virtual const std::vector<int>&  neighbors(int crystalId, bool rawMap)     const  {return fullCrystalList_.at(crystalId)->neighbors(rawMap);}	  
             virtual const std::vector<int>&  nextNeighbors(int crystalId, bool rawMap) const  {return fullCrystalList_.at(crystalId)->nextNeighbors(rawMap);} 
             virtual       std::vector<int>   neighborsByLevel(int crystalId, int level, bool rawMap) const; 
+            virtual const CaloNeighborTable& neighborTable()                             const  {return neighborTable_;}
             virtual int                      crystalIdxFromPosition(const CLHEP::Hep3Vector& pos) const;
             virtual int                      nearestIdxFromPosition(const CLHEP::Hep3Vector& pos) const; 
 
@@ -79,6 +81,7 @@ namespace mu2e {
 	    std::vector<DiskPtr>          disks_;
             
 	    std::vector<const Crystal*>   fullCrystalList_; //non-owning crystal pointers
+            CaloNeighborTable             neighborTable_;   //flat copy of the neighbors for the clustering
             CaloInfo                      caloInfo_;
             CaloIDMapper                  caloIDMapper_;
 	    CaloGeomUtil                  geomUtil_;
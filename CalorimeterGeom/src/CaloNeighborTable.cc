@@ -0,0 +1,22 @@
+#include "Offline/CalorimeterGeom/inc/CaloNeighborTable.hh"
+
+
+namespace mu2e {
+
+    void CaloNeighborTable::fill(const std::vector<const Crystal*>& crystals)
+    {
+        offsets_.clear();
+        ids_.clear();
+
+        offsets_.reserve(2*crystals.size()+1);
+        offsets_.push_back(0);
+        for (const auto* crystal : crystals)
+        {
+            ids_.insert(ids_.end(), crystal->neighbors().begin(),     crystal->neighbors().end());
+            offsets_.push_back(ids_.size());
+            ids_.insert(ids_.end(), crystal->nextNeighbors().begin(), crystal->nextNeighbors().end());
+            offsets_.push_back(ids_.size());
+        }
+    }
+
+}
@@ -14,6 +14,7 @@ namespace mu2e {
     DiskCalorimeter::DiskCalorimeter() : 
       disks_(),
       fullCrystalList_(),  
+      neighborTable_(),
       caloInfo_(),
       geomUtil_(disks_, fullCrystalList_)
     {}
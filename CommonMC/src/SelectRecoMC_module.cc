@@ -31,6 +31,7 @@
 #include "Offline/RecoDataProducts/inc/CrvDigi.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitLeafIndex.hh"
 #include "Offline/RecoDataProducts/inc/CrvCoincidenceCluster.hh"
 #include "Offline/RecoDataProducts/inc/RecoCount.hh"
 // Utilities
@@ -388,6 +389,7 @@ namespace mu2e {
       }
     }
     // get straw indices from all helices too
+    ComboHitLeafIndex leafIndex(event);
     for (auto const& hsc : _hscs) {
     // get all products from this
       art::ModuleLabelSelector hscsel(hsc);
@@ -402,7 +404,7 @@ namespace mu2e {
 	  // go back to StrawHit indices (== digi indices for reco)
 	  std::vector<StrawHitIndex> shids;
 	  for(size_t ihit = 0; ihit < seed.hits().size(); ihit++)
-	    seed.hits().fillStrawHitIndices(event,ihit,shids);
+	    leafIndex.fillStrawHitIndices(seed.hits(),ihit,shids);
 	  // add these to the set (duplicates are suppressed)
 	  for(auto shid : shids)
 	    shindices.insert(shid);
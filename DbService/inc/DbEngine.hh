@@ -2,6 +2,11 @@
 #define DbService_DbEngine_hh
 
 #include <shared_mutex>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <memory>
+#include <algorithm>
 #include <chrono>
 
 #include "Offline/DbService/inc/DbReader.hh"
@@ -10,6 +15,7 @@
 #include "Offline/DbTables/inc/DbVersion.hh"
 #include "Offline/DbTables/inc/DbTableCollection.hh"
 #include "Offline/DbTables/inc/DbCache.hh"
+#include "Offline/DbTables/inc/DbDiskCache.hh"
 #include "Offline/DbTables/inc/DbValCache.hh"
 #include "Offline/DbTables/inc/DbLiveTable.hh"
 
@@ -18,8 +24,14 @@ namespace mu2e {
   class DbEngine {
   public:
 
+    // fills a table from the database given its cid, returns 0 on success
+    typedef std::function<int(DbTable::ptr_t const& ptr, int cid)> Fetcher;
+
     DbEngine():_verbose(0),_saveCsv(true),_initialized(false),
-	       _lockWaitTime(0),_lockTime(0) {}
+	       _lockWaitTime(0),_lockTime(0),_fetchWaitTime(0),
+	       _nFetch(0),_nFetchWait(0),_nReaders(0),
+	       _prefetchBatch(20),_prefetchThreads(4),_prefetchTime(0),
+	       _cacheLimit(0) {}
     // the big read of the IOV structure is done in beginJob
     int beginJob();
     int endJob();
@@ -33,6 +45,21 @@ namespace mu2e {
     void setVerbose(int verbose = 0) { _verbose = verbose; }
     // whether to save the csv text content when loading a table
     void setSaveCsv(bool saveCsv) { _saveCsv = saveCsv; }
+    // replace the database reads, for example by a fake backend in tests.
+    // The fetcher is called from several threads at once, each call
+    // for a different cid - optionally set before beginJob
+    void setFetcher(Fetcher const& fetcher) { _fetcher = fetcher; }
+    // keep a copy of each table read in this directory, and look there
+    // before going to the database - optionally set before beginJob
+    void setDiskCache(std::string const& dir) { _diskDir = dir; }
+    // if >0, remove least recently used tables when the memory 
+    // cache grows over this size in bytes
+    void setCacheLimit(std::size_t bytes) { _cacheLimit = bytes; }
+    // prefetch reads batch tables per connection, with up to 
+    // threads connections open at once
+    void setPrefetch(int batch, int threads) { 
+      _prefetchBatch = std::max(batch,1); 
+      _prefetchThreads = std::max(threads,1); }
     // these should only be called in single-threaded startup
     std::shared_ptr<DbValCache>& valCache() {return _vcache;}
     std::vector<int> gids() { return _gids; }
@@ -42,6 +69,11 @@ namespace mu2e {
     DbLiveTable update(int tid, uint32_t run, uint32_t subrun);
     int tidByName(std::string const& name);
     std::string nameByTid(int tid);
+    // read every table that could be needed for these runs into
+    // the cache, so events don't wait on the database.  
+    // Returns the number of tables read.
+    int prefetch(uint32_t firstRun, uint32_t lastRun);
+    int prefetch(std::vector<uint32_t> const& runs);
 
   private:
 
@@ -56,10 +88,38 @@ namespace mu2e {
       int _cid;
     };
 
+    // a table this thread has undertaken to read, see _inFlight
+    struct Claim {
+      Claim(int tid, int cid):_tid(tid),_cid(cid) {}
+      int _tid;
+      int _cid;
+      std::promise<DbTable::cptr_t> _promise;
+    };
+
     // call beginRun on first use, if needed
     void lazyBeginJob();
     // find a table cid in the fast lookup structure
     Row findTable(int tid, uint32_t run, uint32_t subrun);
+    // read a table from the database, called without any lock held
+    DbTable::cptr_t fetchTable(int tid, int cid, uint32_t run, uint32_t subrun,
+			       std::promise<DbTable::cptr_t>& promise);
+    // fill a table from the disk cache, or the database
+    int loadTable(DbTable::ptr_t const& ptr, int cid);
+    // copy a table read from the database to the disk cache
+    void saveTable(DbTable::ptr_t const& ptr, int cid);
+    // fill a table with a reader from the pool
+    int readTable(DbTable::ptr_t const& ptr, int cid);
+    // read all tables with IoV overlapping any of the intervals
+    int prefetch(std::vector<DbIoV> const& iovs);
+    // read a batch of claimed tables into the cache
+    void fetchBatch(std::vector<Claim>::iterator begin, 
+		    std::vector<Claim>::iterator end);
+    // fill tables over one connection from the pool
+    int readTables(std::vector<DbTable::ptr_t> const& ptrs,
+		   std::vector<int> const& cids);
+    // take a reader from the pool, or make one
+    std::unique_ptr<DbReader> takeReader();
+    void returnReader(std::unique_ptr<DbReader> reader);
 
 
     DbId _id;
@@ -82,6 +142,31 @@ namespace mu2e {
     // count the time locked
     std::chrono::microseconds _lockWaitTime;
     std::chrono::microseconds _lockTime;
+
+    // tables being read from the database, by cid.  The first thread to
+    // need a table reads it outside of the lock, others needing the same
+    // cid wait on its future.  Protected by _mutex.
+    std::map<int,std::shared_future<DbTable::cptr_t>> _inFlight;
+    // time spent waiting for a table read by another thread
+    std::chrono::microseconds _fetchWaitTime;
+    int _nFetch;
+    int _nFetchWait;
+
+    Fetcher _fetcher;
+    // a curl handle can't be shared, so concurrent reads each take a
+    // reader from this pool, made as copies of _reader
+    std::mutex _readerMutex;
+    std::vector<std::unique_ptr<DbReader>> _readers;
+    std::size_t _nReaders;
+
+    int _prefetchBatch;
+    int _prefetchThreads;
+    std::chrono::microseconds _prefetchTime;
+
+    std::string _diskDir;
+    DbDiskCache _disk;
+
+    std::size_t _cacheLimit;
     
   };
 }
@@ -31,6 +31,11 @@ namespace mu2e {
     };
 
     DbReader();
+    // copies the configuration (database, timeout, cache and verbose
+    // settings), but not the connection or the accumulated times, so
+    // the copy can be used on another thread
+    DbReader(const DbReader& other);
+    DbReader& operator=(const DbReader&) = delete;
     ~DbReader();
 
     const DbId& id() const { return _id; }
@@ -46,6 +51,9 @@ namespace mu2e {
     int multiQuery(std::vector<QueryForm>& qfv);
 
     int fillTableByCid(DbTable::ptr_t ptr, int cid);
+    // fill several tables over one connection, ptrs[i] with cids[i]
+    int fillTablesByCid(std::vector<DbTable::ptr_t> const& ptrs,
+			std::vector<int> const& cids);
     int fillValTables(DbValCache& vcache);
 
     std::string& lastError() { return _lastError; }
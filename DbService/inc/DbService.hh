@@ -10,6 +10,7 @@
 #include "art/Framework/Services/Registry/ServiceTable.h" 
 #include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
+#include "art/Framework/Principal/fwd.h"
 #include "cetlib_except/exception.h"
 #include "Offline/DbService/inc/DbEngine.hh"
 
@@ -39,6 +40,21 @@ namespace mu2e {
 	  Comment("read the DB immedatiately, not on first use")};
       fhicl::OptionalAtom<int> cacheLifetime{Name("cacheLifetime"), 
 	  Comment("if >0, read IoV from cache, but renew each lifetime s")};
+      fhicl::Atom<std::string> diskCache{Name("diskCache"),
+	  Comment("directory for a local copy of tables, empty for none"),""};
+      fhicl::Atom<int> cacheLimit{Name("cacheLimit"),
+	  Comment("if >0, max MB of tables kept in memory, least recently used are removed"),0};
+      fhicl::OptionalSequence<unsigned> prefetchRange{Name("prefetchRange"),
+	  Comment("first and last run, read all their tables before the first event")};
+      fhicl::OptionalSequence<unsigned> prefetchRuns{Name("prefetchRuns"),
+	  Comment("list of runs, read all their tables before the first event")};
+      fhicl::Atom<bool> prefetchBeginRun{Name("prefetchBeginRun"),
+	  Comment("read all tables for each input run before its first event"),
+	  false};
+      fhicl::Atom<int> prefetchBatch{Name("prefetchBatch"),
+	  Comment("tables read per connection in prefetch"),20};
+      fhicl::Atom<int> prefetchThreads{Name("prefetchThreads"),
+	  Comment("connections open at once in prefetch"),4};
     };
 
     // this line is required by art to allow the command line help print
@@ -50,6 +66,7 @@ namespace mu2e {
 
     // Functions registered for callbacks.
     void postBeginJob();
+    void preBeginRun(art::Run const& run);
     void postEndJob();
 
     // how the DbHandle interacts with this service
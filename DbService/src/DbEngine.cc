@@ -1,5 +1,6 @@
 #include <iostream>
 #include <chrono>
+#include <atomic>
 #include "cetlib_except/exception.h"
 #include "Offline/DbService/inc/DbEngine.hh"
 #include "Offline/DbTables/inc/DbTableFactory.hh"
@@ -25,6 +26,15 @@ int mu2e::DbEngine::beginJob() {
   _reader.setTimeVerbose(_verbose);
   _reader.setSaveCsv(_saveCsv);
 
+  // tables in the disk cache are kept under the database name,
+  // since cids are only unique within a database.  Tables without
+  // a binary form are written as csv, so the readers keep it
+  if(!_diskDir.empty()) {
+    _disk.setDir(_diskDir + "/" + _id.name());
+    _disk.setVerbose(_verbose);
+    _reader.setSaveCsv(true);
+  }
+
   // this is used to assign nominal tid's and cid's to tables that
   // are read in through a file, and are not declared in the database
   int fakeTid = 10000;
@@ -321,7 +331,7 @@ mu2e::DbLiveTable mu2e::DbEngine::update(int tid, uint32_t run,
     auto row = findTable(tid, run, subrun);
     cid = row.cid();
     iov = row.iov();
-    if(_cache.hasTable(row.cid())) ptr = _cache.get(row.cid());
+    if(cid>=0) ptr = _cache.get(cid);
   } // read lock goes out of scope
 
   // if no cid now, then table can't be found - have to stop
@@ -333,47 +343,48 @@ mu2e::DbLiveTable mu2e::DbEngine::update(int tid, uint32_t run,
 
   // if it wasn't found in cache, try to read from database
   if(! ptr ) {
-    auto stime = std::chrono::high_resolution_clock::now();
-    std::unique_lock lock(_mutex); // write lock
-    auto mtime = std::chrono::high_resolution_clock::now();
-    auto dt = std::chrono::duration_cast<std::chrono::microseconds>
-                                               ( mtime - stime );
-    _lockWaitTime += dt;
-    
-    // have to check if some other thread loaded it 
-    // since the above read attempt
-    if(_cache.hasTable(cid)) {
-      ptr = _cache.get(cid);
-    } else {
-      auto const& tabledef = _vcache->valTables().row(tid);
-      // this makes the memory
-      auto ncptr = DbTableFactory::newTable(tabledef.name());
-      // the actual http read
-      int rc = _reader.fillTableByCid(ncptr,cid);
-
-      // reader does not abort, so do it here
-      if(rc!=0) {
-	auto const& tabledef = _vcache->valTables().row(tid);
-	throw cet::exception("DBENGINE_UPDATE_FAILED") 
-	  << " DbEngine::update failed to find table " << tabledef.name() 
-	  << " for run:subrun "<<run<<":"<<subrun
-	  <<", cid ="<< cid 
-	  <<", rc ="<< rc << "\n";
+    std::shared_future<DbTable::cptr_t> loading;
+    std::promise<DbTable::cptr_t> promise;
+    bool reader = false;
+    {
+      auto stime = std::chrono::high_resolution_clock::now();
+      std::unique_lock lock(_mutex); // write lock
+      auto mtime = std::chrono::high_resolution_clock::now();
+      _lockWaitTime += std::chrono::duration_cast<std::chrono::microseconds>
+	( mtime - stime );
+
+      // have to check if some other thread loaded it 
+      // since the above read attempt
+      ptr = _cache.get(cid,false); // the miss was counted above
+      if(!ptr) {
+	auto it = _inFlight.find(cid);
+	if(it != _inFlight.end()) { // another thread is reading it
+	  loading = it->second;
+	} else { // this thread will read it
+	  _inFlight[cid] = promise.get_future().share();
+	  _nFetch++;
+	  reader = true;
+	}
       }
 
-      // make it const
-      ptr = std::const_pointer_cast<const mu2e::DbTable,mu2e::DbTable>(ncptr);
-      // push to cache
-      _cache.add(cid,ptr);
+      auto etime = std::chrono::high_resolution_clock::now();
+      _lockTime += std::chrono::duration_cast<std::chrono::microseconds>
+	( etime - mtime );
+    } // write lock goes out of scope
+
+    if(reader) {
+      ptr = fetchTable(tid, cid, run, subrun, promise);
+    } else if(!ptr) {
+      auto stime = std::chrono::high_resolution_clock::now();
+      ptr = loading.get(); // rethrows if the read failed
+      auto etime = std::chrono::high_resolution_clock::now();
+      std::unique_lock lock(_mutex);
+      _fetchWaitTime += std::chrono::duration_cast<std::chrono::microseconds>
+	( etime - stime );
+      _nFetchWait++;
     }
 
-    auto etime = std::chrono::high_resolution_clock::now();
-    dt = std::chrono::duration_cast<std::chrono::microseconds>
-                                          ( etime - mtime );
-    _lockTime += dt;
-
-  } // write lock goes out of scope
-
+  }
 
   // this code handles the case where an override takes effect
   // in the middle of a database IOV - remove the override
@@ -390,6 +401,270 @@ mu2e::DbLiveTable mu2e::DbEngine::update(int tid, uint32_t run,
 
 }
 
+// read a table from the database.  The caller has made the in-flight
+// entry for the cid; the read happens with no lock held, so reads of
+// different cids proceed in parallel.  The result, or the error, is
+// passed to the threads waiting on the entry through the promise.
+mu2e::DbTable::cptr_t mu2e::DbEngine::fetchTable(int tid, int cid,
+		 uint32_t run, uint32_t subrun,
+		 std::promise<DbTable::cptr_t>& promise) {
+
+  DbTable::cptr_t ptr;
+  try {
+    // the table definitions don't change after beginJob
+    auto const& tabledef = _vcache->valTables().row(tid);
+    // this makes the memory
+    auto ncptr = DbTableFactory::newTable(tabledef.name());
+    // from the disk cache or the database
+    int rc = loadTable(ncptr,cid);
+
+    // reader does not abort, so do it here
+    if(rc!=0) {
+      throw cet::exception("DBENGINE_UPDATE_FAILED") 
+	<< " DbEngine::update failed to find table " << tabledef.name() 
+	<< " for run:subrun "<<run<<":"<<subrun
+	<<", cid ="<< cid 
+	<<", rc ="<< rc << "\n";
+    }
+
+    // make it const
+    ptr = std::const_pointer_cast<const mu2e::DbTable,mu2e::DbTable>(ncptr);
+  } catch (...) {
+    // let the waiting threads see the error, and a later call try again
+    {
+      std::unique_lock lock(_mutex);
+      _inFlight.erase(cid);
+    }
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+
+  {
+    std::unique_lock lock(_mutex); // write lock
+    // push to cache
+    _cache.add(cid,ptr);
+    _inFlight.erase(cid);
+    if(_cacheLimit>0) _cache.purge(_cacheLimit);
+  }
+  promise.set_value(ptr);
+
+  return ptr;
+}
+
+// read a batch of tables claimed by prefetch.  As in fetchTable,
+// the result or the error goes to the threads waiting on the claims.
+void mu2e::DbEngine::fetchBatch(std::vector<Claim>::iterator begin,
+				std::vector<Claim>::iterator end) {
+
+  std::vector<DbTable::ptr_t> ptrs;
+  std::vector<int> cids;
+  try {
+    for(auto it=begin; it!=end; it++) {
+      auto const& tabledef = _vcache->valTables().row(it->_tid);
+      ptrs.push_back(DbTableFactory::newTable(tabledef.name()));
+      cids.push_back(it->_cid);
+    }
+
+    // only the tables not in the disk cache go to the database
+    std::vector<DbTable::ptr_t> rptrs;
+    std::vector<int> rcids;
+    for(size_t i=0; i<ptrs.size(); i++) {
+      if(!_disk.read(ptrs[i],cids[i],_saveCsv)) {
+	rptrs.push_back(ptrs[i]);
+	rcids.push_back(cids[i]);
+      }
+    }
+
+    int rc = 0;
+    if(_fetcher) {
+      for(size_t i=0; i<rptrs.size() && rc==0; i++) {
+	rc = _fetcher(rptrs[i],rcids[i]);
+      }
+    } else if(!rptrs.empty()) {
+      rc = readTables(rptrs,rcids);
+    }
+    if(rc==0) {
+      for(size_t i=0; i<rptrs.size(); i++) saveTable(rptrs[i],rcids[i]);
+    }
+
+    if(rc!=0) {
+      throw cet::exception("DBENGINE_PREFETCH_FAILED") 
+	<< " DbEngine::prefetch failed to read a batch of " << cids.size()
+	<< " tables, cids " << cids.front() << " to " << cids.back()
+	<<", rc ="<< rc << "\n";
+    }
+  } catch (...) {
+    {
+      std::unique_lock lock(_mutex);
+      for(auto it=begin; it!=end; it++) _inFlight.erase(it->_cid);
+    }
+    for(auto it=begin; it!=end; it++) {
+      it->_promise.set_exception(std::current_exception());
+    }
+    throw;
+  }
+
+  std::vector<DbTable::cptr_t> cptrs;
+  for(auto const& ptr : ptrs) {
+    cptrs.push_back(std::const_pointer_cast<const mu2e::DbTable,mu2e::DbTable>(ptr));
+  }
+  {
+    std::unique_lock lock(_mutex); // write lock
+    for(size_t i=0; i<cids.size(); i++) {
+      _cache.add(cids[i],cptrs[i]);
+      _inFlight.erase(cids[i]);
+    }
+    _nFetch += cids.size();
+    if(_cacheLimit>0) _cache.purge(_cacheLimit);
+  }
+  size_t i = 0;
+  for(auto it=begin; it!=end; it++) it->_promise.set_value(cptrs[i++]);
+}
+
+// fill a table from the disk cache, or the database
+int mu2e::DbEngine::loadTable(DbTable::ptr_t const& ptr, int cid) {
+  if(_disk.read(ptr,cid,_saveCsv)) return 0;
+  // the actual http read
+  int rc = _fetcher ? _fetcher(ptr,cid) : readTable(ptr,cid);
+  if(rc==0) saveTable(ptr,cid);
+  return rc;
+}
+
+void mu2e::DbEngine::saveTable(DbTable::ptr_t const& ptr, int cid) {
+  if(!_disk.enabled()) return;
+  _disk.write(*ptr,cid);
+  // the csv was only kept for the disk cache
+  if(!_saveCsv) ptr->baseClear();
+}
+
+// fill a table with a reader from the pool
+int mu2e::DbEngine::readTable(DbTable::ptr_t const& ptr, int cid) {
+  auto reader = takeReader();
+  int rc = reader->fillTableByCid(ptr,cid);
+  returnReader(std::move(reader));
+  return rc;
+}
+
+// fill tables with one reader from the pool, over one connection
+int mu2e::DbEngine::readTables(std::vector<DbTable::ptr_t> const& ptrs,
+			       std::vector<int> const& cids) {
+  auto reader = takeReader();
+  int rc = reader->fillTablesByCid(ptrs,cids);
+  returnReader(std::move(reader));
+  return rc;
+}
+
+// take a reader from the pool, or a new copy of _reader
+std::unique_ptr<mu2e::DbReader> mu2e::DbEngine::takeReader() {
+  std::lock_guard lock(_readerMutex);
+  if(_readers.empty()) {
+    _nReaders++;
+    return std::make_unique<DbReader>(_reader);
+  }
+  auto reader = std::move(_readers.back());
+  _readers.pop_back();
+  return reader;
+}
+
+void mu2e::DbEngine::returnReader(std::unique_ptr<DbReader> reader) {
+  std::lock_guard lock(_readerMutex);
+  _readers.push_back(std::move(reader));
+}
+
+int mu2e::DbEngine::prefetch(uint32_t firstRun, uint32_t lastRun) {
+  DbIoV iov;
+  iov.set(firstRun,0,lastRun,iov.maxSubrun());
+  return prefetch(std::vector<DbIoV>(1,iov));
+}
+
+int mu2e::DbEngine::prefetch(std::vector<uint32_t> const& runs) {
+  std::vector<DbIoV> iovs;
+  for(auto run : runs) {
+    DbIoV iov;
+    iov.set(run,0,run,iov.maxSubrun());
+    iovs.push_back(iov);
+  }
+  return prefetch(iovs);
+}
+
+// Find the cids of all tables whose IoV overlaps the intervals and
+// which are not yet in the cache, claim them so update() calls wait
+// for this read instead of starting their own, then read them in
+// batches, several batches at once.  A batch is read over one 
+// connection, so it costs one connection setup instead of one per table.
+int mu2e::DbEngine::prefetch(std::vector<DbIoV> const& iovs) {
+
+  lazyBeginJob(); // initialize if needed
+  if(_version.purpose()=="EMPTY") return 0;
+
+  auto start_time = std::chrono::high_resolution_clock::now();
+
+  std::vector<Claim> claims;
+  {
+    std::unique_lock lock(_mutex); // write lock
+    for(auto const& p : _lookup) {
+      for(auto const& r : p.second) {
+	bool needed = false;
+	for(auto const& iov : iovs) {
+	  if(r.iov().isOverlapping(iov)) needed = true;
+	}
+	if(!needed) continue;
+	if(_cache.hasTable(r.cid())) continue;
+	if(_inFlight.find(r.cid()) != _inFlight.end()) continue;
+	claims.emplace_back(p.first,r.cid());
+	_inFlight[r.cid()] = claims.back()._promise.get_future().share();
+      }
+    }
+  } // write lock goes out of scope
+
+  std::size_t nbatch = (claims.size()+_prefetchBatch-1)/_prefetchBatch;
+  std::size_t nthread = std::min(nbatch,std::size_t(_prefetchThreads));
+  if(_verbose>1) {
+    std::cout << "DbEngine::prefetch reading " << claims.size() 
+	      << " tables in " << nbatch << " batches on " 
+	      << nthread << " threads" << std::endl;
+  }
+
+  // each worker takes the next unread batch until there are none,
+  // the first worker is this thread.  A failed batch does not stop
+  // the others, so every claim is resolved, the first error is 
+  // reported at the end
+  std::atomic<std::size_t> next(0);
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  auto work = [&]() {
+    std::size_t ib;
+    while((ib = next++) < nbatch) {
+      auto begin = claims.begin() + ib*_prefetchBatch;
+      auto end = claims.begin() + 
+	std::min(claims.size(),(ib+1)*_prefetchBatch);
+      try {
+	fetchBatch(begin,end);
+      } catch (...) {
+	std::lock_guard lock(errorMutex);
+	if(!error) error = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::future<void>> workers;
+  for(std::size_t i=1; i<nthread; i++) {
+    workers.push_back(std::async(std::launch::async,work));
+  }
+  work();
+  for(auto& w : workers) w.get();
+
+  auto end_time = std::chrono::high_resolution_clock::now();
+  {
+    std::unique_lock lock(_mutex);
+    _prefetchTime += std::chrono::duration_cast<std::chrono::microseconds>
+      (end_time - start_time);
+  }
+  if(error) std::rethrow_exception(error);
+
+  return claims.size();
+}
+
 // find a table by cid in the fast lookup structure
 // can only be called inside a read lock
 mu2e::DbEngine::Row mu2e::DbEngine::findTable(
@@ -486,14 +761,34 @@ int mu2e::DbEngine::endJob() {
   if(!_vcache) return 0;
   if(_verbose>0) {
     std::cout << "DbEngine::endJob" << std::endl;
-    std::cout << "    Total time in reading DB: "<< _reader.totalTime() 
+    double readTime = _reader.totalTime();
+    for(auto const& r : _readers) readTime += r->totalTime();
+    std::cout << "    Total time in reading DB: "<< readTime
+	      <<" s" << std::endl;
+    std::cout << "    Tables read: " << _nFetch << " with "
+	      << _nReaders << " readers" << std::endl;
+    if(_disk.enabled()) {
+      std::cout << "    Disk cache " << _disk.dir() << ": " 
+		<< _disk.hits() << " hits, " << _disk.misses() 
+		<< " misses, " << _disk.writes() << " writes" << std::endl;
+    }
+    std::cout << "    Total time in prefetch: "
+	      << _prefetchTime.count()*1.0e-6
 	      <<" s" << std::endl;
+    std::cout << "    Total time waiting for tables read by other threads: "
+	      << _fetchWaitTime.count()*1.0e-6
+	      <<" s in " << _nFetchWait << " waits" << std::endl;
     std::cout << "    Total time waiting for locks: "
 	      << _lockWaitTime.count()*1.0e-6
 	      <<" s" << std::endl;
     std::cout << "    Total time in locks: "<< _lockTime.count()*1.0e-6
 	      <<" s" << std::endl;
-    std::cout << "    cache memory   : "<<_cache.size()<<" b" << std::endl;
+    std::cout << "    cache memory   : "<<_cache.size()<<" b in "
+	      << _cache.ntable() << " tables, peak " 
+	      << _cache.peakSize() << " b" << std::endl;
+    std::cout << "    cache hits: " << _cache.hits() << ", misses: "
+	      << _cache.misses() << ", evictions: " << _cache.evictions()
+	      << " (" << _cache.evictedSize() << " b)" << std::endl;
     std::cout << "    valcache memory: "<<_vcache->size()<<" b" << std::endl;
   }
   return 0;
@@ -18,6 +18,17 @@ mu2e::DbReader::DbReader():_curl_handle(nullptr),
   curl_global_init(CURL_GLOBAL_ALL);
 }
 
+mu2e::DbReader::DbReader(const DbReader& other):_id(other._id),
+		_curl_handle(nullptr),_timeout(other._timeout),_totalTime(0),
+		_removeHeader(other._removeHeader),
+		_abortOnFail(other._abortOnFail),_useCache(other._useCache),
+		_cacheLifetime(other._cacheLifetime),_verbose(other._verbose),
+		_timeVerbose(other._timeVerbose),_saveCsv(other._saveCsv) {
+
+  // each instance holds a reference to the curl global memory
+  curl_global_init(CURL_GLOBAL_ALL);
+}
+
 mu2e::DbReader::~DbReader() {
   // free memory
   curl_global_cleanup();
@@ -79,6 +90,22 @@ int mu2e::DbReader::fillTableByCid(DbTable::ptr_t ptr, int cid) {
   return 0;
 }
 
+int mu2e::DbReader::fillTablesByCid(std::vector<DbTable::ptr_t> const& ptrs,
+				    std::vector<int> const& cids) {
+  std::vector<QueryForm> qfv(ptrs.size());
+  for(size_t i=0; i<ptrs.size(); i++) {
+    qfv[i].select = ptrs[i]->query();
+    qfv[i].table = ptrs[i]->dbname();
+    qfv[i].where = "cid:eq:"+std::to_string(cids[i]);
+  }
+  int rc = multiQuery(qfv);
+  if(rc!=0) return rc;
+  for(size_t i=0; i<ptrs.size(); i++) {
+    ptrs[i]->fill(qfv[i].csv,_saveCsv);
+  }
+  return 0;
+}
+
 
 int mu2e::DbReader::fillValTables(DbValCache& vcache) {
   std::string csv;
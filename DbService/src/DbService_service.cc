@@ -1,9 +1,11 @@
 
+#include <algorithm>
 #include "Offline/DbService/inc/DbService.hh"
 #include "Offline/DbService/inc/DbIdList.hh"
 #include "Offline/DbTables/inc/DbUtil.hh"
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
 #include "art/Framework/Services/Registry/ServiceDefinitionMacros.h"
+#include "art/Framework/Principal/Run.h"
 
 
 namespace mu2e {
@@ -16,6 +18,9 @@ namespace mu2e {
     // register callbacks
     iRegistry.sPostBeginJob.watch(this, &DbService::postBeginJob);
     iRegistry.sPostEndJob.watch (this, &DbService::postEndJob );
+    if(_config.prefetchBeginRun()) {
+      iRegistry.sPreBeginRun.watch(this, &DbService::preBeginRun);
+    }
 
     if(_verbose>0) {
       std::cout << "DbService: purpose = " 
@@ -70,6 +75,9 @@ namespace mu2e {
     int cacheLifetime = 0;
     _config.cacheLifetime(cacheLifetime);
     _engine.reader().setCacheLifetime(cacheLifetime);
+    _engine.setPrefetch(_config.prefetchBatch(),_config.prefetchThreads());
+    _engine.setDiskCache(_config.diskCache());
+    _engine.setCacheLimit(std::size_t(std::max(_config.cacheLimit(),0))*1000000);
 
     // service will start calling the database at the first event,
     // so the service can exist without the DB being contacted.  
@@ -91,6 +99,36 @@ namespace mu2e {
   /********************************************************/
   void DbService::postBeginJob(){
 
+    // read the tables for the requested runs now, so the first 
+    // events don't wait on the database
+    std::vector<unsigned> range;
+    if(_config.prefetchRange(range)) {
+      if(range.size()!=2 || range[0]>range[1]) {
+	throw cet::exception("DBSERVICE_BAD_PREFETCH") 
+	  << "DbService prefetchRange must be [firstRun,lastRun]\n";
+      }
+      int n = _engine.prefetch(range[0],range[1]);
+      if(_verbose>0) std::cout << "DbService: prefetched " << n 
+			       << " tables for runs " << range[0] 
+			       << " to " << range[1] << std::endl;
+    }
+
+    std::vector<unsigned> runs;
+    if(_config.prefetchRuns(runs)) {
+      int n = _engine.prefetch(std::vector<uint32_t>(runs.begin(),runs.end()));
+      if(_verbose>0) std::cout << "DbService: prefetched " << n 
+			       << " tables for " << runs.size() 
+			       << " runs" << std::endl;
+    }
+
+  }
+
+  /********************************************************/
+  void DbService::preBeginRun(art::Run const& run){
+    // tables already in the cache are not read again
+    int n = _engine.prefetch(std::vector<uint32_t>(1,run.run()));
+    if(_verbose>1) std::cout << "DbService: prefetched " << n 
+			     << " tables for run " << run.run() << std::endl;
   }
 
 
@@ -0,0 +1,297 @@
+//
+// Stress test of concurrent DbEngine::update calls.  The database is
+// replaced by a fake backend that fills TstCalib1 tables after a delay,
+// so no network is needed.  The test checks that
+//   - each cid is read exactly once, however many threads need it
+//   - reads of different cids overlap in time
+//   - a failed read is reported to every thread waiting on it, and
+//     a later request reads the table again
+//   - prefetch of a run range reads each table once, in concurrent
+//     batches, after which no request reads the database
+//   - a second job sharing a disk cache reads no tables from the database
+//   - with a memory limit, the cache stays near the limit, and a table
+//     still held by a user is not removed
+// and prints the time taken compared to serial reads.
+//
+// usage: dbEngineStress [nthreads [ncids [latency_ms]]]
+//
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+#include "cetlib_except/exception.h"
+#include "Offline/DbService/inc/DbEngine.hh"
+#include "Offline/DbTables/inc/TstCalib1.hh"
+
+using namespace mu2e;
+
+namespace {
+
+  // the IoV structure: one purpose and version, table TstCalib1 only,
+  // with calibration cid valid for run cid
+  std::shared_ptr<DbValCache> makeValCache(int ncids) {
+    auto vcache = std::make_shared<DbValCache>();
+    std::string t0 = "2021-01-01 00:00:00.000000-05:00,test";
+
+    ValTables tables;
+    tables.fill("1,TstCalib1,tst.calib1,"+t0+"\n");
+    vcache->setValTables(tables);
+    ValPurposes purposes;
+    purposes.fill("1,STRESS,stress test,"+t0+"\n");
+    vcache->setValPurposes(purposes);
+    ValVersions versions;
+    versions.fill("1,1,1,1,0,stress test,"+t0+"\n");
+    vcache->setValVersions(versions);
+    ValExtensions extensions;
+    extensions.fill("1,1,0,"+t0+"\n");
+    vcache->setValExtensions(extensions);
+    ValExtensionLists extensionlists;
+    extensionlists.fill("1,1\n");
+    vcache->setValExtensionLists(extensionlists);
+    ValTableLists tablelists;
+    tablelists.fill("1,1\n");
+    vcache->setValTableLists(tablelists);
+
+    std::ostringstream cals, iovs, gls;
+    for(int cid=1; cid<=ncids; cid++) {
+      cals << cid << ",1," << t0 << "\n";
+      iovs << cid << "," << cid << "," << cid << ",0," << cid << ",999999,"
+	   << t0 << "\n";
+      gls << "1," << cid << "\n";
+    }
+    ValCalibrations calibrations;
+    calibrations.fill(cals.str());
+    vcache->setValCalibrations(calibrations);
+    ValIovs valiovs;
+    valiovs.fill(iovs.str());
+    vcache->setValIovs(valiovs);
+    ValGroupLists grouplists;
+    grouplists.fill(gls.str());
+    vcache->setValGroupLists(grouplists);
+
+    return vcache;
+  }
+
+  // stands in for DbReader: waits, then fills the table with rows
+  // that identify the cid
+  class FakeBackend {
+  public:
+    FakeBackend(int latency):_latency(latency),_active(0),_maxActive(0) {}
+
+    int fill(DbTable::ptr_t const& ptr, int cid) {
+      int active = ++_active;
+      int prev = _maxActive;
+      while(active>prev && !_maxActive.compare_exchange_weak(prev,active)) {}
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(_latency));
+      bool fail;
+      {
+	std::lock_guard lock(_mutex);
+	_reads[cid]++;
+	fail = _failOnce.erase(cid)>0;
+      }
+      --_active;
+      if(fail) return 1;
+
+      std::ostringstream csv;
+      csv << "0,1,1.0\n1,2,2.0\n2,3," << cid << "\n";
+      ptr->fill(csv.str());
+      return 0;
+    }
+
+    void failOnce(int cid) { std::lock_guard lock(_mutex); _failOnce.insert(cid); }
+    int reads(int cid) { std::lock_guard lock(_mutex); return _reads[cid]; }
+    int maxActive() const { return _maxActive; }
+
+  private:
+    int _latency;
+    std::atomic<int> _active;
+    std::atomic<int> _maxActive;
+    std::mutex _mutex;
+    std::map<int,int> _reads;
+    std::set<int> _failOnce;
+  };
+
+  // run func(ithread) on nthreads threads, return the wall time in s
+  template <class F>
+  double runThreads(int nthreads, F func) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for(int i=0; i<nthreads; i++) threads.emplace_back(func,i);
+    for(auto& t : threads) t.join();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+  }
+
+}
+
+int main(int argc, char**argv) {
+
+  int nthreads = argc>1 ? std::stoi(argv[1]) : 8;
+  int ncids    = argc>2 ? std::stoi(argv[2]) : 32;
+  int latency  = argc>3 ? std::stoi(argv[3]) : 100;
+
+  // the last two cids are used by the shared and failure tests
+  int nspread = ncids-2;
+  int sharedCid = ncids-1;
+  int failCid = ncids;
+
+  FakeBackend backend(latency);
+  DbEngine engine;
+  engine.setDbId(DbId("fake","localhost","0","none","none"));
+  engine.setVersion(DbVersion("STRESS",1,0,0));
+  engine.setCache(makeValCache(ncids));
+  engine.setFetcher([&backend](DbTable::ptr_t const& ptr, int cid) {
+      return backend.fill(ptr,cid); });
+  engine.setVerbose(1);
+  engine.beginJob();
+  int tid = engine.tidByName("TstCalib1");
+
+  std::atomic<int> nerror(0);
+  auto check = [&](DbLiveTable const& lt, int cid) {
+    auto const& t = dynamic_cast<TstCalib1 const&>(lt.table());
+    if(lt.cid()!=cid || int(t.row(2).dToE())!=cid) nerror++;
+  };
+
+  // every thread asks for every table, starting at a different place,
+  // so reads of different cids overlap and most cids are also
+  // requested by several threads at once
+  double tspread = runThreads(nthreads,[&](int ithread) {
+      for(int i=0; i<nspread; i++) {
+	int cid = 1 + (i + ithread*nspread/nthreads)%nspread;
+	check(engine.update(tid,cid,0),cid);
+      }
+    });
+
+  // all threads ask for the same table at once
+  double tshared = runThreads(nthreads,[&](int ithread) {
+      check(engine.update(tid,sharedCid,0),sharedCid);
+    });
+
+  // the first read fails; all threads waiting on it must see the error
+  backend.failOnce(failCid);
+  std::atomic<int> nthrown(0);
+  runThreads(nthreads,[&](int ithread) {
+      try {
+	engine.update(tid,failCid,0);
+      } catch (cet::exception const&) {
+	nthrown++;
+      }
+    });
+  // and the table can be read later
+  check(engine.update(tid,failCid,0),failCid);
+
+  int nbad = 0;
+  for(int cid=1; cid<=ncids; cid++) {
+    int expected = cid==failCid ? 2 : 1;
+    if(backend.reads(cid)!=expected) {
+      std::cout << "cid " << cid << " was read " << backend.reads(cid)
+		<< " times, expected " << expected << std::endl;
+      nbad++;
+    }
+  }
+
+  std::cout << "dbEngineStress: " << nthreads << " threads, "
+	    << nspread << " cids, " << latency << " ms latency" << std::endl;
+  std::cout << "  all cids:   " << tspread << " s, serial reads would take "
+	    << nspread*latency*1.0e-3 << " s, max concurrent reads "
+	    << backend.maxActive() << std::endl;
+  std::cout << "  shared cid: " << tshared << " s" << std::endl;
+  std::cout << "  failed read seen by " << nthrown << " threads" << std::endl;
+  engine.endJob();
+
+  // a new engine, all tables read up front
+  FakeBackend pbackend(latency);
+  DbEngine pengine;
+  pengine.setDbId(DbId("fake","localhost","0","none","none"));
+  pengine.setVersion(DbVersion("STRESS",1,0,0));
+  pengine.setCache(makeValCache(ncids));
+  pengine.setFetcher([&pbackend](DbTable::ptr_t const& ptr, int cid) {
+      return pbackend.fill(ptr,cid); });
+  pengine.setPrefetch(4,nthreads);
+  pengine.beginJob();
+
+  auto pstart = std::chrono::steady_clock::now();
+  int nprefetch = pengine.prefetch(1,ncids);
+  auto pend = std::chrono::steady_clock::now();
+  double tprefetch = std::chrono::duration<double>(pend - pstart).count();
+
+  double tafter = runThreads(nthreads,[&](int ithread) {
+      for(int cid=1; cid<=ncids; cid++) {
+	check(pengine.update(tid,cid,0),cid);
+      }
+    });
+  for(int cid=1; cid<=ncids; cid++) {
+    if(pbackend.reads(cid)!=1) {
+      std::cout << "prefetch: cid " << cid << " was read " 
+		<< pbackend.reads(cid) << " times, expected 1" << std::endl;
+      nbad++;
+    }
+  }
+  std::cout << "  prefetch:   " << nprefetch << " tables in " << tprefetch 
+	    << " s, then all requests in " << tafter << " s" << std::endl;
+
+  // two jobs sharing a disk cache, the second can't reach the database
+  char dirTemplate[] = "/tmp/dbEngineStressXXXXXX";
+  std::string diskDir = mkdtemp(dirTemplate);
+  int ndisk[2] = {0,0};
+  for(int job=0; job<2; job++) {
+    FakeBackend dbackend(job==0 ? latency : 0);
+    for(int cid=1; cid<=ncids && job==1; cid++) dbackend.failOnce(cid);
+    DbEngine dengine;
+    dengine.setDbId(DbId("fake","localhost","0","none","none"));
+    dengine.setVersion(DbVersion("STRESS",1,0,0));
+    dengine.setCache(makeValCache(ncids));
+    dengine.setFetcher([&dbackend](DbTable::ptr_t const& ptr, int cid) {
+	return dbackend.fill(ptr,cid); });
+    dengine.setDiskCache(diskDir);
+    dengine.setPrefetch(4,nthreads);
+    dengine.beginJob();
+    dengine.prefetch(1,ncids);
+    for(int cid=1; cid<=ncids; cid++) {
+      check(dengine.update(tid,cid,0),cid);
+      ndisk[job] += dbackend.reads(cid);
+    }
+  }
+  std::string rm = "rm -rf " + diskDir;
+  if(std::system(rm.c_str())!=0) std::cout << "failed: " << rm << std::endl;
+  std::cout << "  disk cache: " << ndisk[0] << " database reads in the first job, "
+	    << ndisk[1] << " in the second" << std::endl;
+  if(ndisk[0]!=ncids || ndisk[1]!=0) nbad++;
+
+  // a cache limited to about four tables, one table held throughout
+  FakeBackend lbackend(0);
+  DbEngine lengine;
+  lengine.setDbId(DbId("fake","localhost","0","none","none"));
+  lengine.setVersion(DbVersion("STRESS",1,0,0));
+  lengine.setCache(makeValCache(ncids));
+  lengine.setFetcher([&lbackend](DbTable::ptr_t const& ptr, int cid) {
+      return lbackend.fill(ptr,cid); });
+  lengine.setVerbose(1);
+  lengine.beginJob();
+  DbLiveTable held = lengine.update(tid,1,0);
+  std::size_t tableSize = held.table().size();
+  lengine.setCacheLimit(4*tableSize);
+  for(int pass=0; pass<2; pass++) {
+    for(int cid=2; cid<=ncids; cid++) check(lengine.update(tid,cid,0),cid);
+  }
+  check(lengine.update(tid,1,0),1);
+  std::cout << "  cache limit " << 4*tableSize << " b: " 
+	    << lbackend.reads(1) << " reads of the held table, " 
+	    << lbackend.reads(2) << " of the others" << std::endl;
+  lengine.endJob();
+  if(lbackend.reads(1)!=1 || lbackend.reads(2)!=2) nbad++;
+
+  bool ok = nbad==0 && nerror==0 && nthrown>0 && nprefetch==ncids
+    && (nthreads==1 || backend.maxActive()>1);
+  std::cout << (ok ? "dbEngineStress passed" : "dbEngineStress FAILED")
+	    << std::endl;
+  return ok ? 0 : 1;
+}
@@ -34,7 +34,7 @@ namespace mu2e {
     std::vector<Row> const& rows()    const { return _rows;}
     std::size_t             nrow()    const { return _rows.size(); };
     virtual std::size_t     nrowFix() const { return CaloId::_nCrystalChannel; }; 
-    size_t                  size()    const { return baseSize() + nrow()*sizeof(Row); };
+    size_t                  size()    const { return sizeof(*this) - sizeof(DbTable) + baseSize() + vectorSize(_rows); };
     
     void addRow(const std::vector<std::string>& columns) override {
       _rows.emplace_back(std::stoi(columns[0]),
@@ -46,6 +46,11 @@ namespace mu2e {
       sstream << r.offlineID()<<","<<r.diracID();
     }
     
+    std::size_t binaryRowSize() const override { return sizeof(Row); }
+    const void* binaryRows() const override { return _rows.data(); }
+    void fillBinary(const void* data, std::size_t nrow) override {
+      baseClear(); assignBinary(_rows,data,nrow); }
+
     virtual void clear() override { baseClear(); _rows.clear(); }
     
   private:
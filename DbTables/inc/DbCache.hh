@@ -1,9 +1,23 @@
 #ifndef DbTables_DbCache_hh
 #define DbTables_DbCache_hh
 
+//
+// Tables read from the database, by cid.  The memory of each table
+// is recorded when it is added, and purge removes the least recently
+// used tables until the total is under a target.  Tables still held
+// outside the cache, such as the current IoV in a DbHandle, are pinned:
+// removing them would free no memory and they would likely be needed
+// again.
+//
+// get may be called by many threads at once (under a shared lock
+// in DbEngine), the other methods need exclusive access.
+//
+
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <atomic>
+#include <tuple>
 #include "Offline/DbTables/inc/DbTable.hh"
 
 namespace mu2e {
@@ -11,22 +25,53 @@ namespace mu2e {
   class DbCache {
   public:
 
-    typedef std::map<int,mu2e::DbTable::cptr_t> table_map;
+    DbCache():_useClock(0),_bytes(0),_peakBytes(0),
+	      _hits(0),_misses(0),_evictions(0),_evictedBytes(0) {}
 
     void add(int cid, mu2e::DbTable::cptr_t const& ptr);
 
-    bool hasTable(int cid) { return _tables.find(cid)!=_tables.end(); }
+    bool hasTable(int cid) const { return _tables.find(cid)!=_tables.end(); }
     
-    mu2e::DbTable::cptr_t get(int cid);
+    // return the table, or null, and count a hit or miss
+    mu2e::DbTable::cptr_t get(int cid, bool count=true);
 
-    void clear() { _tables.clear(); }
+    void clear();
+    // if the total size is over 1.1*target, remove unpinned tables
+    // in least recently used order until it is under target.
+    // Returns the number of tables removed.
     int purge(const size_t target=200000000);
-    size_t size();
+    size_t size() const { return _bytes; }
     void print() const;
 
+    std::size_t ntable() const { return _tables.size(); }
+    std::size_t peakSize() const { return _peakBytes; }
+    long hits() const { return _hits; }
+    long misses() const { return _misses; }
+    long evictions() const { return _evictions; }
+    std::size_t evictedSize() const { return _evictedBytes; }
+
   private:
+
+    struct Entry {
+      Entry(mu2e::DbTable::cptr_t const& ptr, std::size_t bytes, 
+	    uint64_t use):_ptr(ptr),_bytes(bytes),_lastUse(use) {}
+      mu2e::DbTable::cptr_t _ptr;
+      std::size_t _bytes;
+      // updated in get, under a shared lock
+      std::atomic<uint64_t> _lastUse;
+    };
+
+    typedef std::map<int,Entry> table_map;
     table_map _tables;
 
+    std::atomic<uint64_t> _useClock;
+    std::size_t _bytes;
+    std::size_t _peakBytes;
+    std::atomic<long> _hits;
+    std::atomic<long> _misses;
+    long _evictions;
+    std::size_t _evictedBytes;
+
   };
 
 }
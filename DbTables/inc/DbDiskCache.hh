@@ -0,0 +1,72 @@
+#ifndef DbTables_DbDiskCache_hh
+#define DbTables_DbDiskCache_hh
+//
+// A local disk copy of calibration tables, one file per cid, so jobs
+// can start without network access.  The content of a cid never
+// changes, so files never need to be updated, only added.
+//
+// Tables which provide binaryRows() (see DbTable) are written as the
+// memory image of their rows, and read back by mapping the file and
+// copying the rows, with no text parsing.  Other tables are written
+// as their csv text, if it was saved, and filled through the usual
+// DbTable::fill.
+// A file is only used if the table name, column list and row size
+// match what it was written with, otherwise it counts as a miss.
+//
+// Files are written to a temporary name and renamed, so several jobs
+// can share a directory.  Write errors are ignored, it is only a cache.
+//
+
+#include <string>
+#include <atomic>
+#include "Offline/DbTables/inc/DbTable.hh"
+
+namespace mu2e {
+
+  class DbDiskCache {
+  public:
+
+    DbDiskCache():_verbose(0),_hits(0),_misses(0),_writes(0) {}
+    // an empty directory means the cache is not used
+    void setDir(std::string const& dir) { _dir = dir; }
+    std::string const& dir() const { return _dir; }
+    bool enabled() const { return !_dir.empty(); }
+    void setVerbose(int verbose) { _verbose = verbose; }
+
+    // fill the table for cid from disk, return true if it was found
+    bool read(DbTable::ptr_t const& ptr, int cid, bool saveCsv=false);
+    // save the table for cid, if it isn't already on disk
+    void write(DbTable const& table, int cid);
+
+    int hits() const { return _hits; }
+    int misses() const { return _misses; }
+    int writes() const { return _writes; }
+
+  private:
+
+    // start of each file
+    struct Header {
+      char magic[8];
+      uint32_t version;
+      uint32_t binary;    // 1 if rows are binary, 0 if csv text
+      uint64_t rowSize;   // sizeof(Row) for binary
+      uint64_t nrow;
+      uint64_t nbytes;    // length of the data after the header
+      uint64_t queryHash; // of the column list
+      char name[64];
+    };
+
+    std::string fileName(std::string const& table, int cid) const;
+    static uint64_t hash(std::string const& s);
+    bool makeDir() const;
+
+    std::string _dir;
+    int _verbose;
+    std::atomic<int> _hits;
+    std::atomic<int> _misses;
+    std::atomic<int> _writes;
+  };
+
+}
+
+#endif
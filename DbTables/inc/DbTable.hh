@@ -6,6 +6,8 @@
 #include <memory>
 #include <sstream>
 #include <cstdint>
+#include <map>
+#include <type_traits>
 
 namespace mu2e {
 
@@ -37,7 +39,10 @@ namespace mu2e {
     virtual std::size_t nrowFix() const { return 0; }
     // approx size in bytes - overridden by derived class
     virtual std::size_t size() const =0;
-    std::size_t baseSize() const { return _csv.capacity(); }
+    // this object and the memory held by its strings
+    std::size_t baseSize() const { return sizeof(DbTable) + 
+	stringSize(_name) + stringSize(_dbname) + 
+	stringSize(_query) + stringSize(_csv); }
 
     // take the cvs text from a query and build out the table contents
     int fill(const std::string& csv, bool saveCsv=true);
@@ -52,6 +57,38 @@ namespace mu2e {
     virtual void clear() =0;
     void baseClear() { _csv.clear(); }
 
+    // the rows as one block of memory, for the local disk cache 
+    // (DbDiskCache).  Tables whose rows are plain numbers override
+    // these, others are cached as csv.  The size of a row, or 0 if 
+    // the table can't be stored this way
+    virtual std::size_t binaryRowSize() const { return 0; }
+    virtual const void* binaryRows() const { return nullptr; }
+    // replace the content by nrow rows copied from data 
+    virtual void fillBinary(const void* data, std::size_t nrow) {}
+
+  protected:
+    // memory held by members, for size() 
+    static std::size_t stringSize(std::string const& s) {
+      // short strings are stored in the string object
+      return s.capacity()>15 ? s.capacity()+1 : 0; }
+    template<class ROW>
+    static std::size_t vectorSize(std::vector<ROW> const& v) {
+      return v.capacity()*sizeof(ROW); }
+    template<class K, class V>
+    static std::size_t mapSize(std::map<K,V> const& m) {
+      // each node holds the value, a color and three pointers
+      return m.size()*(sizeof(std::pair<const K,V>) + 4*sizeof(void*)); }
+
+    // for fillBinary: the rows are copied, not parsed
+    template<class ROW>
+    static void assignBinary(std::vector<ROW>& rows, 
+			     const void* data, std::size_t nrow) {
+      static_assert(std::is_trivially_copyable<ROW>::value,
+		    "binary table rows must be trivially copyable");
+      ROW const* first = static_cast<ROW const*>(data);
+      rows.assign(first,first+nrow);
+    }
+
   private:
     std::string _name;
     std::string _dbname;
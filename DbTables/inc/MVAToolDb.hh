@@ -48,8 +48,11 @@ namespace mu2e {
     const Row& row(const int idx) const { return _rows.at(idx); }
     std::vector<Row> const& rows() const {return _rows;}
     std::size_t nrow() const override { return _rows.size(); };
-    size_t size() const override { return baseSize() + 
-	+ nrow()*nrow()/2 + nrow()*sizeof(Row); };
+    size_t size() const override { 
+      size_t b = sizeof(*this) - sizeof(DbTable) + baseSize() + vectorSize(_rows);
+      for(auto const& r : _rows) b += stringSize(r.mvaname()) + stringSize(r.xmlfilename());
+      return b;
+    };
 
     void addRow(const std::vector<std::string>& columns) override {
       int idx = std::stoi(columns[0]);
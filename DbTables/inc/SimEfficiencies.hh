@@ -42,7 +42,11 @@ namespace mu2e {
     std::vector<Row> const& rows() const {return _rows;}
     std::size_t nrow() const override { return _rows.size(); };
     //    virtual std::size_t nrowFix() const { return 3; };
-    size_t size() const override { return baseSize() + nrow()*sizeof(Row); };
+    size_t size() const override { 
+      size_t b = sizeof(*this) - sizeof(DbTable) + baseSize() + vectorSize(_rows);
+      for(auto const& r : _rows) b += stringSize(r.tag());
+      return b;
+    };
 
     void addRow(const std::vector<std::string>& columns) override {
       //      int idx = std::stoi(columns[0]);
@@ -26,7 +26,7 @@ namespace mu2e {
     std::vector<TrkAlignParams> const& rows() const {return _rows;}
     std::size_t nrow() const override { return _rows.size(); };
     std::size_t nrowFix() const override { return _nrows; };
-    size_t size() const override { return baseSize() + nrow()*sizeof(TrkAlignParams); };
+    size_t size() const override { return sizeof(*this) - sizeof(DbTable) + baseSize() + vectorSize(_rows); };
 
     void addRow(const std::vector<std::string>& columns) override {
       _rows.emplace_back(std::stoi(columns[0]),
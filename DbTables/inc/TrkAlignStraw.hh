@@ -25,7 +25,7 @@ namespace mu2e {
     std::vector<TrkStrawEndAlign> const& rows() const {return _rows;}
     size_t nrow() const override { return _rows.size(); };
     size_t nrowFix() const override { return StrawId::_nustraws; };
-    size_t size() const override { return baseSize() + nrow()*sizeof(TrkStrawEndAlign); };
+    size_t size() const override { return sizeof(*this) - sizeof(DbTable) + baseSize() + vectorSize(_rows); };
 
     void addRow(const std::vector<std::string>& columns) override {
       _rows.emplace_back(
@@ -56,6 +56,11 @@ namespace mu2e {
       sstream << r._straw_hv_dW;
     }
 
+    std::size_t binaryRowSize() const override { return sizeof(TrkStrawEndAlign); }
+    const void* binaryRows() const override { return _rows.data(); }
+    void fillBinary(const void* data, std::size_t nrow) override {
+      baseClear(); assignBinary(_rows,data,nrow); }
+
     virtual void clear() { baseClear(); _rows.clear(); }
 
   private:
@@ -37,7 +37,7 @@ namespace mu2e {
     std::vector<Row> const& rows() const {return _rows;}
     std::size_t nrow() const override { return _rows.size(); };
     virtual std::size_t nrowFix() const override { return 96; }; 
-    size_t size() const override { return baseSize() + nrow()*sizeof(Row); };
+    size_t size() const override { return sizeof(*this) - sizeof(DbTable) + baseSize() + vectorSize(_rows); };
 
     void addRow(const std::vector<std::string>& columns) override {
       int straw = std::stoi(columns[0]);
@@ -61,6 +61,11 @@ namespace mu2e {
       sstream << r.delayCal();
     }
 
+    std::size_t binaryRowSize() const override { return sizeof(Row); }
+    const void* binaryRows() const override { return _rows.data(); }
+    void fillBinary(const void* data, std::size_t nrow) override {
+      baseClear(); assignBinary(_rows,data,nrow); }
+
     virtual void clear() override { baseClear(); _rows.clear(); }
 
   private:
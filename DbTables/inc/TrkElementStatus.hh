@@ -41,7 +41,7 @@ namespace mu2e {
     std::vector<TrkElementStatusRow> const& rows() const {return _rows;}
     std::size_t nrow() const override { return _rows.size(); };
     // this is a variable-size table, so don't overrido nrowFix()
-    size_t size() const override { return baseSize() + nrow()*sizeof(TrkElementStatusRow); }
+    size_t size() const override { return sizeof(*this) - sizeof(DbTable) + baseSize() + vectorSize(_rows); }
     // table-specific info
     StrawIdMask const& sidMask() const { return _sidmask; }
     StrawStatus const& statusMask() const { return _statusmask; }
@@ -37,8 +37,8 @@ namespace mu2e {
     std::size_t nrow() const override { return _rows.size(); };
     //this table should always be 3 rows
     virtual std::size_t nrowFix() const override { return 3; }; 
-    size_t size() const override { return baseSize() + 
-	nrow()*nrow()/2 + nrow()*sizeof(Row); };
+    size_t size() const override { return sizeof(*this) - sizeof(DbTable) + baseSize() + 
+	vectorSize(_rows) + mapSize(_chanIndex); };
 
     void addRow(const std::vector<std::string>& columns) override {
       int channel = std::stoi(columns[0]);
@@ -62,6 +62,15 @@ namespace mu2e {
       sstream << std::fixed << std::setprecision(3) << r.dToE();
     }
 
+    std::size_t binaryRowSize() const override { return sizeof(Row); }
+    const void* binaryRows() const override { return _rows.data(); }
+    void fillBinary(const void* data, std::size_t nrow) override {
+      baseClear();
+      assignBinary(_rows,data,nrow);
+      _chanIndex.clear();
+      for(std::size_t i=0; i<_rows.size(); i++) _chanIndex[_rows[i].channel()] = i;
+    }
+
     virtual void clear() override { baseClear(); _rows.clear(); _chanIndex.clear();}
 
   private:
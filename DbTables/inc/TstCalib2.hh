@@ -33,10 +33,10 @@ namespace mu2e {
                 return _rows.at(_chanIndex.at(channel)); }
     std::vector<Row> const& rows() const {return _rows;}
     std::size_t nrow() const override { return _rows.size(); };
-    // this is not quite right with strings...
     size_t size() const override { 
-      size_t b = baseSize() + nrow()*nrow()/2 + nrow()*sizeof(Row); 
-      for(auto const& r : _rows) b += r.status().capacity(); 
+      size_t b = sizeof(*this) - sizeof(DbTable) + baseSize() + 
+	vectorSize(_rows) + mapSize(_chanIndex);
+      for(auto const& r : _rows) b += stringSize(r.status());
       return b;
     };
 
@@ -54,7 +54,8 @@ namespace mu2e {
                 return _rows.at(_chanIndex.at(channel)); }
     std::vector<Row> const& rows() const {return _rows;}
     std::size_t nrow() const override { return _rows.size(); };
-    size_t size() const override { return baseSize() + nrow()*nrow()/2 + nrow()*sizeof(Row); };
+    size_t size() const override { return sizeof(*this) - sizeof(DbTable) + baseSize() + 
+	vectorSize(_rows) + mapSize(_chanIndex); };
 
     void addRow(const std::vector<std::string>& columns) override {
       _rows.emplace_back(std::stoul(columns[0]),
@@ -87,6 +88,15 @@ namespace mu2e {
       sstream << r.v9();
     }
 
+    std::size_t binaryRowSize() const override { return sizeof(Row); }
+    const void* binaryRows() const override { return _rows.data(); }
+    void fillBinary(const void* data, std::size_t nrow) override {
+      baseClear();
+      assignBinary(_rows,data,nrow);
+      _chanIndex.clear();
+      for(std::size_t i=0; i<_rows.size(); i++) _chanIndex[_rows[i].channel()] = i;
+    }
+
     virtual void clear() override { baseClear(); _rows.clear(); _chanIndex.clear();}
 
   private:
@@ -1,37 +1,67 @@
 #include <algorithm>
+#include <vector>
 #include "Offline/DbTables/inc/DbCache.hh"
 
 void mu2e::DbCache::add(int cid, mu2e::DbTable::cptr_t const& ptr) { 
-  _tables[cid] = ptr;
+  auto it = _tables.find(cid);
+  if(it != _tables.end()) {
+    _bytes -= it->second._bytes;
+    _tables.erase(it);
+  }
+  // tables are not changed once in the cache, so the size is fixed
+  std::size_t bytes = ptr->size();
+  _tables.emplace(std::piecewise_construct, std::forward_as_tuple(cid),
+		  std::forward_as_tuple(ptr,bytes,++_useClock));
+  _bytes += bytes;
+  _peakBytes = std::max(_peakBytes,_bytes);
 }
 
-mu2e::DbTable::cptr_t mu2e::DbCache::get(int cid) {
+mu2e::DbTable::cptr_t mu2e::DbCache::get(int cid, bool count) {
   auto it = _tables.find(cid);
   if(it != _tables.end()) {
-    return it->second;
+    if(count) _hits++;
+    it->second._lastUse.store(++_useClock,std::memory_order_relaxed);
+    return it->second._ptr;
   } else {
+    if(count) _misses++;
     return mu2e::DbTable::cptr_t(nullptr);
   }
 }
 
+void mu2e::DbCache::clear() {
+  _tables.clear();
+  _bytes = 0;
+}
+
 int mu2e::DbCache::purge(const size_t target) {
-  // loop over tables, remove oldest
-  size_t current = size();
-  if(current<1.1*target) return 0;
+  if(_bytes<1.1*target) return 0;
 
-  return 0;
-}
+  // candidates, oldest first
+  std::vector<std::pair<uint64_t,int>> order;
+  for(auto const& t : _tables) {
+    // held elsewhere, removing it would not free memory
+    if(t.second._ptr.use_count()>1) continue;
+    order.emplace_back(t.second._lastUse.load(),t.first);
+  }
+  std::sort(order.begin(),order.end());
 
-size_t mu2e::DbCache::size() {
-  size_t s=0;
-  for(auto const& t : _tables) s += t.second->size();
-  return s;
+  int n = 0;
+  for(auto const& o : order) {
+    if(_bytes<=target) break;
+    auto it = _tables.find(o.second);
+    _bytes -= it->second._bytes;
+    _evictedBytes += it->second._bytes;
+    _tables.erase(it);
+    n++;
+  }
+  _evictions += n;
+  return n;
 }
 
-
 void mu2e::DbCache::print() const {
-  for(auto t: _tables) {
+  for(auto const& t: _tables) {
     std::cout << std::setw(6) << t.first << " " 
-	      << std::setw(15) << t.second->name() << std::endl;
+	      << std::setw(15) << t.second._ptr->name() 
+	      << std::setw(12) << t.second._bytes << std::endl;
   }
 }
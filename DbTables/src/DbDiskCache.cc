@@ -0,0 +1,157 @@
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Offline/DbTables/inc/DbDiskCache.hh"
+
+namespace {
+  const char magicWord[8] = {'M','U','2','E','D','B','T','1'};
+  const uint32_t formatVersion = 1;
+}
+
+bool mu2e::DbDiskCache::read(DbTable::ptr_t const& ptr, int cid,
+			     bool saveCsv) {
+  if(!enabled()) return false;
+
+  std::string fn = fileName(ptr->name(),cid);
+  int fd = open(fn.c_str(),O_RDONLY);
+  if(fd<0) {
+    _misses++;
+    return false;
+  }
+
+  struct stat st;
+  void* map = MAP_FAILED;
+  if(fstat(fd,&st)==0 && st.st_size>=off_t(sizeof(Header))) {
+    map = mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+  }
+  close(fd); // the mapping stays valid
+  if(map == MAP_FAILED) {
+    _misses++;
+    return false;
+  }
+
+  Header const& h = *static_cast<Header const*>(map);
+  const char* data = static_cast<const char*>(map) + sizeof(Header);
+  bool ok = memcmp(h.magic,magicWord,sizeof(magicWord))==0
+    && h.version == formatVersion
+    && sizeof(Header) + h.nbytes == std::size_t(st.st_size)
+    && strncmp(h.name,ptr->name().c_str(),sizeof(h.name))==0
+    && h.queryHash == hash(ptr->query());
+  if(ok && h.binary) {
+    ok = h.rowSize == ptr->binaryRowSize() && h.rowSize>0
+      && h.nrow*h.rowSize == h.nbytes;
+  }
+
+  if(ok) {
+    try {
+      if(h.binary) {
+	ptr->fillBinary(data,h.nrow);
+	if(saveCsv) ptr->toCsv();
+      } else {
+	ptr->fill(std::string(data,h.nbytes),saveCsv);
+      }
+      // same check as DbTable::fill
+      if(ptr->nrowFix()>0 && ptr->nrow()!=ptr->nrowFix()) ok = false;
+    } catch (std::exception const&) {
+      ok = false;
+    }
+    if(!ok) ptr->clear();
+  }
+  munmap(map,st.st_size);
+
+  if(ok) {
+    _hits++;
+  } else {
+    _misses++;
+    if(_verbose>0) std::cout << "DbDiskCache ignoring bad or old file "
+			     << fn << std::endl;
+  }
+  return ok;
+}
+
+void mu2e::DbDiskCache::write(DbTable const& table, int cid) {
+  if(!enabled()) return;
+
+  std::string fn = fileName(table.name(),cid);
+  if(access(fn.c_str(),F_OK)==0) return; // already there
+  if(!makeDir()) return;
+
+  Header h;
+  memset(&h,0,sizeof(h));
+  memcpy(h.magic,magicWord,sizeof(magicWord));
+  h.version = formatVersion;
+  strncpy(h.name,table.name().c_str(),sizeof(h.name)-1);
+  h.queryHash = hash(table.query());
+
+  const char* data;
+  std::string csv;
+  if(table.binaryRowSize()>0) {
+    h.binary = 1;
+    h.rowSize = table.binaryRowSize();
+    h.nrow = table.nrow();
+    h.nbytes = h.nrow*h.rowSize;
+    data = static_cast<const char*>(table.binaryRows());
+  } else {
+    // the text as read from the database, rowToCsv may round
+    if(table.csv().empty()) return;
+    csv = table.csv();
+    h.binary = 0;
+    h.nrow = table.nrow();
+    h.nbytes = csv.size();
+    data = csv.data();
+  }
+
+  // write to a unique name, then move it into place in one step,
+  // so a reader never sees a partial file
+  std::string tmp = fn + ".tmp" + std::to_string(getpid()) + "_"
+    + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&h),sizeof(h));
+    if(h.nbytes>0) out.write(data,h.nbytes);
+    if(!out) {
+      out.close();
+      unlink(tmp.c_str());
+      return;
+    }
+  }
+  if(rename(tmp.c_str(),fn.c_str())!=0) {
+    unlink(tmp.c_str());
+    return;
+  }
+  _writes++;
+  if(_verbose>1) std::cout << "DbDiskCache wrote " << fn << std::endl;
+}
+
+std::string mu2e::DbDiskCache::fileName(std::string const& table,
+					int cid) const {
+  return _dir + "/" + std::to_string(cid) + "_" + table + ".dbt";
+}
+
+// FNV-1a
+uint64_t mu2e::DbDiskCache::hash(std::string const& s) {
+  uint64_t h = 14695981039346656037ULL;
+  for(unsigned char c : s) {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+// make the directory and its parents, as needed
+bool mu2e::DbDiskCache::makeDir() const {
+  std::size_t pos = 0;
+  do {
+    pos = _dir.find('/',pos+1);
+    std::string d = _dir.substr(0,pos);
+    if(mkdir(d.c_str(),0775)!=0 && errno!=EEXIST) return false;
+  } while(pos!=std::string::npos);
+  return true;
+}
@@ -34,7 +34,7 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art_root_io/TFileService.h"
 
-#include "Offline/GeneralUtilities/inc/KNearestNeighbors.hh"
+#include "Offline/GeneralUtilities/inc/KdTreeNeighbors.hh"
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
 #include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/ExtinctionMonitorFNAL/Geometry/inc/ExtMonFNAL.hh"
@@ -267,13 +267,13 @@ namespace mu2e {
       }
 
       //================================================================
-      template<class Point>
-      std::ostream& operator<<(std::ostream& os, const KNearestNeighbors<Point>& knn) {
+      template<class Point, unsigned DIM>
+      std::ostream& operator<<(std::ostream& os, const KdTreeNeighbors<Point,DIM>& knn) {
         os<<"KNearestNeighbors: {\n";
         for(unsigned i=0; i<knn.size(); ++i) {
           os<<"    particle "<<i<<": ";
           for(unsigned j=0; j<knn[i].size(); ++j) {
-            const typename KNearestNeighbors<Point>::Entry ee = knn[i][j];
+            const typename KdTreeNeighbors<Point,DIM>::Entry ee = knn[i][j];
             os<<*ee.point<<" "<<ee.distance<<", ";
             //os<<knn[i][j]<<", ";
           }
@@ -329,7 +329,7 @@ namespace mu2e {
       void writeParticleNtuple();
 
       ParticleRandomization computeParticleRandomization(const InputParticle *p,
-                                                         const KNearestNeighbors<const InputParticle*>::Points& neighbors);
+                                                         const KdTreeNeighbors<const InputParticle*,2>::Points& neighbors);
 
       typedef std::map<std::pair<VirtualDetectorId,ParticleType>, HistRandomization> HistMapRandomization;
       HistMapRandomization histRandomization_;
@@ -487,6 +487,8 @@ namespace mu2e {
     public:
       virtual ~Metric() {}
       virtual double operator()(const InputParticle *a, const InputParticle *b) const =0;
+      // the coordinates the distance is computed from, for KdTreeNeighbors
+      virtual std::array<double,2> coordinates(const InputParticle *a) const =0;
     };
 
     class MetricXY : virtual public Metric {
@@ -496,6 +498,9 @@ namespace mu2e {
         const double dy = a->posExtMon.y() - b->posExtMon.y();
         return sqrt(dx*dx + dy*dy);
       }
+      virtual std::array<double,2> coordinates(const InputParticle *a) const {
+        return {a->posExtMon.x(), a->posExtMon.y()};
+      }
     };
 
     class MetricYZ : virtual public Metric {
@@ -505,6 +510,9 @@ namespace mu2e {
         const double dz = a->posExtMon.z() - b->posExtMon.z();
         return sqrt(dy*dy + dz*dz);
       }
+      virtual std::array<double,2> coordinates(const InputParticle *a) const {
+        return {a->posExtMon.y(), a->posExtMon.z()};
+      }
     };
 
     class MetricZX : virtual public Metric {
@@ -514,6 +522,9 @@ namespace mu2e {
         const double dz = a->posExtMon.z() - b->posExtMon.z();
         return sqrt(dx*dx + dz*dz);
       }
+      virtual std::array<double,2> coordinates(const InputParticle *a) const {
+        return {a->posExtMon.x(), a->posExtMon.z()};
+      }
     };
 
     void EMFBoxFluxAnalyzer::computeParticleRandomizations() {
@@ -539,8 +550,11 @@ namespace mu2e {
             struct tms st_cpu;
             const clock_t st_time = times(&st_cpu);
 
-            KNearestNeighbors<const InputParticle*>
-              neighbors(numNeighbors_, group, *dist[st % 3]);
+            const Metric& metric = *dist[st % 3];
+            KdTreeNeighbors<const InputParticle*,2>
+              neighbors(numNeighbors_, group,
+                        [&metric](const InputParticle *p) { return metric.coordinates(p); },
+                        metric);
 
             struct tms en_cpu;
             const clock_t en_time = times(&en_cpu);
@@ -575,7 +589,7 @@ namespace mu2e {
     //================================================================
     ParticleRandomization
     EMFBoxFluxAnalyzer::computeParticleRandomization(const InputParticle *particle,
-                                                     const KNearestNeighbors<const InputParticle*>::Points& neighbors)
+                                                     const KdTreeNeighbors<const InputParticle*,2>::Points& neighbors)
     {
       double sumSin2Theta(0);
       CLHEP::HepMatrix tmp(3,3);
@@ -33,7 +33,7 @@
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art_root_io/TFileService.h"
 
-#include "Offline/GeneralUtilities/inc/KNearestNeighbors.hh"
+#include "Offline/GeneralUtilities/inc/KdTreeNeighbors.hh"
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
 #include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/ProtonBeamDumpGeom/inc/ProtonBeamDump.hh"
@@ -104,13 +104,13 @@ namespace mu2e {
       typedef std::vector<ParticleRandomization> ParticleRandomizations;
 
       //================================================================
-      template<class Point>
-      std::ostream& operator<<(std::ostream& os, const KNearestNeighbors<Point>& knn) {
+      template<class Point, unsigned DIM>
+      std::ostream& operator<<(std::ostream& os, const KdTreeNeighbors<Point,DIM>& knn) {
         os<<"KNearestNeighbors: {\n";
         for(unsigned i=0; i<knn.size(); ++i) {
           os<<"    particle "<<i<<": ";
           for(unsigned j=0; j<knn[i].size(); ++j) {
-            const typename KNearestNeighbors<Point>::Entry ee = knn[i][j];
+            const typename KdTreeNeighbors<Point,DIM>::Entry ee = knn[i][j];
             os<<*ee.point<<" "<<ee.distance<<", ";
             //os<<knn[i][j]<<", ";
           }
@@ -159,7 +159,7 @@ namespace mu2e {
       void writeParticleNtuple();
 
       ParticleRandomization computeParticleRandomization(const InputParticle *p,
-                                                         const KNearestNeighbors<const InputParticle*>::Points& neighbors);
+                                                         const KdTreeNeighbors<const InputParticle*,2>::Points& neighbors);
 
     public:
       explicit EMFRoomFluxAnalyzer(const fhicl::ParameterSet& pset);
@@ -333,6 +333,8 @@ namespace mu2e {
     public:
       virtual ~Metric() {}
       virtual double operator()(const InputParticle *a, const InputParticle *b) const =0;
+      // the coordinates the distance is computed from, for KdTreeNeighbors
+      virtual std::array<double,2> coordinates(const InputParticle *a) const =0;
     };
 
     class MetricXY : virtual public Metric {
@@ -342,6 +344,9 @@ namespace mu2e {
         const double dy = a->posDump.y() - b->posDump.y();
         return sqrt(dx*dx + dy*dy);
       }
+      virtual std::array<double,2> coordinates(const InputParticle *a) const {
+        return {a->posDump.x(), a->posDump.y()};
+      }
     };
 
     class MetricYZ : virtual public Metric {
@@ -351,6 +356,9 @@ namespace mu2e {
         const double dz = a->posDump.z() - b->posDump.z();
         return sqrt(dy*dy + dz*dz);
       }
+      virtual std::array<double,2> coordinates(const InputParticle *a) const {
+        return {a->posDump.y(), a->posDump.z()};
+      }
     };
 
     class MetricZX : virtual public Metric {
@@ -360,6 +368,9 @@ namespace mu2e {
         const double dz = a->posDump.z() - b->posDump.z();
         return sqrt(dx*dx + dz*dz);
       }
+      virtual std::array<double,2> coordinates(const InputParticle *a) const {
+        return {a->posDump.x(), a->posDump.z()};
+      }
     };
 
     void EMFRoomFluxAnalyzer::computeParticleRandomizations() {
@@ -387,8 +398,11 @@ namespace mu2e {
             struct tms st_cpu;
             const clock_t st_time = times(&st_cpu);
 
-            KNearestNeighbors<const InputParticle*>
-              neighbors(numNeighbors_, group, *dist[st % 3]);
+            const Metric& metric = *dist[st % 3];
+            KdTreeNeighbors<const InputParticle*,2>
+              neighbors(numNeighbors_, group,
+                        [&metric](const InputParticle *p) { return metric.coordinates(p); },
+                        metric);
 
             struct tms en_cpu;
             const clock_t en_time = times(&en_cpu);
@@ -422,7 +436,7 @@ namespace mu2e {
     //================================================================
     ParticleRandomization
     EMFRoomFluxAnalyzer::computeParticleRandomization(const InputParticle *particle,
-                                                      const KNearestNeighbors<const InputParticle*>::Points& neighbors)
+                                                      const KdTreeNeighbors<const InputParticle*,2>::Points& neighbors)
     {
       double sumSin2Theta(0);
       CLHEP::HepMatrix tmp(3,3);
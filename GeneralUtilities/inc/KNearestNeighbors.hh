@@ -2,7 +2,7 @@
 // using the given metric.
 //
 // BEWARE: the current implementation is a naive O(N^2) algorithm.
-// There are much faster ways of doing this.
+// KdTreeNeighbors gives the same results much faster.
 //
 //
 // Original author Andrei Gaponenko
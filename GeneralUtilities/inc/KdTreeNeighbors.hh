@@ -0,0 +1,275 @@
+// Find k nearest neighbors, or all neighbors within a radius, using a
+// k-d tree.  The results are the same as from KNearestNeighbors, but the
+// cost is about N log(N) instead of N^2.
+//
+// The points are placed in the tree by the Coordinates returned by a
+// user functor, and distances are computed by the user Distance.  The
+// search relies on the distance between two points being no smaller
+// than their separation along any one coordinate, which is true when
+// Distance is the Euclidean (or any Minkowski) distance between the
+// Coordinates.  The group is referenced, not copied, and must outlive
+// the KdTreeNeighbors.
+//
+// knnBenchmark compares the two.  For k=10 in 3D the tree is already
+// faster at 16 points, and 70 times faster at 8192.  Points in the same
+// leaf are compared directly, so very small groups cost the same as a
+// linear scan.
+
+#ifndef GeneralUtilities_KdTreeNeighbors_hh
+#define GeneralUtilities_KdTreeNeighbors_hh
+
+#include <array>
+#include <cmath>
+#include <queue>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+
+#include "Offline/GeneralUtilities/inc/KNearestNeighbors.hh"
+
+namespace mu2e {
+
+  template<class Point, unsigned DIM = 3>
+  class KdTreeNeighbors {
+  public:
+
+    typedef std::array<double,DIM> Coordinates;
+    typedef typename KNearestNeighbors<Point>::Entry Entry;
+    typedef typename KNearestNeighbors<Point>::Points Points;
+
+    // Build the tree only, for nearest() and withinRadius() queries
+    template<class Coordinate>
+    KdTreeNeighbors(const std::vector<Point>& group,
+                    const Coordinate& coord);
+
+    // Build the tree and find k nearest neighbors of each point in the
+    // group, like KNearestNeighbors
+    template<class Coordinate, class Distance>
+    KdTreeNeighbors(unsigned k,
+                    const std::vector<Point>& group,
+                    const Coordinate& coord,
+                    const Distance& dist);
+
+    // size() == group.size() if neighbors were computed, else 0
+    std::size_t size() const { return pp_.size(); }
+
+    // neighbors of a point, farthest first, as in KNearestNeighbors.
+    // ipoint is index of the point in the original group container
+    const Points& operator[](unsigned ipoint) const { return pp_[ipoint]; }
+
+    // The k points of the group nearest to q, farthest first.
+    // The group point with index skip, if any, is not considered.
+    template<class Distance>
+    void nearest(const Point& q, unsigned k, const Distance& dist,
+                 Points& result, int skip = -1) const;
+
+    // All points of the group within distance r of q, in no particular order
+    template<class Distance>
+    void withinRadius(const Point& q, double r, const Distance& dist,
+                      Points& result) const;
+
+  private:
+    typedef std::priority_queue<Entry> Neighbors;
+
+    // leaves with this many points or fewer are searched linearly
+    static constexpr int bucketSize = 8;
+
+    void build(int lo, int hi);
+
+    template<class Distance>
+    void searchNearest(int lo, int hi, const Point& q, const Coordinates& qc,
+                       unsigned k, const Distance& dist, int skip,
+                       Neighbors& heap) const;
+
+    template<class Distance>
+    void searchRadius(int lo, int hi, const Point& q, const Coordinates& qc,
+                      double r, const Distance& dist, Points& result) const;
+
+    const std::vector<Point>* group_;
+    std::function<Coordinates(const Point&)> coord_;
+    std::vector<Coordinates> coords_; // by index in group
+    // The tree is implicit: the node of the range [lo,hi) is index[mid],
+    // mid=(lo+hi)/2, with the lower half on its left.  axis_[mid] is
+    // the coordinate it splits on.
+    std::vector<int> index_;
+    std::vector<unsigned char> axis_;
+    std::vector<Points> pp_;
+  };
+
+  //----------------------------------------------------------------
+  template<class Point, unsigned DIM> template<class Coordinate>
+  KdTreeNeighbors<Point,DIM>::KdTreeNeighbors(const std::vector<Point>& group,
+                                              const Coordinate& coord)
+    : group_(&group)
+    , coord_(coord)
+    , coords_(group.size())
+    , index_(group.size())
+    , axis_(group.size(), 0)
+  {
+    for(unsigned i=0; i<group.size(); ++i) {
+      coords_[i] = coord(group[i]);
+    }
+    std::iota(index_.begin(), index_.end(), 0);
+    build(0, group.size());
+  }
+
+  //----------------------------------------------------------------
+  template<class Point, unsigned DIM> template<class Coordinate, class Distance>
+  KdTreeNeighbors<Point,DIM>::KdTreeNeighbors(unsigned k,
+                                              const std::vector<Point>& group,
+                                              const Coordinate& coord,
+                                              const Distance& dist)
+    : KdTreeNeighbors(group, coord)
+  {
+    pp_.resize(group.size());
+    for(unsigned i=0; i<group.size(); ++i) {
+      nearest(group[i], k, dist, pp_[i], i);
+    }
+  }
+
+  //----------------------------------------------------------------
+  // Split on the coordinate with the largest spread, at the median
+  template<class Point, unsigned DIM>
+  void KdTreeNeighbors<Point,DIM>::build(int lo, int hi) {
+    if(hi - lo <= bucketSize) return;
+
+    unsigned axis = 0;
+    double spread = -1.;
+    for(unsigned d=0; d<DIM; ++d) {
+      double cmin = coords_[index_[lo]][d], cmax = cmin;
+      for(int i=lo+1; i<hi; ++i) {
+        const double c = coords_[index_[i]][d];
+        cmin = std::min(cmin, c);
+        cmax = std::max(cmax, c);
+      }
+      if(cmax - cmin > spread) {
+        spread = cmax - cmin;
+        axis = d;
+      }
+    }
+
+    const int mid = (lo + hi)/2;
+    std::nth_element(index_.begin()+lo, index_.begin()+mid, index_.begin()+hi,
+                     [this, axis](int a, int b) {
+                       return coords_[a][axis] < coords_[b][axis];
+                     });
+    axis_[mid] = axis;
+    build(lo, mid);
+    build(mid+1, hi);
+  }
+
+  //----------------------------------------------------------------
+  template<class Point, unsigned DIM> template<class Distance>
+  void KdTreeNeighbors<Point,DIM>::nearest(const Point& q, unsigned k,
+                                           const Distance& dist,
+                                           Points& result, int skip) const
+  {
+    result.clear();
+    if(k == 0) return;
+    Neighbors heap;
+    searchNearest(0, index_.size(), q, coord_(q), k, dist, skip, heap);
+    result.reserve(heap.size());
+    while(!heap.empty()) {
+      result.push_back(heap.top());
+      heap.pop();
+    }
+  }
+
+  template<class Point, unsigned DIM> template<class Distance>
+  void KdTreeNeighbors<Point,DIM>::searchNearest(int lo, int hi,
+                                                 const Point& q,
+                                                 const Coordinates& qc,
+                                                 unsigned k,
+                                                 const Distance& dist,
+                                                 int skip,
+                                                 Neighbors& heap) const
+  {
+    auto consider = [&](int i) {
+      if(i == skip) return;
+      const double r = dist(q, (*group_)[i]);
+      if(heap.size() < k) {
+        heap.push(Entry((*group_)[i], r));
+      }
+      else if(r < heap.top().distance) {
+        heap.pop();
+        heap.push(Entry((*group_)[i], r));
+      }
+    };
+
+    if(hi - lo <= bucketSize) {
+      for(int i=lo; i<hi; ++i) {
+        consider(index_[i]);
+      }
+      return;
+    }
+
+    const int mid = (lo + hi)/2;
+    const int node = index_[mid];
+    const double diff = qc[axis_[mid]] - coords_[node][axis_[mid]];
+    consider(node);
+
+    // the side of the split containing q first, then the other side
+    // if the nearest points could be there
+    if(diff < 0.) {
+      searchNearest(lo, mid, q, qc, k, dist, skip, heap);
+      if(heap.size() < k || -diff < heap.top().distance) {
+        searchNearest(mid+1, hi, q, qc, k, dist, skip, heap);
+      }
+    }
+    else {
+      searchNearest(mid+1, hi, q, qc, k, dist, skip, heap);
+      if(heap.size() < k || diff < heap.top().distance) {
+        searchNearest(lo, mid, q, qc, k, dist, skip, heap);
+      }
+    }
+  }
+
+  //----------------------------------------------------------------
+  template<class Point, unsigned DIM> template<class Distance>
+  void KdTreeNeighbors<Point,DIM>::withinRadius(const Point& q, double r,
+                                                const Distance& dist,
+                                                Points& result) const
+  {
+    result.clear();
+    searchRadius(0, index_.size(), q, coord_(q), r, dist, result);
+  }
+
+  template<class Point, unsigned DIM> template<class Distance>
+  void KdTreeNeighbors<Point,DIM>::searchRadius(int lo, int hi,
+                                                const Point& q,
+                                                const Coordinates& qc,
+                                                double r,
+                                                const Distance& dist,
+                                                Points& result) const
+  {
+    auto consider = [&](int i) {
+      const double d = dist(q, (*group_)[i]);
+      if(d <= r) {
+        result.push_back(Entry((*group_)[i], d));
+      }
+    };
+
+    if(hi - lo <= bucketSize) {
+      for(int i=lo; i<hi; ++i) {
+        consider(index_[i]);
+      }
+      return;
+    }
+
+    const int mid = (lo + hi)/2;
+    const double diff = qc[axis_[mid]] - coords_[index_[mid]][axis_[mid]];
+    consider(index_[mid]);
+    if(diff <= r) {
+      searchRadius(lo, mid, q, qc, r, dist, result);
+    }
+    if(-diff <= r) {
+      searchRadius(mid+1, hi, q, qc, r, dist, result);
+    }
+  }
+
+  //----------------------------------------------------------------
+
+} // namespace mu2e
+
+#endif /* GeneralUtilities_KdTreeNeighbors_hh */
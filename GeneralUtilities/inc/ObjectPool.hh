@@ -0,0 +1,44 @@
+#ifndef GeneralUtilities_ObjectPool_hh
+#define GeneralUtilities_ObjectPool_hh
+//
+// A pool of objects of type T for use within one event, in place of new and
+// delete of each object.  get() returns an object reset to T(); reset()
+// makes all the objects available again in O(1), without destroying them.
+// The storage is allocated in blocks of BlockSize objects, kept until the
+// pool is destroyed, so objects never move and pointers to them stay valid
+// until the next reset().
+//
+
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+namespace mu2e {
+
+  template<class T, std::size_t BlockSize = 256>
+  class ObjectPool {
+  public:
+
+    T* get() {
+      if(used_ == blocks_.size()*BlockSize) {
+        blocks_.emplace_back(new T[BlockSize]);
+      }
+      T* obj = &blocks_[used_/BlockSize][used_%BlockSize];
+      ++used_;
+      *obj = T();
+      return obj;
+    }
+
+    void reset() { used_ = 0; }
+
+    // number of objects handed out since the last reset
+    std::size_t size() const { return used_; }
+
+  private:
+    std::vector<std::unique_ptr<T[]> > blocks_;
+    std::size_t                        used_ = 0;
+  };
+
+} // namespace mu2e
+
+#endif /* GeneralUtilities_ObjectPool_hh */
@@ -0,0 +1,93 @@
+#ifndef GeneralUtilities_SmallVector_hh
+#define GeneralUtilities_SmallVector_hh
+//
+// A vector of trivially copyable elements (typically pointers) that keeps
+// up to N elements inside the object, and only goes to the heap beyond
+// that.  clear() keeps the capacity, so an object that is reused, for
+// example from an ObjectPool, allocates at most once.
+//
+// Only the part of the std::vector interface needed so far is provided.
+//
+
+#include <memory>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+
+namespace mu2e {
+
+  template<class T, unsigned N>
+  class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector elements must be trivially copyable");
+  public:
+
+    typedef T        value_type;
+    typedef T*       iterator;
+    typedef T const* const_iterator;
+
+    SmallVector() : data_(buf_), size_(0), capacity_(N) {}
+
+    SmallVector(const SmallVector& other) : SmallVector() { *this = other; }
+
+    SmallVector& operator=(const SmallVector& other) {
+      if(this != &other) {
+        clear();
+        reserve(other.size_);
+        std::copy(other.begin(), other.end(), data_);
+        size_ = other.size_;
+      }
+      return *this;
+    }
+
+    void push_back(const T& x) {
+      if(size_ == capacity_) reserve(2*capacity_);
+      data_[size_++] = x;
+    }
+
+    void reserve(std::size_t n) {
+      if(n <= capacity_) return;
+      std::unique_ptr<T[]> heap(new T[n]);
+      std::copy(begin(), end(), heap.get());
+      heap_     = std::move(heap);
+      data_     = heap_.get();
+      capacity_ = n;
+    }
+
+    void clear() { size_ = 0; }
+
+    std::size_t size()     const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    bool        empty()    const { return size_ == 0; }
+
+    T&       operator[](std::size_t i)       { return data_[i]; }
+    const T& operator[](std::size_t i) const { return data_[i]; }
+
+    T&       at(std::size_t i)       { check(i); return data_[i]; }
+    const T& at(std::size_t i) const { check(i); return data_[i]; }
+
+    T&       front()       { return data_[0]; }
+    const T& front() const { return data_[0]; }
+    T&       back()        { return data_[size_-1]; }
+    const T& back()  const { return data_[size_-1]; }
+
+    iterator       begin()       { return data_; }
+    const_iterator begin() const { return data_; }
+    iterator       end()         { return data_ + size_; }
+    const_iterator end()   const { return data_ + size_; }
+
+  private:
+    void check(std::size_t i) const {
+      if(i >= size_) throw std::out_of_range("mu2e::SmallVector: index out of range");
+    }
+
+    T                    buf_[N];
+    std::unique_ptr<T[]> heap_;
+    T*                   data_;
+    std::size_t          size_;
+    std::size_t          capacity_;
+  };
+
+} // namespace mu2e
+
+#endif /* GeneralUtilities_SmallVector_hh */
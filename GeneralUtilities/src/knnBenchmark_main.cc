@@ -0,0 +1,142 @@
+//
+// Compare the brute force KNearestNeighbors to KdTreeNeighbors on random
+// points, to check they agree and to find the group size where the tree
+// becomes faster.  Also times radius queries against a linear scan.
+//
+// usage: knnBenchmark [k [maxN]]
+//
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+#include "Offline/GeneralUtilities/inc/KNearestNeighbors.hh"
+#include "Offline/GeneralUtilities/inc/KdTreeNeighbors.hh"
+
+using namespace mu2e;
+
+namespace {
+
+  struct Pos {
+    double x, y, z;
+  };
+
+  struct Coord {
+    std::array<double,3> operator()(const Pos* p) const { return {p->x, p->y, p->z}; }
+  };
+
+  struct Dist {
+    double operator()(const Pos* a, const Pos* b) const {
+      const double dx = a->x - b->x, dy = a->y - b->y, dz = a->z - b->z;
+      return std::sqrt(dx*dx + dy*dy + dz*dz);
+    }
+  };
+
+  template<class F>
+  double timeIt(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+  }
+
+}
+
+int main(int argc, char** argv) {
+
+  const unsigned k    = argc > 1 ? std::stoi(argv[1]) : 10;
+  const unsigned maxN = argc > 2 ? std::stoi(argv[2]) : 16384;
+
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<double> flat(-100., 100.);
+
+  bool ok = true;
+  std::cout << "k = " << k << ", times in ms" << std::endl;
+  std::cout << std::setw(8) << "N" << std::setw(12) << "brute" << std::setw(12) << "kd-tree"
+            << std::setw(10) << "ratio" << std::setw(14) << "radius scan"
+            << std::setw(14) << "radius tree" << std::endl;
+
+  for(unsigned n = 16; n <= maxN; n *= 2) {
+    std::vector<Pos> pos(n);
+    for(auto& p : pos) {
+      p = Pos{flat(gen), flat(gen), flat(gen)};
+    }
+    std::vector<const Pos*> group;
+    for(auto& p : pos) {
+      group.push_back(&p);
+    }
+
+    // repeat small groups so the times are measurable
+    const unsigned nrep = std::max(1u, 4096u/n);
+    Dist dist;
+
+    std::vector<KdTreeNeighbors<const Pos*>::Points> tree(n);
+    const double tTree = timeIt([&]() {
+        for(unsigned rep=0; rep<nrep; ++rep) {
+          KdTreeNeighbors<const Pos*> kd(group, Coord());
+          for(unsigned i=0; i<n; ++i) {
+            kd.nearest(group[i], k, dist, tree[i], i);
+          }
+        }
+      })/nrep;
+
+    double tBrute = 0.;
+    if(n <= 8192) {
+      tBrute = timeIt([&]() {
+          for(unsigned rep=0; rep<nrep; ++rep) {
+            KNearestNeighbors<const Pos*> brute(k, group, dist);
+            // both must find the same neighbor distances
+            if(rep == 0) {
+              for(unsigned i=0; i<n; ++i) {
+                bool same = brute[i].size() == tree[i].size();
+                for(unsigned j=0; same && j<tree[i].size(); ++j) {
+                  same = brute[i][j].distance == tree[i][j].distance;
+                }
+                if(!same) {
+                  std::cout << "N = " << n << ": point " << i << " differs" << std::endl;
+                  ok = false;
+                  break;
+                }
+              }
+            }
+          }
+        })/nrep;
+    }
+
+    // neighbors within a radius that holds about k points on average
+    const double radius = 200.*std::cbrt(3.*k/(4.*M_PI*n));
+    std::size_t nScan = 0, nTree = 0;
+    const double tScan = timeIt([&]() {
+        for(unsigned i=0; i<n; ++i) {
+          for(unsigned j=0; j<n; ++j) {
+            if(dist(group[i], group[j]) <= radius) ++nScan;
+          }
+        }
+      });
+    KdTreeNeighbors<const Pos*> kd(group, Coord());
+    KdTreeNeighbors<const Pos*>::Points within;
+    const double tRadius = timeIt([&]() {
+        for(unsigned i=0; i<n; ++i) {
+          kd.withinRadius(group[i], radius, dist, within);
+          nTree += within.size();
+        }
+      });
+    if(nScan != nTree) {
+      std::cout << "N = " << n << ": radius query found " << nTree
+                << " points, scan " << nScan << std::endl;
+      ok = false;
+    }
+
+    std::cout << std::setw(8) << n << std::fixed << std::setprecision(3)
+              << std::setw(12) << tBrute*1e3 << std::setw(12) << tTree*1e3
+              << std::setw(10) << std::setprecision(2) << (tBrute > 0. ? tBrute/tTree : 0.)
+              << std::setprecision(3) << std::setw(14) << tScan*1e3
+              << std::setw(14) << tRadius*1e3 << std::endl;
+  }
+
+  std::cout << (ok ? "knnBenchmark: results agree" : "knnBenchmark: results DIFFER") << std::endl;
+  return ok ? 0 : 1;
+}
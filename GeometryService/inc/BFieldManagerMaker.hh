@@ -71,6 +71,13 @@ namespace mu2e {
                       double scaleFactor,
                       BFInterpolationStyle interpStyle);
 
+        // Create a new magnetic field map on a memory mapped, pre-gridded file.
+        void loadMapped(BFieldManager::MapContainerType* whichMap,
+                        const std::string& key,
+                        const std::string& resolvedFileName,
+                        double scaleFactor,
+                        BFInterpolationStyle interpStyle);
+
         // Create and fill a new magnetic field map
         void readGMCMap(const std::string& mapKey,
                         const std::string& resolvedFileName,
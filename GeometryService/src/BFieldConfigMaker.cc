@@ -43,8 +43,15 @@ namespace mu2e {
     BFieldConfigMaker::BFieldConfigMaker(const SimpleConfig& config, const Beamline& beamg)
         : bfconf_(new BFieldConfig()) {
         bfconf_->writeBinaries_ = config.getBool("bfield.writeG4BLBinaries", false);
+        bfconf_->writeMappedMaps_ = config.getBool("bfield.writeMappedMaps", false);
         bfconf_->verbosityLevel_ = config.getInt("bfield.verbosityLevel");
         bfconf_->flipBFieldMaps_ = config.getBool("bfield.flipMaps", false);
+        bfconf_->useFloatStorage_ = config.getBool("bfield.floatStorage", false);
+        bfconf_->floatValidationPoints_ = config.getInt("bfield.floatStorageValidationPoints", 0);
+        bfconf_->paramCompileTolerance_ = config.getDouble("bfield.paramCompileTolerance", 0.);
+        bfconf_->paramCompileDegree_ = config.getInt("bfield.paramCompileDegree", 8);
+        bfconf_->paramCompileValidationPoints_ =
+            config.getInt("bfield.paramCompileValidationPoints", 1000);
 
         bfconf_->scaleFactor_ = config.getDouble("bfield.scaleFactor", 1.0);
 
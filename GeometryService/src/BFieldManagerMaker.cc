@@ -30,6 +30,7 @@
 
 // Includes from Mu2e
 #include "Offline/BFieldGeom/inc/BFInterpolationStyle.hh"
+#include "Offline/BFieldGeom/inc/BFMapFile.hh"
 #include "Offline/BFieldGeom/inc/BFieldConfig.hh"
 #include "Offline/BFieldGeom/inc/BFieldManager.hh"
 #include "Offline/BFieldGeom/inc/DiskRecord.hh"
@@ -138,6 +139,17 @@ namespace mu2e {
             }
         }
 
+        if (config.writeMappedMaps()) {
+            for (auto* maps : {&_bfmgr->innerMaps_, &_bfmgr->outerMaps_}) {
+                for (auto const& m : *maps) {
+                    auto const& grid = dynamic_cast<const BFGridMap&>(*m);
+                    cout << "Writing magnetic field map " << grid.getKey()
+                         << " in mapped format to file: " << grid.getKey() + ".bfmap" << endl;
+                    grid.writeMappedFile(grid.getKey() + ".bfmap");
+                }
+            }
+        }
+
         if (config.writeBinaries()) {
             for (BFieldManager::MapContainerType::const_iterator i = _bfmgr->getInnerMaps().begin();
                  i != _bfmgr->getInnerMaps().end(); ++i) {
@@ -150,6 +162,52 @@ namespace mu2e {
             }
         }
 
+        // Must come after flipping and writing binaries, which work on the double precision copy.
+        if (config.useFloatStorage()) {
+            for (auto* maps : {&_bfmgr->innerMaps_, &_bfmgr->outerMaps_}) {
+                for (auto const& m : *maps) {
+                    auto grid = std::dynamic_pointer_cast<BFGridMap>(m);
+                    if (!grid) {
+                        continue;
+                    }
+                    std::size_t before = grid->memoryUsage();
+                    grid->packToFloat(config.floatValidationPoints());
+                    if (bfieldVerbosityLevel > 0) {
+                        cout << "Packed map " << grid->getKey() << " to single precision: " << before
+                             << " -> " << grid->memoryUsage() << " bytes" << endl;
+                    }
+                }
+            }
+        }
+
+        if (config.paramCompileTolerance() > 0.) {
+            for (auto* maps : {&_bfmgr->innerMaps_, &_bfmgr->outerMaps_}) {
+                for (auto const& m : *maps) {
+                    auto param = std::dynamic_pointer_cast<BFParamMap>(m);
+                    if (!param) {
+                        continue;
+                    }
+                    auto report = param->compile(config.paramCompileTolerance(),
+                                                 config.paramCompileDegree(),
+                                                 config.paramCompileValidationPoints());
+                    if (!report.converged) {
+                        mf::LogWarning("GEOM")
+                            << "Compiled map " << param->getKey()
+                            << " does not meet the tolerance " << config.paramCompileTolerance()
+                            << " T; largest deviation " << report.maxDeviationMag << " T\n";
+                    }
+                    if (bfieldVerbosityLevel > 0) {
+                        cout << "Compiled map " << param->getKey() << ": degree " << report.degree
+                             << ", " << report.ncells << " cells, " << report.bytes
+                             << " bytes; largest deviation at " << report.nPoints
+                             << " points (Bx, By, Bz, |dB|): " << report.maxDeviation[0] << " "
+                             << report.maxDeviation[1] << " " << report.maxDeviation[2] << " "
+                             << report.maxDeviationMag << " T" << endl;
+                    }
+                }
+            }
+        }
+
         // For debug purposes: print the field in the target region
         if (bfieldVerbosityLevel > 0) {
             CLHEP::Hep3Vector b = _bfmgr->getBField(CLHEP::Hep3Vector(3900.0, 0.0, -6550.0));
@@ -404,6 +462,12 @@ namespace mu2e {
                                       const std::string& resolvedFileName,
                                       double scaleFactor,
                                       BFInterpolationStyle interpStyle) {
+        // Pre-gridded maps carry their own grid description and are used in place.
+        if (resolvedFileName.find(".bfmap") != string::npos) {
+            loadMapped(mapContainer, key, resolvedFileName, scaleFactor, interpStyle);
+            return;
+        }
+
         // Extract information from the header.
         vector<double> X0;
         vector<int> dim;
@@ -426,6 +490,24 @@ namespace mu2e {
         }
     }
 
+    // Map a file written by BFGridMap::writeMappedFile into memory and build a grid map on it.
+    void BFieldManagerMaker::loadMapped(BFieldManager::MapContainerType* mapContainer,
+                                        const std::string& key,
+                                        const std::string& resolvedFileName,
+                                        double scaleFactor,
+                                        BFInterpolationStyle interpStyle) {
+        auto file = std::make_shared<const BFMapFile>(resolvedFileName);
+        BFMapFileHeader const& h = file->header();
+        auto dsmap = _bfmgr->addBFGridMap(mapContainer, key, h.nx, h.xmin, h.dx, h.ny, h.ymin,
+                                          h.dy, h.nz, h.zmin, h.dz, BFMapType::G4BL, scaleFactor,
+                                          interpStyle);
+        dsmap->attachMappedFile(file);
+        if (bfieldVerbosityLevel > 1) {
+            std::cout << "BFieldManagerMaker: mapped " << file->size() << " bytes from "
+                      << resolvedFileName << std::endl;
+        }
+    }
+
     //
     // Read one magnetic field map file in MECO GMC format.
     //
@@ -867,6 +949,11 @@ namespace mu2e {
     }  // namespace mu2e
 
     void BFieldManagerMaker::writeG4BLBinary(const BFGridMap& bf, const std::string& outputfile) {
+        if (bf.isPacked()) {
+            throw cet::exception("GEOM") << "BFieldManagerMaker:writeG4BLBinary the map "
+                                         << bf.getKey() << " has no double precision copy.\n";
+        }
+
         // Number of points in the big array.
         int nPoints = bf.nx() * bf.ny() * bf.nz();
 
@@ -951,6 +1038,10 @@ namespace mu2e {
     }
 
     void BFieldManagerMaker::flipMap(BFGridMap& bf) {
+        if (bf.isPacked()) {
+            throw cet::exception("GEOM") << "BFieldManagerMaker::flipMap cannot flip the map "
+                                         << bf.getKey() << "; it has no double precision copy.\n";
+        }
         std::cout << "Flipping B field vector in map " << bf.getKey() << std::endl;
         for (int ix = 0; ix < bf.nx(); ++ix) {
             for (int iy = 0; iy < bf.ny(); ++iy) {
@@ -348,6 +348,9 @@ namespace mu2e {
             }
         }
 
+        //flat neighbor table, once the neighbors of all the crystals are known
+        calo_->neighborTable_.fill(calo_->fullCrystalList_);
+
 
 
     }
@@ -8,6 +8,8 @@
 #include "BTrk/BField/BField.hh"
 // CLHEP
 #include "CLHEP/Vector/ThreeVector.h"
+// Mu2e
+#include "Offline/BFieldGeom/inc/BFieldQueryContext.hh"
 
 // class interface //
 namespace mu2e 
@@ -28,6 +30,7 @@ namespace mu2e
     private:
       mutable double _bnom;
       CLHEP::Hep3Vector _origin;
+      mutable BFieldQueryContext _context; // field lookup cache
   };
 }
 #endif
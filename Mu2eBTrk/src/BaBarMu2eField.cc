@@ -23,7 +23,7 @@ namespace mu2e
     // change coordinates to mu2e
     CLHEP::Hep3Vector vpoint(point.x(),point.y(),point.z());
     CLHEP::Hep3Vector vpoint_mu2e = det->toMu2e(vpoint);
-    CLHEP::Hep3Vector field = bfmgr->getBField(vpoint_mu2e);
+    CLHEP::Hep3Vector field = bfmgr->getBField(vpoint_mu2e,_context);
     return field;
   }
 
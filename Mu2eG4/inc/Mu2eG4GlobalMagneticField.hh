@@ -10,7 +10,7 @@
 
 #include <string>
 
-#include "Offline/BFieldGeom/inc/BFCacheManager.hh"
+#include "Offline/BFieldGeom/inc/BFieldQueryContext.hh"
 
 #include "Geant4/G4MagneticField.hh"
 #include "Geant4/G4Types.hh"
@@ -44,8 +44,8 @@ namespace mu2e {
     // Non-owning pointer to the field map object (it is owned by the geometry service).
     const BFieldManager* _map;
 
-    // A copy of the bfield cache manager - must be thread local.
-    BFCacheManager _cm;
+    // State of the field lookups; each G4 worker thread has its own instance of this class.
+    mutable BFieldQueryContext _context;
 
   };
 }
@@ -41,7 +41,7 @@ namespace mu2e {
     point -= _mapOrigin;
 
     // Look up BField and reformat to required return format.
-    const CLHEP::Hep3Vector bf = _map->getBField(point, _cm);
+    const CLHEP::Hep3Vector bf = _map->getBField(point, _context);
     Bfield[0] = bf.x()*CLHEP::tesla;
     Bfield[1] = bf.y()*CLHEP::tesla;
     Bfield[2] = bf.z()*CLHEP::tesla;
@@ -66,10 +66,8 @@ namespace mu2e {
     // Throws if the map is not found.
     _map = &*bfMgr;
 
-    _cm = bfMgr->cacheManager();
-      
-      //std::cout << " from Thread #" << G4Threading::G4GetThreadId()
-      //<< ", address of CacheManager is " << &_cm << std::endl;
+    // The maps may have changed.
+    _context.reset();
   }
 
 } // end namespace mu2e
@@ -3,6 +3,16 @@
 //
 //  Wrapper to Mu2e BField map for KinKal
 //
+//  Queries are in the detector frame.  The maps are defined in the Mu2e frame, which
+//  differs from it by a translation only, so the origin of the detector frame is kept
+//  here and added to each point; the field values and gradients need no transformation.
+//
+//  By default the gradient is the derivative of the map interpolation, computed with
+//  the field in one lookup (BFieldManager::getBFieldGradient), and the time derivative
+//  along a trajectory is the gradient times the velocity.  With analytic false the
+//  gradient and time derivative are finite differences, as originally; this is kept
+//  to compare results and timing.
+//
 // Mu2e includes 
 #include "Offline/BFieldGeom/inc/BFieldManager.hh"
 #include "Offline/GeometryService/inc/DetectorSystem.hh"
@@ -16,8 +26,8 @@ namespace mu2e
     public:
       using Grad = ROOT::Math::SMatrix<double,3>; // field gradient: ie dBi/d(x,y,z)
     // construct from BField object and system translator.  
-    // This should be a single BField map valid in the detector system, to avoid making continuous translations FIXME!
-      KKBField(BFieldManager const& bfmgr, DetectorSystem const& det) : bfmgr_(bfmgr), det_(det) {}
+      KKBField(BFieldManager const& bfmgr, DetectorSystem const& det, bool analytic=true) :
+        bfmgr_(bfmgr), origin_(det.getOrigin()), analytic_(analytic) {}
       virtual ~KKBField() {}
       // KinKal BField interface
       // return value of the field at a poin
@@ -27,13 +37,15 @@ namespace mu2e
       // return the BFieldMap derivative at a given point along a given velocity, WRT time
       virtual VEC3 fieldDeriv(VEC3 const& position, VEC3 const& velocity) const override;
     private:
+      CLHEP::Hep3Vector toMu2e(VEC3 const& position) const {
+        return CLHEP::Hep3Vector(position.x()+origin_.x(),position.y()+origin_.y(),position.z()+origin_.z()); }
+      // field and gradient grad[i][j] = dB_i/dx_j at a point given in detector coordinates
+      VEC3 fieldAndGrad(VEC3 const& position, double grad[3][3]) const;
       BFieldManager const& bfmgr_;
-      DetectorSystem const& det_;
+      CLHEP::Hep3Vector origin_; // of the detector frame, in the Mu2e frame
+      bool analytic_;
+      // field lookup cache: successive queries along a trajectory tend to fall in the same map cell
+      mutable BFieldQueryContext context_;
   };
 }
 #endif
-
-
-
-
-
@@ -4,28 +4,55 @@ namespace mu2e {
   using SVEC3 = KinKal::SVEC3;
 
   VEC3 KKBField::fieldVect(VEC3 const& position) const {
-    // change coordinates to mu2e; the map should be native in detector coordinates FIXME!
-    CLHEP::Hep3Vector vpoint(position.x(),position.y(),position.z());
-    CLHEP::Hep3Vector vpoint_mu2e = det_.toMu2e(vpoint);
-    CLHEP::Hep3Vector field = bfmgr_.getBField(vpoint_mu2e);
+    CLHEP::Hep3Vector field = bfmgr_.getBField(toMu2e(position),context_);
     return VEC3(field.x(),field.y(),field.z());
   }
-      
+
+  VEC3 KKBField::fieldAndGrad(VEC3 const& position, double grad[3][3]) const {
+    CLHEP::Hep3Vector field;
+    if(analytic_){
+      bfmgr_.getBFieldGradient(toMu2e(position),context_,field,grad);
+    } else {
+      // evaluate the center and the 3 displaced points in one batch call
+      static double dt(0.01);
+      CLHEP::Hep3Vector vpoint_mu2e = toMu2e(position);
+      CLHEP::Hep3Vector points[4] = { vpoint_mu2e,
+        vpoint_mu2e + CLHEP::Hep3Vector(dt,0.0,0.0),
+        vpoint_mu2e + CLHEP::Hep3Vector(0.0,dt,0.0),
+        vpoint_mu2e + CLHEP::Hep3Vector(0.0,0.0,dt) };
+      CLHEP::Hep3Vector fields[4];
+      bfmgr_.getBFieldBatch(points,4,context_,fields);
+      field = fields[0];
+      for(unsigned jdim=0;jdim<3;++jdim){
+        CLHEP::Hep3Vector dB = (fields[jdim+1]-fields[0])/dt;
+        for(unsigned idim=0;idim<3;++idim) grad[idim][jdim] = dB[idim];
+      }
+    }
+    return VEC3(field.x(),field.y(),field.z());
+  }
+
   Grad KKBField::fieldGrad(VEC3 const& position) const {
+    double grad[3][3];
+    fieldAndGrad(position,grad);
+    // row j holds the derivatives along x_j
     Grad retval;
-    auto dBdx = fieldDeriv(position,VEC3(1.0,0.0,0.0));
-    auto dBdy = fieldDeriv(position,VEC3(0.0,1.0,0.0));
-    auto dBdz = fieldDeriv(position,VEC3(0.0,0.0,1.0));
-    SVEC3 dBdxv(dBdx.X(),dBdx.Y(), dBdx.Z());
-    SVEC3 dBdyv(dBdy.X(),dBdy.Y(), dBdy.Z());
-    SVEC3 dBdzv(dBdz.X(),dBdz.Y(), dBdz.Z());
-    retval.Place_in_row(dBdxv,0,0);
-    retval.Place_in_row(dBdyv,1,0);
-    retval.Place_in_row(dBdzv,2,0);
+    for(unsigned jdim=0;jdim<3;++jdim){
+      retval.Place_in_row(SVEC3(grad[0][jdim],grad[1][jdim],grad[2][jdim]),jdim,0);
+    }
     return retval;
   }
-// numerical derivatives for now: TODO!
+
   VEC3 KKBField::fieldDeriv(VEC3 const& position, VEC3 const& velocity) const {
+    if(analytic_){
+      // dB/dt = (grad B) v
+      double grad[3][3];
+      fieldAndGrad(position,grad);
+      double v[3] = {velocity.x(),velocity.y(),velocity.z()};
+      double dB[3];
+      for(unsigned idim=0;idim<3;++idim)
+        dB[idim] = grad[idim][0]*v[0] + grad[idim][1]*v[1] + grad[idim][2]*v[2];
+      return VEC3(dB[0],dB[1],dB[2]);
+    }
     static double dt(0.01); // 10 psec
     VEC3 start = fieldVect(position);
     VEC3 end = fieldVect(position + velocity*dt);
@@ -32,6 +32,7 @@
 #include "Offline/DataProducts/inc/PDGCode.hh"
 #include "Offline/DataProducts/inc/Helicity.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitLeafIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/KalSeed.hh"
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
@@ -119,6 +120,7 @@ namespace mu2e {
       fhicl::Atom<bool> saveAll { Name("SaveAllFits"), Comment("Save all fits, whether they suceed or not"),false };
       fhicl::Atom<bool> saveFull { Name("SaveFullFit"), Comment("Save all helix segments associated with the fit"), false};
       fhicl::Sequence<float> zsave { Name("ZSavePositions"), Comment("Z positions to sample and save the fit result helices"), std::vector<float>()};
+      fhicl::Atom<bool> analyticBField { Name("AnalyticBFieldGradient"), Comment("Take BField gradients from the map interpolation; if false, use finite differences"), true };
     };
 
     struct GlobalConfig {
@@ -148,6 +150,7 @@ namespace mu2e {
     TrkFitFlag goodhelix_;
     bool extend_, saveall_, savefull_;
     std::vector<float> zsave_;
+    bool analyticbf_;
     ProditionsHandle<StrawResponse> strawResponse_h_;
     ProditionsHandle<Tracker> alignedTracker_h_;
     int print_;
@@ -170,6 +173,7 @@ namespace mu2e {
     saveall_(settings().modSettings().saveAll()),
     savefull_(settings().modSettings().saveFull()),
     zsave_(settings().modSettings().zsave()),
+    analyticbf_(settings().modSettings().analyticBField()),
     print_(settings().modSettings().printLevel()),
     kkfit_(settings().mu2eFitSettings()),
     kkmat_(settings().matSettings()),
@@ -204,7 +208,7 @@ namespace mu2e {
     // create KKBField
     GeomHandle<BFieldManager> bfmgr;
     GeomHandle<DetectorSystem> det;
-    kkbf_ = std::move(std::make_unique<KKBField>(*bfmgr,*det));
+    kkbf_ = std::move(std::make_unique<KKBField>(*bfmgr,*det,analyticbf_));
   }
 
   void LoopHelixFit::produce(art::Event& event ) {
@@ -223,6 +227,8 @@ namespace mu2e {
     unique_ptr<KalHelixAssns> kkseedassns(new KalHelixAssns());
     auto KalSeedCollectionPID = event.getProductID<KalSeedCollection>();
     auto KalSeedCollectionGetter = event.productGetter(KalSeedCollectionPID);
+    // map from ComboHits to StrawHits, filled once per ComboHit collection
+    ComboHitLeafIndex leafIndex(event);
     // find the helix seed collections
     unsigned nhelix(0);
     for (auto const& hseedtag : hseedCols_) {
@@ -242,7 +248,7 @@ namespace mu2e {
 	  // first, we need to unwind the combohits.  We use this also to find the time range
 	  StrawHitIndexCollection strawHitIdxs;
 	  auto const& hhits = hseed.hits();
-	  for(size_t ihit = 0; ihit < hhits.size(); ++ihit ){ hhits.fillStrawHitIndices(event,ihit,strawHitIdxs); }
+	  for(size_t ihit = 0; ihit < hhits.size(); ++ihit ){ leafIndex.fillStrawHitIndices(hhits,ihit,strawHitIdxs); }
 	  // next, build straw hits and materials from these
 	  KKSTRAWHITCOL strawhits; 
 	  KKSTRAWXINGCOL strawxings;
@@ -14,6 +14,8 @@
 //
 // 1) digitizedPulse(hitTime) returns a waveform with hitTime corresponding to low edge of first bin 
 // 2) evaluate(deltaTime) return value of digitized bin at a given time difference with peak time value
+// 3) phasePulse(phase(hitTime)) points to the same values as digitizedPulse(hitTime), precomputed for each 
+//    of the nPhases() steps within a digitization bin, without touching the cache
 //
 //  NOTE: uncomment the pline creation if the discontinuities in the second order derivative arising from the
 //        linear piecewise approxmiation are problematic for the minimization
@@ -35,13 +37,21 @@ namespace mu2e {
           double                     fromPeakToT0    (double timePeak)       const;
           void                       diag            (bool fullDiag=false)   const;
 
+          int                        nBins           ()                      const {return nBinShape_;}
+          int                        nPhases         ()                      const {return nSteps_;}
+          int                        phase           (double hitTime)        const {return int(hitTime/digiStep_)%nSteps_;}
+          const double*              phasePulse      (int iphase)            const {return &phasePulses_[iphase*nBinShape_];}
+
        private:      
+          void                        buildPhasePulses();
+
           int                         nSteps_;	 
           double                      digiStep_;
           int                         nBinShape_;
           std::vector<double>         pulseVec_;
           double                      deltaT_;
           mutable std::vector<double> digitizedPulse_; 
+          std::vector<double>         phasePulses_;
     };
 
 }
@@ -8,6 +8,7 @@
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/dom/DOMDocument.hpp>
+#include <cstddef>
 #include <vector>
 #include <string>
 
@@ -27,11 +28,29 @@ namespace mu2e
        explicit MVATools(const Config& conf);
        explicit MVATools(const std::string& xmlfilename);
 
+       // Scratch space for the evaluation.  A Workspace must only be used by one thread
+       // at a time; the evalMVA calls without one use a thread-local Workspace, so a
+       // single (const) MVATools can be shared between threads.
+       struct Workspace
+       {
+          std::vector<float> x, y; // neuron values of the current and next layer
+          std::vector<float> v;    // inputs converted from double
+       };
+
        virtual ~MVATools();
        xercesc::DOMDocument* getXmlDoc();
        void     initMVA();
        float    evalMVA(const std::vector<float>&,  const MVAMask& vmask=0xffffffff) const;
        float    evalMVA(const std::vector<double>&, const MVAMask& vmask=0xffffffff) const;
+       float    evalMVA(const std::vector<float>&,  Workspace&, const MVAMask& vmask=0xffffffff) const;
+       float    evalMVA(const std::vector<double>&, Workspace&, const MVAMask& vmask=0xffffffff) const;
+
+       // Evaluate nrow rows of nvar variables, stored row after row in v, into out[0..nrow).
+       // Blocks of rows go through each layer together, as products of the weight matrix with
+       // contiguous per-neuron arrays, so the sums and activations vectorize across rows.
+       // The results are identical to evaluating the rows one at a time.
+       void     evalMVA(const float* v, size_t nrow, size_t nvar, float* out, const MVAMask& vmask=0xffffffff) const;
+       void     evalMVA(const float* v, size_t nrow, size_t nvar, float* out, Workspace&, const MVAMask& vmask=0xffffffff) const;
        void     showMVA() const;
        
        const std::vector<std::string>& titles() const { return title_;}     
@@ -45,11 +64,12 @@ namespace mu2e
        void   getOpts(xercesc::DOMDocument* xmlDoc);
        void   getNorm(xercesc::DOMDocument* xmlDoc);
        void   getWgts(xercesc::DOMDocument* xmlDoc);
-       float  activation(float arg) const;
+       void   reserve(Workspace& ws, unsigned nrow) const;
+       void   setInputs(const float* v, size_t nvar, const MVAMask& mask, float* x, unsigned stride) const;
+       template <unsigned NROW> void feedForward(Workspace& ws, unsigned nrow, float* out) const;
+       void   activation(float* y, unsigned n) const;
 
-       mutable std::vector<float> x_;
-       mutable std::vector<float> y_;
-       mutable std::vector<float> fv_;      
+       static constexpr unsigned  blockSize_ = 16; // rows evaluated together by the batch evalMVA
        std::vector<float>         wgts_;
        std::vector<unsigned>      links_;
        unsigned                   maxNeurons_;
@@ -3,46 +3,76 @@
 //
 // Original author G. Pezzullo
 //
-// this class is intended to be used for evaluaitng the median 
+// this class is intended to be used for evaluaitng the median
 // from a set of elements that are stored internally in a vector
 //
+// The median is found by selection (partial partitioning) of the elements,
+// in linear time, rather than by sorting them.
+//
+// In incremental mode the calculator keeps the value order of its elements
+// from one median to the next.  It is meant for iterations that clear() the
+// calculator and push the same elements, in the same order, with slightly
+// changed values or weights: the previous order is then nearly right, and
+// is repaired by insertion sort.  If the order has changed a lot, the
+// elements are sorted again.
+//
 
 #include <stddef.h>
+#include <stdint.h>
 #include <functional>
 //#include <utility>
 #include <numeric>
 #include <vector>
 
-namespace mu2e { 
+namespace mu2e {
   class MedianCalculator{
     struct  MedianData {
       MedianData(float Val, float Wg): val(Val), wg(Wg){}
       float    val;
       float    wg;
     };
-    struct MedianDatacomp : public std::binary_function<MedianData,MedianData,bool> {
-      bool operator()(MedianData const& p1, MedianData const& p2) { return p1.val < p2.val; }
+    struct MedianDatacomp {
+      bool operator()(MedianData const& p1, MedianData const& p2) const { return p1.val < p2.val; }
     };
-   
+
   public:
-    MedianCalculator(size_t nToReserve=0){
+    MedianCalculator(size_t nToReserve=0, bool incremental=false) : _incremental(incremental) {
       _vec.reserve(nToReserve);
     }
-    
+
     float  weightedMedian();
     float  unweightedMedian();
-    
+
     inline void     push(float  value, float   weight=1){
       _vec.emplace_back(MedianData(value, weight));
-      _needsSorting = true;
+      _weightedOK   = false;
+      _unweightedOK = false;
       _totalWeight  += weight;
     }
-    
+
+    // remove all the elements.  In incremental mode the value order of the last median is kept
+    inline void     clear(){
+      _vec.clear();
+      _weightedOK   = false;
+      _unweightedOK = false;
+      _totalWeight  = 0;
+    }
+
     inline size_t   size(){ return _vec.size(); }
   private:
-    
-    std::vector<MedianData>  _vec; 
-    bool                     _needsSorting     = true;
+    // the median elements, with neighbors, from the elements in value order
+    float  weightedMedian(float sum, float wid, float vlo, float vid, float vhi) const;
+    float  unweightedMedian(float vlo, float vid, float vhi) const;
+    // incremental mode: bring _order up to date
+    void   sortOrder();
+
+    static constexpr size_t  _minSelect = 16; // smaller ranges are sorted rather than partitioned
+
+    std::vector<MedianData>  _vec;
+    bool                     _incremental;
+    std::vector<uint32_t>    _order; // incremental mode: indices of _vec in value order
+    bool                     _weightedOK       = false;
+    bool                     _unweightedOK     = false;
     float                    _weightedMedian   = 0;
     float                    _unweightedMedian = 0;
     float                    _totalWeight      = 0;
@@ -11,7 +11,7 @@ namespace mu2e {
 
 
    CaloPulseShape::CaloPulseShape(double digiSampling) :
-      nSteps_(100), digiStep_(digiSampling/double(nSteps_)),nBinShape_(0), pulseVec_(), deltaT_(0.), digitizedPulse_()
+      nSteps_(100), digiStep_(digiSampling/double(nSteps_)),nBinShape_(0), pulseVec_(), deltaT_(0.), digitizedPulse_(), phasePulses_()
    {}
 
    //----------------------------------------------------------------------------------------------------------------------
@@ -45,7 +45,23 @@ namespace mu2e {
 
        // find difference between peak time and t0 for digitized waveform. 
        for (int i=1;i<nBinShape_;++i) {if (pulseVec_[(i+1)*nSteps_] < pulseVec_[i*nSteps_]) break; deltaT_ +=nSteps_*digiStep_;}
-     
+
+       buildPhasePulses();
+   }
+
+   //----------------------------------------------------------------------------
+   // digitized pulse for each phase, same values as digitizedPulse 
+   void CaloPulseShape::buildPhasePulses()
+   {
+       phasePulses_.assign(nSteps_*nBinShape_,0.0);
+       for (int iphase=0;iphase<nSteps_;++iphase)
+       {
+           for (int i=0;i<nBinShape_;++i) 
+           {
+               unsigned idx = nSteps_ - iphase + i*nSteps_;
+               if (idx < pulseVec_.size()) phasePulses_[iphase*nBinShape_+i] = pulseVec_[idx];
+           }
+       }
    }
 
    //----------------------------------------------------------------------------
@@ -37,10 +37,16 @@ using namespace xercesc;
 namespace mu2e
 {
 
+  namespace
+  {
+    MVATools::Workspace& threadWorkspace()
+    {
+      thread_local MVATools::Workspace ws;
+      return ws;
+    }
+  }
+
   MVATools::MVATools(const Config& config) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(),
     maxNeurons_(0),
     activeType_(aType::null),
@@ -59,9 +65,6 @@ namespace mu2e
   }
 
   MVATools::MVATools(fhicl::ParameterSet const& pset) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(),
     maxNeurons_(0),
     activeType_(aType::null),
@@ -80,9 +83,6 @@ namespace mu2e
   }
 
   MVATools::MVATools(const std::string& xmlfilename) :
-    x_(),
-    y_(),
-    fv_(),
     wgts_(), 
     maxNeurons_(0), 
     activeType_(aType::null),
@@ -372,8 +372,6 @@ namespace mu2e
       }
 
       maxNeurons_ = *std::max_element(links_.begin(),links_.end());
-      x_ = std::vector<float>(maxNeurons_,0.0f);
-      y_ = std::vector<float>(maxNeurons_,0.0f);
 
       XMLString::release(&ATT_INDEX);
       XMLString::release(&ATT_NSYNAPSES);
@@ -428,72 +426,153 @@ namespace mu2e
 
   float MVATools::evalMVA(const std::vector<double >& v, const MVAMask& mask) const
   {
-     for (size_t i=0;i<v.size();++i)  fv_[i] = static_cast<float>(v[i]);
-     return evalMVA(fv_,mask);
+     return evalMVA(v,threadWorkspace(),mask);
   }
 
   float MVATools::evalMVA(const std::vector<float>& v, const MVAMask& mask) const
   {
+     return evalMVA(v,threadWorkspace(),mask);
+  }
+
+  float MVATools::evalMVA(const std::vector<double >& v, Workspace& ws, const MVAMask& mask) const
+  {
+     ws.v.assign(v.begin(),v.end());
+     return evalMVA(ws.v,ws,mask);
+  }
+
+  float MVATools::evalMVA(const std::vector<float>& v, Workspace& ws, const MVAMask& mask) const
+  {
+      reserve(ws,1);
+      setInputs(v.data(),v.size(),mask,ws.x.data(),1);
+      float out(0.0);
+      feedForward<1>(ws,1,&out);
+      return out;
+  }
+
+  void MVATools::evalMVA(const float* v, size_t nrow, size_t nvar, float* out, const MVAMask& mask) const
+  {
+     evalMVA(v,nrow,nvar,out,threadWorkspace(),mask);
+  }
 
+  void MVATools::evalMVA(const float* v, size_t nrow, size_t nvar, float* out, Workspace& ws, const MVAMask& mask) const
+  {
+      for (size_t irow=0; irow < nrow; irow += blockSize_)
+      {
+          const unsigned nr = std::min(nrow-irow,size_t(blockSize_));
+          reserve(ws,nr);
+          for (unsigned r=0;r<nr;++r) setInputs(v+(irow+r)*nvar,nvar,mask,ws.x.data()+r,nr);
+          if (nr == blockSize_) feedForward<blockSize_>(ws,nr,out+irow);
+          else                  feedForward<0>(ws,nr,out+irow);
+      }
+  }
+
+
+  void MVATools::reserve(Workspace& ws, unsigned nrow) const
+  {
+      const size_t n = size_t(maxNeurons_)*nrow;
+      if (ws.x.size() < n) ws.x.resize(n);
+      if (ws.y.size() < n) ws.y.resize(n);
+  }
+
+  // the value of input neuron i of row r is stored in x[i*stride+r], stride being the number of rows
+  void MVATools::setInputs(const float* v, size_t nvar, const MVAMask& mask, float* x, unsigned stride) const
+  {
       // Normalize the input data and add the bias node, skip masked values
+      const size_t nin = links_[0]-1;
       size_t ival(0);
-      for (size_t ivar=0; ivar < v.size(); ivar++)
+      for (size_t ivar=0; ivar < nvar; ivar++)
       {
          if ( mask & (1<<ivar) )
          {
-	    x_[ival]= isNorm_ ? (v[ivar]-voffset_[ival])*vscale_[ival] - 1.0 : v[ivar];
+	    if (ival < nin) x[ival*stride] = isNorm_ ? (v[ivar]-voffset_[ival])*vscale_[ival] - 1.0 : v[ivar];
 	    ++ival;
          }
       }
-      x_[ival] = 1.0;
 
-      if (ival != links_[0]-1)
-	throw cet::exception("RECO")<<"mu2e::MVATools: mismatch input dimension (ival = " << ival << ") and network architecture (links_[0]-1 = " << links_[0]-1 << ")" << std::endl;
+      if (ival != nin)
+	throw cet::exception("RECO")<<"mu2e::MVATools: mismatch input dimension (ival = " << ival << ") and network architecture (links_[0]-1 = " << nin << ")" << std::endl;
+
+      x[ival*stride] = 1.0;
+  }
 
+  // NROW is the number of rows when known at compile time (0 if not), so the single row and
+  // full block loops are compiled with fixed trip counts
+  template <unsigned NROW>
+  void MVATools::feedForward(Workspace& ws, unsigned nrows, float* out) const
+  {
+      const unsigned nrow = NROW > 0 ? NROW : nrows;
+      float* x = ws.x.data();
+      float* y = ws.y.data();
 
       //perform feed forward calculation up to the last hidden layer
       unsigned idxWeight(0);
       for (unsigned k=0;k<links_.size()-1;++k)
       {
           //the number of synpases is given by the number of neurons in the next layer -1 (do not count bias neuron!)
-          for (unsigned j=0;j<links_[k+1]-1;++j)
+          const unsigned nout = links_[k+1]-1;
+          for (unsigned j=0;j<nout;++j)
           {
-	     y_[j]=0.0f;
-	     for (unsigned i=0;i<links_[k];++i) y_[j] += wgts_[i+idxWeight]*x_[i];
-             y_[j] = activation(y_[j]);
+             float* yj = y + j*nrow;
+             std::fill(yj,yj+nrow,0.0f);
+             for (unsigned i=0;i<links_[k];++i)
+             {
+                const float  w  = wgts_[i+idxWeight];
+                const float* xi = x + i*nrow;
+                for (unsigned r=0;r<nrow;++r) yj[r] += w*xi[r];
+             }
              idxWeight += links_[k];
           }
-          x_.swap(y_);
-          x_[links_[k+1]-1] = 1.0f; //add bias neuron
+          activation(y,nout*nrow);
+          std::swap(x,y);
+          std::fill(x+nout*nrow,x+(nout+1)*nrow,1.0f); //add bias neuron
       }
 
       //calculate output neuron value
-      float yf(0.0);
-      for (unsigned i=0;i<links_.back();++i) yf += wgts_[i+idxWeight]*x_[i];
+      std::fill(out,out+nrow,0.0f);
+      for (unsigned i=0;i<links_.back();++i)
+      {
+          const float  w  = wgts_[i+idxWeight];
+          const float* xi = x + i*nrow;
+          for (unsigned r=0;r<nrow;++r) out[r] += w*xi[r];
+      }
 
-      if (oldMVA_) return yf;
-      return  1.0/(1.0+expf(-yf));
+      if (oldMVA_) return;
+      for (unsigned r=0;r<nrow;++r) out[r] = 1.0/(1.0+expf(-out[r]));
   }
 
 
-
-
-  float MVATools::activation(float arg) const
+  // each loop is branch-free, so the compiler can vectorize it
+  void MVATools::activation(float* y, unsigned n) const
   {
      if (activeType_== aType::tanh)
      {
-       if (oldMVA_) return std::tanh(arg);
-       if (arg > 4.97) return 1.0;
-       if (arg < -4.97) return -1.0;
-       float arg2 = arg * arg;
-       float a = arg * (135135.0f + arg2 * (17325.0f + arg2 * (378.0f + arg2)));
-       float b = 135135.0f + arg2 * (62370.0f + arg2 * (3150.0f + arg2 * 28.0f));
-       return a/b;
+       if (oldMVA_)
+       {
+          for (unsigned i=0;i<n;++i) y[i] = std::tanh(y[i]);
+          return;
+       }
+       for (unsigned i=0;i<n;++i)
+       {
+          const float arg  = y[i];
+          const float arg2 = arg * arg;
+          const float a = arg * (135135.0f + arg2 * (17325.0f + arg2 * (378.0f + arg2)));
+          const float b = 135135.0f + arg2 * (62370.0f + arg2 * (3150.0f + arg2 * 28.0f));
+          y[i] = arg > 4.97f ? 1.0f : (arg < -4.97f ? -1.0f : a/b);
+       }
+       return;
+     }
+     if (activeType_== aType::sigmoid)
+     {
+       for (unsigned i=0;i<n;++i) y[i] = 1.0/(1.0+expf(-y[i]));
+       return;
+     }
+     if (activeType_== aType::relu)
+     {
+       for (unsigned i=0;i<n;++i) y[i] = std::max(0.0f,y[i]);
+       return;
      }
-     if (activeType_== aType::sigmoid) return 1.0/(1.0+expf(-arg));
-     if (activeType_== aType::relu) return std::max(0.0f,arg);
 
-     return -999.0;
+     std::fill(y,y+n,-999.0f);
   }
 
 
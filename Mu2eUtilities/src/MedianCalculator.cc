@@ -17,41 +17,70 @@ namespace mu2e {
     if (v_size == 1){
       return _vec[0].val;
     }
-    
-    if (_needsSorting){
-      std::sort(_vec.begin(), _vec.end(), MedianDatacomp());
-      _needsSorting = false;
-    }else {
+
+    if (_weightedOK){
       return   _weightedMedian;
     }
-  
-    float   sum(0);
-    size_t  id(0);
 
-    sum = _totalWeight - _vec[0].wg;
-    while (sum > 0.5*_totalWeight){
-      ++id;
-      sum -= _vec[id].wg;
-    }
+    // find the first element, in value order, with at most half of the total weight above it;
+    // sum is the weight above it
+    const float half(0.5*_totalWeight);
+    size_t  id(0);
+    float   sum(0), vlo(0), vid(0), vhi(0), wid(0);
 
-    float   over((sum)/_totalWeight);
-    float   interpolation(0);
-    if (v_size %2 == 0) {
-      interpolation =  _vec[id].val * over + _vec[id+1].val * (1.-over);
-    }else {
-      float  w2     = (sum)/_totalWeight;
-      float  w1     = (sum + _vec[id].wg )/_totalWeight;
-      float  val1   = _vec[id-1].val*w1 + _vec[id].val*(1.-w1);
-      float  val2   = _vec[id].val*w2 + _vec[id+1].val*(1.-w2);
-      interpolation = 0.5*(val1 + val2);
+    if (_incremental){
+      sortOrder();
+      sum = _totalWeight - _vec[_order[0]].wg;
+      while (sum > half && id+1 < v_size){
+        ++id;
+        sum -= _vec[_order[id]].wg;
+      }
+      vid = _vec[_order[id]].val;
+      wid = _vec[_order[id]].wg;
+      vlo = id > 0        ? _vec[_order[id-1]].val : vid;
+      vhi = id+1 < v_size ? _vec[_order[id+1]].val : vid;
+    } else {
+      // weighted quickselect: the element is in [lo,hi), and wabove is the weight above hi.
+      // Small ranges are sorted and scanned
+      size_t  lo(0), hi(v_size);
+      float   wabove(0);
+      while (hi - lo > _minSelect){
+        size_t  mid = (lo + hi - 1)/2;
+        std::nth_element(_vec.begin()+lo, _vec.begin()+mid, _vec.begin()+hi, MedianDatacomp());
+        float   wupper(wabove);
+        for (size_t i=mid+1; i<hi; ++i) wupper += _vec[i].wg;
+        if (wupper > half){
+          lo = mid+1;
+        }else {
+          hi     = mid+1;
+          wabove = wupper;
+        }
+      }
+      std::sort(_vec.begin()+lo, _vec.begin()+hi, MedianDatacomp());
+      id  = hi-1;
+      sum = wabove;
+      while (id > lo && sum + _vec[id].wg <= half){
+        sum += _vec[id].wg;
+        --id;
+      }
+      vid = _vec[id].val;
+      wid = _vec[id].wg;
+      // the elements are partitioned around [lo,hi): the neighbors outside it are the largest value below and the smallest above
+      if (id > lo)          vlo = _vec[id-1].val;
+      else if (lo > 0)      vlo = std::max_element(_vec.begin(), _vec.begin()+lo, MedianDatacomp())->val;
+      else                  vlo = vid;
+      if (id+1 < hi)        vhi = _vec[id+1].val;
+      else if (hi < v_size) vhi = std::min_element(_vec.begin()+hi, _vec.end(), MedianDatacomp())->val;
+      else                  vhi = vid;
     }
 
     //cache the result
-    _weightedMedian = interpolation;
+    _weightedMedian = weightedMedian(sum, wid, vlo, vid, vhi);
+    _weightedOK     = true;
 
-    return interpolation;
+    return _weightedMedian;
   }
-	
+
   float    MedianCalculator::unweightedMedian(){
     //now, we need to loop over it and evaluate the median
     size_t   v_size = _vec.size();
@@ -62,34 +91,92 @@ namespace mu2e {
       return _vec[0].val;
     }
 
-    if (_needsSorting){
-      std::sort(_vec.begin(), _vec.end(), MedianDatacomp());
-      _needsSorting = false;
-    }else {
+    if (_unweightedOK){
       return   _unweightedMedian;
     }
- 
-    float   totWg(_vec.size());
-    size_t  id(0);
+
+    size_t  id = (v_size %2 == 0) ? v_size/2 - 1 : v_size/2;
+    float   vlo(0), vid(0), vhi(0);
+
+    if (_incremental){
+      sortOrder();
+      vid = _vec[_order[id]].val;
+      vlo = id > 0 ? _vec[_order[id-1]].val : vid;
+      vhi = _vec[_order[id+1]].val;
+    } else {
+      std::nth_element(_vec.begin(), _vec.begin()+id, _vec.end(), MedianDatacomp());
+      vid = _vec[id].val;
+      vlo = id > 0 ? std::max_element(_vec.begin(), _vec.begin()+id, MedianDatacomp())->val : vid;
+      vhi = std::min_element(_vec.begin()+id+1, _vec.end(), MedianDatacomp())->val;
+    }
+
+    //cache the result
+    _unweightedMedian = unweightedMedian(vlo, vid, vhi);
+    _unweightedOK     = true;
+
+    return _unweightedMedian;
+  }
+
+  float    MedianCalculator::weightedMedian(float sum, float wid, float vlo, float vid, float vhi) const {
+    float   over((sum)/_totalWeight);
+    float   interpolation(0);
+    if (_vec.size() %2 == 0) {
+      interpolation =  vid * over + vhi * (1.-over);
+    }else {
+      float  w2     = (sum)/_totalWeight;
+      float  w1     = (sum + wid )/_totalWeight;
+      float  val1   = vlo*w1 + vid*(1.-w1);
+      float  val2   = vid*w2 + vhi*(1.-w2);
+      interpolation = 0.5*(val1 + val2);
+    }
+    return interpolation;
+  }
+
+  float    MedianCalculator::unweightedMedian(float vlo, float vid, float vhi) const {
+    size_t  v_size = _vec.size();
+    float   totWg(v_size);
 
     float   interpolation(0);
     if (v_size %2 == 0) {
-      id = v_size/2 - 1;
-      interpolation =  _vec[id].val * 0.5 + _vec[id+1].val * 0.5;
+      interpolation =  vid * 0.5 + vhi * 0.5;
     }else {
-      id = v_size/2;
-      float  sum(id);      
+      float  sum(v_size/2);
       float  w2     = (sum)/totWg;
       float  w1     = (sum + 1.)/totWg;
-      float  val1   = _vec[id-1].val*w1 + _vec[id].val  *(1.-w1);
-      float  val2   = _vec[id].val  *w2 + _vec[id+1].val*(1.-w2);
+      float  val1   = vlo*w1 + vid*(1.-w1);
+      float  val2   = vid*w2 + vhi*(1.-w2);
       interpolation = 0.5*(val1 + val2);
     }
+    return interpolation;
+  }
 
-    //cache the result
-    _weightedMedian = interpolation;
+  void     MedianCalculator::sortOrder(){
+    auto    valueLess = [this](uint32_t i1, uint32_t i2){ return _vec[i1].val < _vec[i2].val; };
+    size_t  v_size    = _vec.size();
+    if (_order.size() != v_size){
+      _order.resize(v_size);
+      std::iota(_order.begin(), _order.end(), 0);
+      std::sort(_order.begin(), _order.end(), valueLess);
+      return;
+    }
 
-    return interpolation;
+    // insertion sort from the previous order, unless the elements move too far
+    const size_t maxMoves(8*v_size);
+    size_t       nMoves(0);
+    for (size_t i=1; i<v_size; ++i){
+      uint32_t  index = _order[i];
+      size_t    j     = i;
+      while (j > 0 && valueLess(index, _order[j-1])){
+        _order[j] = _order[j-1];
+        --j;
+      }
+      _order[j] = index;
+      nMoves += i - j;
+      if (nMoves > maxMoves){
+        std::sort(_order.begin(), _order.end(), valueLess);
+        return;
+      }
+    }
   }
-  
+
 }
@@ -0,0 +1,162 @@
+//
+// Time MedianCalculator on inputs like those of the robust helix fit, and
+// compare it to the full sort it used before:
+//  - triplets: the weighted median of n circle centers from hit triplets,
+//    a core with outliers, as in RobustHelixFit::fitCircleMedian
+//  - AGE: the weighted median radius of n hits, for a sequence of slowly
+//    moving centers, as in RobustHelixFit::fitCircleAGE, computed afresh
+//    and in incremental mode
+// The medians are checked against the sorted reference.
+//
+// usage: medianBenchmark [ntrials]
+//
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include "Offline/Mu2eUtilities/inc/MedianCalculator.hh"
+
+using namespace mu2e;
+
+namespace {
+
+  typedef std::vector<std::pair<float,float> > Data; // value, weight
+
+  // the weighted median as computed before, by sorting
+  float sortedMedian(Data data) {
+    std::sort(data.begin(), data.end(), [](auto const& a, auto const& b){ return a.first < b.first; });
+    float total(0);
+    for (auto const& d : data) total += d.second;
+    size_t id(0);
+    float sum = total - data[0].second;
+    while (sum > 0.5*total && id+1 < data.size()) {
+      ++id;
+      sum -= data[id].second;
+    }
+    float over = sum/total;
+    size_t hi = std::min(id+1, data.size()-1);
+    if (data.size()%2 == 0) return data[id].first*over + data[hi].first*(1.-over);
+    size_t lo = id > 0 ? id-1 : 0;
+    float w1 = (sum + data[id].second)/total;
+    float val1 = data[lo].first*w1 + data[id].first*(1.-w1);
+    float val2 = data[id].first*over + data[hi].first*(1.-over);
+    return 0.5*(val1 + val2);
+  }
+
+  template<class F>
+  double timeIt(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+  }
+
+}
+
+int main(int argc, char** argv) {
+
+  const unsigned ntrials = argc > 1 ? std::stoi(argv[1]) : 2000;
+
+  std::mt19937 gen(12345);
+  std::normal_distribution<float> gauss(0., 1.);
+  std::uniform_real_distribution<float> flat(0., 1.);
+  bool ok = true;
+  volatile float sink(0);
+
+  std::cout << "times in us per median" << std::endl;
+  std::cout << std::setw(10) << "input" << std::setw(8) << "n" << std::setw(10) << "sort"
+            << std::setw(10) << "select" << std::setw(13) << "incremental" << std::setw(12) << "max diff" << std::endl;
+
+  // triplet centers: 80% near the true center, with 5 mm spread, the rest spread over the tracker
+  for (unsigned n : {20, 100, 500}) {
+    std::vector<Data> inputs(ntrials);
+    for (auto& data : inputs) {
+      for (unsigned i=0; i<n; ++i) {
+        float val = flat(gen) < 0.8 ? 250. + 5.*gauss(gen) : 700.*flat(gen) - 350.;
+        data.emplace_back(val, 1. + 4.*flat(gen));
+      }
+    }
+    float maxdiff(0);
+    for (auto const& data : inputs) {
+      MedianCalculator acc(n);
+      for (auto const& d : data) acc.push(d.first, d.second);
+      maxdiff = std::max(maxdiff, std::fabs(acc.weightedMedian() - sortedMedian(data)));
+    }
+    double tsort = timeIt([&]{ for (auto const& data : inputs) sink = sink + sortedMedian(data); });
+    double tsel  = timeIt([&]{
+        for (auto const& data : inputs) {
+          MedianCalculator acc(n);
+          for (auto const& d : data) acc.push(d.first, d.second);
+          sink = sink + acc.weightedMedian();
+        }
+      });
+    if (maxdiff > 1e-3) ok = false;
+    std::cout << std::setw(10) << "triplets" << std::setw(8) << n << std::fixed << std::setprecision(2)
+              << std::setw(10) << tsort/ntrials*1e6 << std::setw(10) << tsel/ntrials*1e6
+              << std::setw(13) << "-" << std::setw(12) << std::scientific << std::setprecision(1) << maxdiff << std::endl;
+  }
+
+  // AGE iterations: hits on a circle of radius 250 mm, 20 steps of 0.5 mm of the center
+  const unsigned nsteps(20);
+  for (unsigned n : {20, 50, 100}) {
+    std::vector<Data> inputs;
+    for (unsigned itrial=0; itrial<ntrials/nsteps+1; ++itrial) {
+      std::vector<std::pair<float,float> > hits(n);
+      std::vector<float> wts(n);
+      for (unsigned i=0; i<n; ++i) {
+        float phi = 6.283*flat(gen);
+        float r = 250. + 2.*gauss(gen);
+        hits[i] = std::make_pair(r*cos(phi), r*sin(phi));
+        wts[i] = 1. + flat(gen);
+      }
+      float cx(0.5*gauss(gen)), cy(0.5*gauss(gen));
+      for (unsigned istep=0; istep<nsteps; ++istep) {
+        Data data;
+        for (unsigned i=0; i<n; ++i) data.emplace_back(std::hypot(hits[i].first-cx, hits[i].second-cy), wts[i]);
+        inputs.push_back(data);
+        cx += 0.5*gauss(gen);
+        cy += 0.5*gauss(gen);
+      }
+    }
+    float maxdiff(0);
+    MedianCalculator inc(n, true);
+    for (auto const& data : inputs) {
+      MedianCalculator acc(n);
+      inc.clear();
+      for (auto const& d : data) {
+        acc.push(d.first, d.second);
+        inc.push(d.first, d.second);
+      }
+      float ref = sortedMedian(data);
+      maxdiff = std::max({maxdiff, std::fabs(acc.weightedMedian() - ref), std::fabs(inc.weightedMedian() - ref)});
+    }
+    double tsort = timeIt([&]{ for (auto const& data : inputs) sink = sink + sortedMedian(data); });
+    double tsel  = timeIt([&]{
+        for (auto const& data : inputs) {
+          MedianCalculator acc(n);
+          for (auto const& d : data) acc.push(d.first, d.second);
+          sink = sink + acc.weightedMedian();
+        }
+      });
+    double tinc  = timeIt([&]{
+        for (auto const& data : inputs) {
+          inc.clear();
+          for (auto const& d : data) inc.push(d.first, d.second);
+          sink = sink + inc.weightedMedian();
+        }
+      });
+    if (maxdiff > 1e-3) ok = false;
+    std::cout << std::setw(10) << "AGE" << std::setw(8) << n << std::fixed << std::setprecision(2)
+              << std::setw(10) << tsort/inputs.size()*1e6 << std::setw(10) << tsel/inputs.size()*1e6
+              << std::setw(13) << tinc/inputs.size()*1e6 << std::setw(12) << std::scientific << std::setprecision(1) << maxdiff << std::endl;
+  }
+
+  if (!ok) std::cout << "ERROR: medians differ from the sorted reference" << std::endl;
+  return ok ? 0 : 1;
+}
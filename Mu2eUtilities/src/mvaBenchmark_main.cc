@@ -0,0 +1,103 @@
+//
+// Time MVATools evaluation one row at a time against the batch evalMVA,
+// on random inputs, for each TMVA MLP weights file given (by default the
+// MLP weights files used in Offline).  Also checks that both give the
+// same results.  The files are found through MU2E_SEARCH_PATH.
+//
+// usage: mvaBenchmark [nrow [weights.xml ...]]
+//
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+#include "Offline/Mu2eUtilities/inc/MVATools.hh"
+
+using namespace mu2e;
+
+namespace {
+
+  const std::vector<std::string> defaultWeights = {
+    "Offline/TrkHitReco/data/BkgMVA.weights.xml",
+    "Offline/TrkHitReco/data/BkgMVAPanel.weights.xml",
+    "Offline/TrkHitReco/test/StereoMVA.weights.xml",
+    "Offline/TrkPatRec/data/TimeCluster.weights.xml",
+    "Offline/TrkPatRec/data/TimeCluster3.weights.xml",
+    "Offline/TrkPatRec/data/TimeClusterCalo.weights.xml",
+    "Offline/TrkPatRec/data/HelixHitMVA.weights.xml",
+    "Offline/TrkPatRec/data/HelixStereoHitMVA.weights.xml",
+    "Offline/TrkPatRec/data/HelixNonStereoHitMVA.weights.xml",
+    "Offline/TrkDiag/data/TrkCaloHitPID.weights.xml",
+    "Offline/AnalysisConditions/weights/TrkQual.weights.xml",
+    "Offline/AnalysisConditions/weights/TrkQualPos.weights.xml",
+    "Offline/AnalysisConditions/weights/TrkQualNeg.weights.xml",
+    "Offline/CaloFilters/data/CE_NN_ReLU.weights.xml"
+  };
+
+  // time per call of f, averaged over enough calls to take about 0.1 s
+  template<class F>
+  double timeIt(F f) {
+    unsigned ncall(0);
+    double elapsed(0.);
+    auto start = std::chrono::steady_clock::now();
+    while (elapsed < 0.1) {
+      f();
+      ++ncall;
+      elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return elapsed/ncall;
+  }
+
+}
+
+int main(int argc, char** argv) {
+
+  const unsigned nrow = argc > 1 ? std::stoi(argv[1]) : 1000;
+  std::vector<std::string> files;
+  for (int i=2; i<argc; ++i) files.push_back(argv[i]);
+  if (files.empty()) files = defaultWeights;
+
+  std::mt19937 gen(12345);
+  std::normal_distribution<float> gauss(0., 1.);
+
+  bool ok = true;
+  std::cout << nrow << " rows, times in ns/row" << std::endl;
+  std::cout << std::setw(52) << std::left << "weights" << std::right << std::setw(6) << "nvar"
+            << std::setw(10) << "single" << std::setw(10) << "batch" << std::setw(8) << "ratio" << std::endl;
+
+  for (const auto& file : files) {
+    MVATools mva(file);
+    mva.initMVA();
+    const unsigned nvar = mva.labels().size();
+
+    std::vector<float> rows(nrow*nvar);
+    for (auto& x : rows) x = gauss(gen);
+
+    std::vector<float> single(nrow), batch(nrow), vars(nvar);
+    auto evalSingle = [&]() {
+      for (unsigned i=0; i<nrow; ++i) {
+        vars.assign(rows.begin()+i*nvar, rows.begin()+(i+1)*nvar);
+        single[i] = mva.evalMVA(vars);
+      }
+    };
+    auto evalBatch = [&]() { mva.evalMVA(rows.data(), nrow, nvar, batch.data()); };
+
+    const double tsingle = timeIt(evalSingle)/nrow*1e9;
+    const double tbatch  = timeIt(evalBatch)/nrow*1e9;
+
+    unsigned ndiff(0);
+    for (unsigned i=0; i<nrow; ++i) if (single[i] != batch[i]) ++ndiff;
+    if (ndiff > 0) {
+      std::cout << "ERROR: " << ndiff << " rows differ between single and batch evaluation" << std::endl;
+      ok = false;
+    }
+
+    std::cout << std::setw(52) << std::left << file << std::right << std::setw(6) << nvar
+              << std::fixed << std::setprecision(1) << std::setw(10) << tsingle << std::setw(10) << tbatch
+              << std::setprecision(2) << std::setw(8) << tsingle/tbatch << std::endl;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -95,6 +95,7 @@ namespace mu2e {
       typedef std::vector<ComboHitCollection::const_iterator> CHCIter;
       // fill a vector of indices to the underlying digis used in a given ComboHit
       // This function is called recursively, so the the vector must be empty on the top-most call
+      // Each call looks up the parent collections in the event; to resolve many hits, use ComboHitLeafIndex
       void fillStrawDigiIndices(art::Event const& event, uint16_t chindex, std::vector<StrawHitIndex>& shids) const;
       // similarly fill to the StrawHit level
       void fillStrawHitIndices(art::Event const& event, uint16_t chindex, std::vector<StrawHitIndex>& shids) const;
@@ -115,11 +116,20 @@ namespace mu2e {
       art::ProductID const& parent() const { return _parent; }
       bool sorted() const { return _sorted; }
       uint16_t nStrawHits() const;
+      // Hits bucketed by unique panel: a producer that writes its hits in unique panel order
+      // calls setPanelOffsets once the collection is complete, and consumers can then take
+      // the hits of a panel directly, as [panelBegin(upanel), panelEnd(upanel)).
+      // setPanelOffsets returns false, and records nothing, if the hits are not in panel order
+      bool setPanelOffsets();
+      bool panelSorted() const { return _panelOffsets.size() == StrawId::_nupanels+1u && _panelOffsets.back() == size(); }
+      uint32_t panelBegin(uint16_t upanel) const { return _panelOffsets[upanel]; }
+      uint32_t panelEnd(uint16_t upanel) const { return _panelOffsets[upanel+1]; }
     private:
       // reference back to the input ComboHit collection this one references
       // This can be used to chain back to the original StrawHit indices
       art::ProductID _parent;
       bool _sorted; // record if this collection was sorted
+      std::vector<uint32_t> _panelOffsets; // first hit of each unique panel, and size(); empty if not in panel order
   };
   inline std::ostream& operator<<( std::ostream& ost,
                                    ComboHit const& hit){
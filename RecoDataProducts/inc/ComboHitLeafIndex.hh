@@ -0,0 +1,54 @@
+#ifndef RecoDataProducts_ComboHitLeafIndex_hh
+#define RecoDataProducts_ComboHitLeafIndex_hh
+//
+// Flattened map from ComboHits to the StrawHits (the bottom, or 'leaf',
+// level of the ComboHit hierarchy) they are made of.  For each ComboHit
+// collection in the event the StrawHit indices of all its hits are stored
+// contiguously, with an offset table (CSR layout), so a hit is resolved
+// with no event lookups or recursion, whatever the depth of the hierarchy.
+//
+// The table for a collection is built the first time it is needed, from
+// the table of its parent, so each collection is visited once per event.
+// A ComboHitLeafIndex refers to products of one event and must not be
+// kept beyond it; create one per event, and only use it from one thread.
+//
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include <deque>
+#include <vector>
+namespace mu2e {
+
+  class ComboHitLeafIndex {
+    public:
+      explicit ComboHitLeafIndex(art::Event const& event) : _event(event), _searched(false) {}
+      // append the StrawHit indices of hit chindex of the given collection.  The collection
+      // can be in the event, or a copy (like HelixSeed::hits()) whose parent is in the event.
+      // These give the same result as the ComboHitCollection functions of the same name.
+      void fillStrawHitIndices(ComboHitCollection const& chcol, uint16_t chindex, std::vector<StrawHitIndex>& shids) const;
+      void fillStrawDigiIndices(ComboHitCollection const& chcol, uint16_t chindex, std::vector<StrawDigiIndex>& sdids) const;
+      // the same for all the hits of the collection
+      void fillStrawHitIndices(ComboHitCollection const& chcol, std::vector<std::vector<StrawHitIndex> >& shids) const;
+      // the StrawHits of hit chindex of the collection in the event with the given ID
+      StrawHitIndex const* begin(art::ProductID const& id, uint16_t chindex) const;
+      StrawHitIndex const* end(art::ProductID const& id, uint16_t chindex) const;
+    private:
+      struct Level {
+	art::ProductID _id;
+	ComboHitCollection const* _chcol; // this collection
+	ComboHitCollection const* _bottom; // the collection at the bottom of the hierarchy
+	std::vector<uint32_t> _offsets; // hit i has StrawHits _shids[_offsets[i]] to _shids[_offsets[i+1]]
+	std::vector<StrawHitIndex> _shids;
+      };
+      Level const& level(art::ProductID const& id) const;
+      void fillLevel(ComboHit const& ch, Level const& parent, std::vector<StrawHitIndex>& shids) const;
+      art::Event const& _event;
+      // the ComboHit collections in the event, found once
+      mutable bool _searched;
+      mutable std::vector<art::Handle<ComboHitCollection> > _handles;
+      // deque, so references to levels stay valid as more are added
+      mutable std::deque<Level> _levels;
+  };
+}
+#endif
@@ -5,6 +5,7 @@
 //
 // Mu2e includes
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitLeafIndex.hh"
 // art includes
 #include "cetlib_except/exception.h"
 // c++ includes
@@ -127,41 +128,8 @@ namespace mu2e {
   }
 
   void ComboHitCollection::fillStrawHitIndices(art::Event const& event, vector<vector<StrawHitIndex> >& shids) const {
-  // reset
-    shids = vector<vector<StrawHitIndex> >(size());
-   // see if this collection references other collections: if so, go down 1 layer
-    if(parent().isValid()){
-    // get the parent handle
-      art::Handle<ComboHitCollection> ph;
-      setParentHandle(event,ph);
-      if(ph.isValid()){
-	const ComboHitCollection *pc = ph.product();
-	// check down 1 more layer
-	if(pc->parent().isValid()){
-	// call down 1 layer
-	  vector<vector<StrawHitIndex>> pshids(size());
-	  pc->fillStrawHitIndices(event,pshids);
-	// roll these up
-	  for(size_t ich=0;ich < size();++ich){
-	    ComboHit const& ch = (*this)[ich];
-	    for(auto iph : ch.indexArray())
-	      shids[ich].insert(shids[ich].end(),pshids[iph].begin(),pshids[iph].end());
-	  }
-	} else {
-	  // can skip a step in the hierarchy since the parent of this collection is at the top
-	  for(size_t ich=0;ich < size();++ich){
-	    ComboHit const& ch = (*this)[ich];
-	    shids[ich].insert(shids[ich].end(),ch.indexArray().begin(),ch.indexArray().end());
-	  }
-	}
-      } else {
-	throw cet::exception("RECO")<<"mu2e::ComboHitCollection: Can't find parent collection" << std::endl;
-      }
-    } else {
-    // already at the top: fill with self index
-      for(size_t ich = 0;ich < size(); ++ich)
-	shids[ich].push_back(ich);
-    }
+    ComboHitLeafIndex leafIndex(event);
+    leafIndex.fillStrawHitIndices(*this,shids);
   }
 
   void ComboHitCollection::fillComboHits(art::Event const& event, std::vector<uint16_t> const& indices, CHCIter& iters) const {
@@ -220,6 +188,21 @@ namespace mu2e {
     return retval;
   }
 
+  bool ComboHitCollection::setPanelOffsets() {
+    _panelOffsets.clear();
+    std::vector<uint32_t> offsets(StrawId::_nupanels+1);
+    size_t ich(0);
+    for(uint16_t upanel = 0; upanel < StrawId::_nupanels; ++upanel){
+      offsets[upanel] = ich;
+      while(ich < size() && (*this)[ich].strawId().uniquePanel() == upanel) ++ich;
+    }
+    offsets[StrawId::_nupanels] = ich;
+    // a hit out of panel order stops the scan early
+    if(ich != size()) return false;
+    _panelOffsets.swap(offsets);
+    return true;
+  }
+
   void ComboHit::print( std::ostream& ost, bool doEndl) const {
     ost << " ComboHit:"
         << " id "      << _sid
@@ -0,0 +1,100 @@
+//
+// Flattened map from ComboHits to their StrawHits
+//
+#include "Offline/RecoDataProducts/inc/ComboHitLeafIndex.hh"
+#include "cetlib_except/exception.h"
+using std::vector;
+namespace mu2e {
+
+  ComboHitLeafIndex::Level const& ComboHitLeafIndex::level(art::ProductID const& id) const {
+    for(auto const& lev : _levels)
+      if(lev._id == id)return lev;
+    // find the collection; all the collections are looked up once
+    if(!_searched){
+      _handles = _event.getMany<ComboHitCollection>();
+      _searched = true;
+    }
+    ComboHitCollection const* chcol(0);
+    for(auto const& handle : _handles){
+      if(handle.id() == id){
+	chcol = handle.product();
+	break;
+      }
+    }
+    if(chcol == 0)
+      throw cet::exception("RECO")<<"mu2e::ComboHitLeafIndex: Can't find ComboHit collection" << std::endl;
+    // build the parent first; this recursion is once per collection, not per hit
+    Level const* parent(0);
+    if(chcol->parent().isValid()) parent = &level(chcol->parent());
+    _levels.emplace_back();
+    Level& lev = _levels.back();
+    lev._id = id;
+    lev._chcol = chcol;
+    lev._bottom = parent ? parent->_bottom : chcol;
+    lev._offsets.reserve(chcol->size()+1);
+    lev._offsets.push_back(0);
+    if(parent){
+      lev._shids.reserve(chcol->nStrawHits());
+      for(auto const& ch : *chcol){
+	fillLevel(ch,*parent,lev._shids);
+	lev._offsets.push_back(lev._shids.size());
+      }
+    } else {
+      // the bottom: hits are StrawHits, and the index is the hit itself
+      lev._shids.reserve(chcol->size());
+      for(size_t ich=0;ich < chcol->size(); ++ich){
+	ComboHit const& ch = (*chcol)[ich];
+	if(ch.nCombo() != 1 || ch.nStrawHits() != 1)
+	  throw cet::exception("RECO")<<"mu2e::ComboHitLeafIndex: invalid ComboHit" << std::endl;
+	lev._shids.push_back(ich);
+	lev._offsets.push_back(lev._shids.size());
+      }
+    }
+    return lev;
+  }
+
+  void ComboHitLeafIndex::fillLevel(ComboHit const& ch, Level const& parent, vector<StrawHitIndex>& shids) const {
+    for(uint16_t iind = 0;iind < ch.nCombo(); ++iind){
+      uint16_t pind = ch.index(iind);
+      if(pind+1u >= parent._offsets.size())
+	throw cet::exception("RECO")<<"mu2e::ComboHitLeafIndex: invalid ComboHit index" << std::endl;
+      shids.insert(shids.end(),parent._shids.begin()+parent._offsets[pind],parent._shids.begin()+parent._offsets[pind+1]);
+    }
+  }
+
+  StrawHitIndex const* ComboHitLeafIndex::begin(art::ProductID const& id, uint16_t chindex) const {
+    Level const& lev = level(id);
+    return lev._shids.data() + lev._offsets.at(chindex);
+  }
+
+  StrawHitIndex const* ComboHitLeafIndex::end(art::ProductID const& id, uint16_t chindex) const {
+    Level const& lev = level(id);
+    return lev._shids.data() + lev._offsets.at(chindex+1);
+  }
+
+  void ComboHitLeafIndex::fillStrawHitIndices(ComboHitCollection const& chcol, uint16_t chindex, vector<StrawHitIndex>& shids) const {
+    ComboHit const& ch = chcol.at(chindex);
+    if(chcol.parent().isValid()){
+      fillLevel(ch,level(chcol.parent()),shids);
+    } else {
+      if(ch.nCombo() != 1 || ch.nStrawHits() != 1)
+	throw cet::exception("RECO")<<"mu2e::ComboHitLeafIndex: invalid ComboHit" << std::endl;
+      shids.push_back(chindex);
+    }
+  }
+
+  void ComboHitLeafIndex::fillStrawDigiIndices(ComboHitCollection const& chcol, uint16_t chindex, vector<StrawDigiIndex>& sdids) const {
+    // the StrawHits at the bottom reference the digis
+    ComboHitCollection const* bottom = chcol.parent().isValid() ? level(chcol.parent())._bottom : &chcol;
+    size_t first = sdids.size();
+    fillStrawHitIndices(chcol,chindex,sdids);
+    for(size_t ish = first; ish < sdids.size(); ++ish)
+      sdids[ish] = (*bottom)[sdids[ish]].index(0);
+  }
+
+  void ComboHitLeafIndex::fillStrawHitIndices(ComboHitCollection const& chcol, vector<vector<StrawHitIndex> >& shids) const {
+    shids = vector<vector<StrawHitIndex> >(chcol.size());
+    for(size_t ich=0;ich < chcol.size(); ++ich)
+      fillStrawHitIndices(chcol,ich,shids[ich]);
+  }
+}
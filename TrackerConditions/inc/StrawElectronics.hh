@@ -46,6 +46,17 @@ namespace mu2e {
         _sigma(sigma), _t0(t0) {};
     };
 
+    // the parts of the linear response of a cluster that don't depend on time: the
+    // interpolation between the tabulated wire distances and the reflected pulse.
+    // Compute it once per cluster with clusterResponse, then sample it with sampleResponse
+    struct ClusterResponse {
+      int _distIndex; // lower tabulated wire distance
+      double _distFrac; // weight of the lower wire distance
+      double _reflTime; // delay of the reflected pulse
+      double _reflScale; // relative amplitude of the reflected pulse
+      double _charge;
+    };
+
     typedef std::shared_ptr<StrawElectronics> ptr_t;
     typedef std::shared_ptr<const StrawElectronics> cptr_t;
     constexpr static const char* cxname = {"StrawElectronics"};
@@ -108,11 +119,17 @@ namespace mu2e {
     // linear response to a charge pulse.  This does NOT include saturation effects,
     // since those are cumulative and cannot be computed for individual charges
     double linearResponse(Straw const& straw, Path ipath, double time, double charge, double distance, bool forsaturation=false) const; // mvolts per pCoulomb
+    ClusterResponse clusterResponse(Straw const& straw, double charge, double distance) const;
+    // same as linearResponse for the charge and distance of cresp
+    inline double sampleResponse(StrawId sid, Path ipath, ClusterResponse const& cresp, double time, bool forsaturation=false) const;
+    // add sampleResponse at times[i]-ctime to resp[i], i<n, for a clust at ctime.  Same values as sampleResponse
+    void addResponse(StrawId sid, Path ipath, ClusterResponse const& cresp, double ctime, double const* times, size_t n, double* resp, bool forsaturation=false) const;
     double adcImpulseResponse(StrawId sid, double time, double charge) const;
     // Given a (linear) total voltage, compute the saturated voltage
     double saturatedResponse(double lineearresponse) const;
     // relative time when linear response is maximal
     double maxResponseTime(StrawId id, Path ipath,double distance) const;
+    double maxResponseTime(StrawId id, Path ipath, ClusterResponse const& cresp) const;
     // digization
     TrkTypes::ADCValue adcResponse(StrawId id, double mvolts) const; // ADC response to analog inputs
     TrkTypes::TDCValue tdcResponse(double time) const; // TDC response to a signal input to electronics at a given time (in ns since eventWindowMarker)
@@ -155,6 +172,7 @@ namespace mu2e {
     
     double currentToVoltage(StrawId sid, Path ipath) const { return _dVdI[ipath][sid.uniqueStraw()]; }
     double maxLinearResponse(StrawId sid, Path ipath,double distance,double charge=1.0) const;
+    double maxLinearResponse(StrawId sid, Path ipath, ClusterResponse const& cresp) const;
     double clusterLookbackTime() const { return _clusterLookbackTime;}
     
     double truncationTime(Path ipath) const { return _ttrunc[ipath];}
@@ -246,6 +264,8 @@ namespace mu2e {
     // but an actual TDC value that will be compared against
     // helper functions
     static inline double mypow(double,unsigned);
+    // find the tabulated wire distances around distance, and the weight of the lower one
+    void distanceBin(double distance, int& distIndex, double& distFrac) const;
     
     int _responseBins;
     double _sampleRate;
@@ -284,7 +304,29 @@ namespace mu2e {
     double _timeFromProtonsToDRMarker;
 
   };
-  
+
+  // the response tables are sampled at _sampleRate, centered on the cluster time
+  inline double StrawElectronics::sampleResponse(StrawId sid, Path ipath, ClusterResponse const& cresp, double time, bool forsaturation) const {
+    int index = time*_sampleRate + _responseBins/2.;
+    if ( index >= _responseBins)
+      index = _responseBins-1;
+    if (index < 0)
+      index = 0;
+    int index_refl = (time - cresp._reflTime)*_sampleRate + _responseBins/2.;
+    if (index_refl >= _responseBins)
+      index_refl = _responseBins-1;
+    if (index_refl < 0)
+      index_refl = 0;
+
+    WireDistancePoint const& w0 = _wPoints[cresp._distIndex];
+    WireDistancePoint const& w1 = _wPoints[cresp._distIndex + 1];
+    std::vector<double> const& r0 = ipath == adc ? w0._adcResponse : forsaturation ? w0._preampToAdc1Response : w0._preampResponse;
+    std::vector<double> const& r1 = ipath == adc ? w1._adcResponse : forsaturation ? w1._preampToAdc1Response : w1._preampResponse;
+    double p0 = r0[index] + r0[index_refl]*cresp._reflScale;
+    double p1 = r1[index] + r1[index_refl]*cresp._reflScale;
+    return cresp._charge * ( p0 * cresp._distFrac + p1 * (1 - cresp._distFrac)) * _dVdI[ipath][sid.uniqueStraw()];
+  }
+
 }
 
 #endif
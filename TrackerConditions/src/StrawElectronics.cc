@@ -67,44 +67,57 @@ namespace mu2e {
       response[i] *= 1 / gain_160;
   }
 
-  double StrawElectronics::linearResponse(Straw const& straw, Path ipath, double time, double charge, double distance, bool forsaturation) const {
-    int index = time*_sampleRate + _responseBins/2.;
-    if ( index >= _responseBins)
-      index = _responseBins-1;
-    if (index < 0)
-      index = 0;
-
-    double straw_length = 2*straw.halfLength();
-    double reflection_time = _reflectionTimeShift + (2*straw_length-2*distance)/_reflectionVelocity;
-    int index_refl = (time - reflection_time)*_sampleRate + _responseBins/2.;
-    if (index_refl >= _responseBins)
-      index_refl = _responseBins-1;
-    if (index_refl < 0)
-      index_refl = 0;
-
-    double reflection_scale = _reflectionFrac * exp(-(2*straw_length-2*distance)/_reflectionALength);
-
-    int  distIndex = 0;
+  void StrawElectronics::distanceBin(double distance, int& distIndex, double& distFrac) const {
+    distIndex = 0;
     for (size_t i=1;i<_wPoints.size()-1;i++){
       if (distance < _wPoints[i]._distance)
         break;
       distIndex = i;
     }
-    double distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
-    double p0, p1;
-    if (ipath == thresh){
-      if (forsaturation){
-        p0 = _wPoints[distIndex]._preampToAdc1Response[index]      + _wPoints[distIndex]._preampToAdc1Response[index_refl]*reflection_scale;
-        p1 = _wPoints[distIndex + 1]._preampToAdc1Response[index]  + _wPoints[distIndex + 1]._preampToAdc1Response[index_refl]*reflection_scale;
-      }else{
-        p0 = _wPoints[distIndex]._preampResponse[index]      + _wPoints[distIndex]._preampResponse[index_refl]*reflection_scale;
-        p1 = _wPoints[distIndex + 1]._preampResponse[index]  + _wPoints[distIndex + 1]._preampResponse[index_refl]*reflection_scale;
-      }
-    }else{
-      p0 = _wPoints[distIndex]._adcResponse[index]      + _wPoints[distIndex]._adcResponse[index_refl]*reflection_scale;
-      p1 = _wPoints[distIndex + 1]._adcResponse[index]  + _wPoints[distIndex + 1]._adcResponse[index_refl]*reflection_scale;
+    distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
+  }
+
+  StrawElectronics::ClusterResponse StrawElectronics::clusterResponse(Straw const& straw, double charge, double distance) const {
+    ClusterResponse cresp;
+    double straw_length = 2*straw.halfLength();
+    cresp._reflTime = _reflectionTimeShift + (2*straw_length-2*distance)/_reflectionVelocity;
+    cresp._reflScale = _reflectionFrac * exp(-(2*straw_length-2*distance)/_reflectionALength);
+    distanceBin(distance,cresp._distIndex,cresp._distFrac);
+    cresp._charge = charge;
+    return cresp;
+  }
+
+  double StrawElectronics::linearResponse(Straw const& straw, Path ipath, double time, double charge, double distance, bool forsaturation) const {
+    return sampleResponse(straw.id(),ipath,clusterResponse(straw,charge,distance),time,forsaturation);
+  }
+
+  void StrawElectronics::addResponse(StrawId sid, Path ipath, ClusterResponse const& cresp, double ctime,
+      double const* times, size_t n, double* resp, bool forsaturation) const {
+    // sampleResponse with the table selection and the scale factors taken out of the loop, which
+    // is left with the index computation and the table lookups (gather) only.
+    std::vector<double> const& v0 = ipath == adc ? _wPoints[cresp._distIndex]._adcResponse :
+      forsaturation ? _wPoints[cresp._distIndex]._preampToAdc1Response : _wPoints[cresp._distIndex]._preampResponse;
+    std::vector<double> const& v1 = ipath == adc ? _wPoints[cresp._distIndex+1]._adcResponse :
+      forsaturation ? _wPoints[cresp._distIndex+1]._preampToAdc1Response : _wPoints[cresp._distIndex+1]._preampResponse;
+    const double* r0 = v0.data();
+    const double* r1 = v1.data();
+    const double reflTime = cresp._reflTime;
+    const double reflScale = cresp._reflScale;
+    const double frac0 = cresp._distFrac;
+    const double frac1 = 1 - cresp._distFrac;
+    const double charge = cresp._charge;
+    const double dVdI = _dVdI[ipath][sid.uniqueStraw()];
+    const double sampleRate = _sampleRate;
+    const double offset = _responseBins/2.;
+    const int maxIndex = _responseBins-1;
+    for (size_t i=0;i<n;i++){
+      double time = times[i]-ctime;
+      int index = std::min(std::max(int(time*sampleRate + offset),0),maxIndex);
+      int index_refl = std::min(std::max(int((time - reflTime)*sampleRate + offset),0),maxIndex);
+      double p0 = r0[index] + r0[index_refl]*reflScale;
+      double p1 = r1[index] + r1[index_refl]*reflScale;
+      resp[i] += charge * ( p0 * frac0 + p1 * frac1) * dVdI;
     }
-    return charge * ( p0 * distFrac + p1 * (1 - distFrac)) * _dVdI[ipath][straw.id().uniqueStraw()];
   }
 
   double StrawElectronics::adcImpulseResponse(StrawId sid, double time, double charge) const {
@@ -124,31 +137,30 @@ namespace mu2e {
   }
 
   double StrawElectronics::maxResponseTime(StrawId sid, Path ipath,double distance) const {
-    int  distIndex = 0;
-    for (size_t i=1;i<_wPoints.size()-1;i++){
-      if (distance < _wPoints[i]._distance)
-        break;
-      distIndex = i;
-    }
-    double distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
-    double p0 = _wPoints[distIndex]._tmax[ipath][sid.getStraw()];
-    double p1 = _wPoints[distIndex + 1]._tmax[ipath][sid.getStraw()];
+    ClusterResponse cresp;
+    distanceBin(distance,cresp._distIndex,cresp._distFrac);
+    return maxResponseTime(sid,ipath,cresp);
+  }
+
+  double StrawElectronics::maxResponseTime(StrawId sid, Path ipath, ClusterResponse const& cresp) const {
+    double p0 = _wPoints[cresp._distIndex]._tmax[ipath][sid.getStraw()];
+    double p1 = _wPoints[cresp._distIndex + 1]._tmax[ipath][sid.getStraw()];
     
-    return p0 * distFrac + p1 * (1 - distFrac);
+    return p0 * cresp._distFrac + p1 * (1 - cresp._distFrac);
   }
 
   double StrawElectronics::maxLinearResponse(StrawId sid, Path ipath,double distance,double charge) const {
-    int  distIndex = 0;
-    for (size_t i=1;i<_wPoints.size()-1;i++){
-      if (distance < _wPoints[i]._distance)
-        break;
-      distIndex = i;
-    }
-    double distFrac = 1 - (distance - _wPoints[distIndex]._distance)/(_wPoints[distIndex+1]._distance - _wPoints[distIndex]._distance);
-    double p0 = _wPoints[distIndex]._linmax[ipath][sid.getStraw()];
-    double p1 = _wPoints[distIndex + 1]._linmax[ipath][sid.getStraw()];
+    ClusterResponse cresp;
+    distanceBin(distance,cresp._distIndex,cresp._distFrac);
+    cresp._charge = charge;
+    return maxLinearResponse(sid,ipath,cresp);
+  }
+
+  double StrawElectronics::maxLinearResponse(StrawId sid, Path ipath, ClusterResponse const& cresp) const {
+    double p0 = _wPoints[cresp._distIndex]._linmax[ipath][sid.getStraw()];
+    double p1 = _wPoints[cresp._distIndex + 1]._linmax[ipath][sid.getStraw()];
  
-    return charge * (p0 * distFrac + p1 * (1 - distFrac)) * _dVdI[ipath][sid.uniqueStraw()];
+    return cresp._charge * (p0 * cresp._distFrac + p1 * (1 - cresp._distFrac)) * _dVdI[ipath][sid.uniqueStraw()];
   }
 
   ADCValue StrawElectronics::adcResponse(StrawId sid, double mvolts) const {
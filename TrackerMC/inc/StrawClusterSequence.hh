@@ -2,20 +2,23 @@
 #define TrackerMC_StrawClusterSequence_hh
 //
 // StrawClusterSequence is a time-ordered sequence of StrawClusters
+// The clusters are stored contiguously.  They can either be inserted one
+// at a time in time order, or appended in any order and then sorted once
+// with sort(), when all the clusters of the event have been added.
 //
 // Original author David Brown, LBNL
 //
 
 // C++ includes
 #include <iostream>
-#include <list>
+#include <vector>
 // Mu2e includes
 #include "Offline/TrackerMC/inc/StrawCluster.hh"
 #include "Offline/DataProducts/inc/StrawId.hh"
 
 namespace mu2e {
   namespace TrackerMC {
-    typedef std::list<StrawCluster> StrawClusterList;
+    typedef std::vector<StrawCluster> StrawClusterList;
     class StrawClusterSequence {
       public:
 	// constructors
@@ -28,9 +31,15 @@ namespace mu2e {
 	StrawClusterList const& clustList() const { return _clist; }
 	// insert a new clust, in time order.
 	StrawClusterList::iterator insert(StrawCluster const& clust);
+	// append a new clust without ordering.  sort() must be called before the sequence is used
+	void append(StrawCluster const& clust);
+	// put the appended clusts in time order
+	void sort();
 	StrawId const& strawId() const { return _strawId; }
 	StrawEnd const& strawEnd() const { return _end; }
       private:
+	// check that the clust can be added, and take the straw and end of the first one
+	void checkClust(StrawCluster const& clust);
 	StrawId _strawId;
 	StrawEnd _end;
 	StrawClusterList _clist; // time-ordered sequence of clusts
@@ -17,6 +17,8 @@ namespace mu2e {
 	StrawClusterSequence& clustSequence(StrawEnd end) { return _scseq[end]; }
 	StrawClusterSequence const& clustSequence(StrawEnd end) const { return _scseq[end]; }
 	void insert(StrawClusterPair const& hpair);
+	// time-order the clusts appended to both sequences
+	void sort() { _scseq[StrawEnd::cal].sort(); _scseq[StrawEnd::hv].sort(); }
 	StrawId strawId() const { return _scseq[0].strawId(); }
       private:
 	StrawClusterSequence _scseq[2];
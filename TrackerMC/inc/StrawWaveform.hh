@@ -41,7 +41,7 @@ namespace mu2e {
     class StrawWaveform{
       public:
 	// construct from a clust sequence and response object.  Scale affects the voltage
-	StrawWaveform(Straw const& straw, StrawClusterSequence const& hseqq, XTalk const& xtalk);
+	StrawWaveform(StrawElectronics const& strawele, Straw const& straw, StrawClusterSequence const& hseqq, XTalk const& xtalk);
 	// disallow copy and assignment
 	StrawWaveform() = delete; // don't allow default constructor, references can't be assigned empty
 	StrawWaveform(StrawWaveform const& other);
@@ -57,12 +57,17 @@ namespace mu2e {
         unsigned short digitizeTOT(StrawElectronics const& strawele, double threshold, double time) const;
 	//accessors
 	StrawClusterSequence const& clusts() const { return _cseq; }
+	// the time-ordered clusts, contiguous in memory
+	StrawClusterList::const_iterator clustBegin() const { return _cbegin; }
+	StrawClusterList::const_iterator clustEnd() const { return _cend; }
 	XTalk const& xtalk() const { return _xtalk; }
 	StrawEnd const& strawEnd() const { return _cseq.strawEnd(); }
         Straw const& straw() const { return _straw;}
       private:
 	// clust sequence used in this waveform
 	StrawClusterSequence const& _cseq;
+	StrawClusterList::const_iterator _cbegin, _cend; // range of the clusts, the sequence must not change
+	std::vector<StrawElectronics::ClusterResponse> _cresp; // time-independent response of each clust
 	XTalk _xtalk; // X-talk applied to all voltages
         Straw const& _straw;
 	// helper functions
@@ -70,6 +75,7 @@ namespace mu2e {
 	bool roughCrossing(StrawElectronics const& strawele, double threshold, WFX& wfx) const;
 	bool fineCrossing(StrawElectronics const& strawele, double threshold, double vmax, WFX& wfx) const;
 	double maxLinearResponse(StrawElectronics const& strawele,StrawClusterList::const_iterator const& iclust) const;
+	StrawElectronics::ClusterResponse const& clustResponse(StrawClusterList::const_iterator const& iclust) const { return _cresp[iclust-_cbegin]; }
     };
 
     struct WFX { // waveform crossing
@@ -79,7 +85,7 @@ namespace mu2e {
       StrawClusterList::const_iterator _iclust; // iterator to clust associated with this crossing
       WFX() = delete; // disallow
       WFX(StrawWaveform const& wf, double time) : _time(time), _vstart(0.0), _vcross(0.0),
-      _iclust(wf.clusts().clustList().begin()) {}
+      _iclust(wf.clustBegin()) {}
       // sorting function
       bool operator < (WFX const& other) { return _time < other._time; }
     };
@@ -6,6 +6,7 @@
 // mu2e includes
 #include "Offline/TrackerMC/inc/StrawClusterSequence.hh"
 #include "cetlib_except/exception.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -35,14 +36,32 @@ namespace mu2e {
       }
       return *this;
     }
-    // insert a new clust.  This is the only non-trivial function
+    // insert a new clust, after the clusts with an earlier time
     StrawClusterList::iterator StrawClusterSequence::insert(StrawCluster const& clust) {
-      StrawClusterList::iterator retval = _clist.end();
+      checkClust(clust);
+      auto ibefore = std::lower_bound(_clist.begin(),_clist.end(),clust,
+	  [](StrawCluster const& a, StrawCluster const& b) { return a.time() < b.time(); });
+      return _clist.insert(ibefore,clust);
+    }
+
+    void StrawClusterSequence::append(StrawCluster const& clust) {
+      checkClust(clust);
+      _clist.push_back(clust);
+    }
+
+    void StrawClusterSequence::sort() {
+      // insert() puts a clust before the clusts with the same time: reverse the
+      // appended clusts so that the stable sort gives the same order
+      std::reverse(_clist.begin(),_clist.end());
+      std::stable_sort(_clist.begin(),_clist.end(),
+	  [](StrawCluster const& a, StrawCluster const& b) { return a.time() < b.time(); });
+    }
+
+    void StrawClusterSequence::checkClust(StrawCluster const& clust) {
       if(clust.type() == StrawCluster::unknown){
 	throw cet::exception("SIM")
 	  << "mu2e::StrawClusterSequence: tried to add unknown clust type"
 	  << endl;
-	return retval;
       }
       // make sure the straw and end are the same
       if(!_clist.empty() && (clust.strawId() != strawId()
@@ -50,21 +69,11 @@ namespace mu2e {
 	throw cet::exception("SIM")
 	  << "mu2e::StrawClusterSequence: tried to add clust from a different straw/end to a sequence"
 	  << endl;
-	return retval;
       }
       if(_clist.empty()){
-	_clist.push_front(clust);
 	_strawId = clust.strawId();
 	_end = clust.strawEnd();
-	retval = _clist.begin();
-      } else {
-	// loop over the contents and insert in the correct place
-	StrawClusterList::iterator ibefore = _clist.begin();
-	while(ibefore != _clist.end() && ibefore->time() < clust.time())
-	  ++ibefore;
-	retval = _clist.insert(ibefore,clust);
       }
-      return retval;
     }
   }
 }
@@ -51,6 +51,7 @@
 #include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandExponential.h"
 #include "CLHEP/Random/RandPoisson.h"
+#include "CLHEP/Random/JamesRandom.h"
 #include "CLHEP/Vector/LorentzVector.h"
 // root
 #include "TMath.h"
@@ -59,6 +60,9 @@
 #include "TGraph.h"
 #include "TMarker.h"
 #include "TTree.h"
+// TBB
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
 // C++
 #include <map>
 #include <algorithm>
@@ -117,6 +121,7 @@ namespace mu2e {
 	  fhicl::Atom<string> spinstance { Name("StrawGasStepInstance"), Comment("StrawGasStep Instance name"),""};
 	  fhicl::Atom<string> spmodule { Name("StrawGasStepModule"), Comment("StrawGasStep Module name"),""};
 	  fhicl::Sequence<art::InputTag> SPTO { Name("TimeOffsets"), Comment("Sim Particle Time Offset Maps")};
+	  fhicl::Atom<bool> parallelPanels{ Name("ParallelPanels"), Comment("Digitize the panels in parallel, with per-panel random streams, when there are no diagnostics"),false };
 
 	};
 
@@ -128,6 +133,12 @@ namespace mu2e {
 	typedef std::array<WFX,2> WFXP;
 	typedef list<WFXP> WFXPList;
 	typedef WFXPList::const_iterator WFXPI;
+	// digis of one panel, when the panels are digitized in parallel
+	struct PanelDigis {
+	  StrawDigiCollection _digis;
+	  StrawDigiADCWaveformCollection _digiadcs;
+	  StrawDigiMCCollection _mcdigis;
+	};
 
 	using Parameters = art::EDProducer::Table<Config>;
 	explicit StrawDigisFromStrawGasSteps(const Parameters& config);
@@ -163,6 +174,7 @@ namespace mu2e {
 	std::vector<uint16_t> _allPlanes;
 	unsigned _maxnclu;
 	StrawElectronics::Path _diagpath; 
+	bool _parallelPanels; // digitize the panels in TBB tasks
 	// Random number distributions
 	art::RandomNumberGenerator::base_engine_t& _engine;
 	CLHEP::RandGaussQ _randgauss;
@@ -239,21 +251,30 @@ namespace mu2e {
 	double microbunchTime(StrawElectronics const& strawele, double globaltime) const;
 	void addGhosts(StrawElectronics const& strawele, StrawCluster const& clust,StrawClusterSequence& shs);
 	void addNoise(StrawClusterMap& hmap);
-	void findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, WFXPList& xings);
+	void findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, CLHEP::RandGaussQ& randgauss, WFXPList& xings);
+	// digitize one straw, and its cross-talk into the neighboring straws of the same panel
+	void digitizeStraw(StrawPhysics const& strawphys,
+	    StrawElectronics const& strawele,
+	    Tracker const& tracker,
+	    StrawClusterSequencePair const& hsp,
+	    CLHEP::RandGaussQ& randgauss,
+	    StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
 	void createDigis(StrawPhysics const& strawphys,
 	    StrawElectronics const& strawele,
 	    Tracker const& tracker,
             Straw const& straw,
 	    StrawClusterSequencePair const& hsp,
 	    XTalk const& xtalk,
+	    CLHEP::RandGaussQ& randgauss,
 	    StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
 	void fillDigis(StrawPhysics const& strawphys,
 	    StrawElectronics const& strawele,
 	    Tracker const& tracker,
 	    WFXPList const& xings,SWFP const& swfp , StrawId sid,
+	    CLHEP::RandGaussQ& randgauss,
 	    StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, StrawDigiMCCollection* mcdigis);
-	bool createDigi(StrawElectronics const& strawele,WFXP const& xpair, SWFP const& wf, StrawId sid, StrawDigiCollection* digis,
-            StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time);
+	bool createDigi(StrawElectronics const& strawele,WFXP const& xpair, SWFP const& wf, StrawId sid, CLHEP::RandGaussQ& randgauss,
+	    StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time);
 	void findCrossTalkStraws(Straw const& straw,vector<XTalk>& xtalk);
 	void fillClusterNe(StrawPhysics const& strawphys,std::vector<unsigned>& me);
 	void fillClusterPositions(StrawGasStep const& step, Straw const& straw, std::vector<StrawPosition>& cpos);
@@ -297,6 +318,7 @@ namespace mu2e {
       _allPlanes(config().allPlanes()),
       _maxnclu(config().maxnclu()),
       _diagpath(static_cast<StrawElectronics::Path>(config().diagpath())),
+      _parallelPanels(config().parallelPanels()),
       // Random number distributions
       _engine(createEngine( art::ServiceHandle<SeedService>()->getSeed())),
       _randgauss( _engine ),
@@ -479,27 +501,39 @@ namespace mu2e {
       fillClusterMap(strawphys,strawele,tracker,event,hmap);
       // add noise clusts
       if(_addNoise)addNoise(hmap);
-      // loop over the clust sequences (i.e. loop over straws, and for each get their list of clusters)
-      for(auto ihsp=hmap.begin();ihsp!= hmap.end();++ihsp){
-	StrawClusterSequencePair const& hsp = ihsp->second;
-	Straw const& straw = tracker.getStraw(hsp.strawId());
-	// create primary digis from this clust sequence
-	XTalk self(hsp.strawId()); // this object represents the straws coupling to itself, ie 100%
-	createDigis(strawphys,strawele,tracker,straw,hsp,self,digis.get(),digiadcs.get(),mcdigis.get());
-	// if we're applying x-talk, look for nearby coupled straws
-	if(_addXtalk) {
-	  // only apply if the charge is above a threshold
-	  double totalCharge = 0;
-	  for(auto ih=hsp.clustSequence(StrawEnd::cal).clustList().begin();ih!= hsp.clustSequence(StrawEnd::cal).clustList().end();++ih){
-	    totalCharge += ih->charge();
-	  }
-	  if( totalCharge > _ctMinCharge){
-	    vector<XTalk> xtalk;
-	    findCrossTalkStraws(straw,xtalk);
-	    for(auto ixtalk=xtalk.begin();ixtalk!=xtalk.end();++ixtalk){
-	      createDigis(strawphys,strawele,tracker,straw,hsp,*ixtalk,digis.get(),digiadcs.get(),mcdigis.get());
+      // the clusts were appended in step order: time-order each sequence once
+      for(auto& ihsp : hmap) ihsp.second.sort();
+      if(!_parallelPanels || _diag > 0 || _debug > 0){
+	// loop over the clust sequences (i.e. loop over straws, and for each get their list of clusters)
+	for(auto ihsp=hmap.begin();ihsp!= hmap.end();++ihsp){
+	  digitizeStraw(strawphys,strawele,tracker,ihsp->second,_randgauss,digis.get(),digiadcs.get(),mcdigis.get());
+	}
+      } else {
+	// Cross-talk stays inside a panel, so the panels can be digitized independently.  Each panel
+	// gets its own random engine, seeded from one number drawn from the module engine per event,
+	// so the result doesn't depend on the scheduling.  The map is ordered by StrawId, which orders
+	// the straws by panel: the digis are merged in panel order, in the same order as the serial loop
+	std::vector<std::vector<StrawClusterSequencePair const*> > panels(StrawId::_nupanels);
+	for(auto const& ihsp : hmap) panels[ihsp.first.uniquePanel()].push_back(&ihsp.second);
+	const long maxseed = 900000000/StrawId::_nupanels; // HepJamesRandom seeds are < 900000000
+	const long evtseed = _randflat.fireInt(maxseed);
+	std::vector<PanelDigis> pdigis(StrawId::_nupanels);
+	tbb::parallel_for(tbb::blocked_range<size_t>(0,StrawId::_nupanels),
+	    [&](const tbb::blocked_range<size_t>& range) {
+	    for(size_t ipanel=range.begin(); ipanel!=range.end(); ++ipanel){
+	      if(panels[ipanel].empty())continue;
+	      CLHEP::HepJamesRandom engine(evtseed*StrawId::_nupanels + ipanel);
+	      CLHEP::RandGaussQ randgauss(engine);
+	      PanelDigis& pd = pdigis[ipanel];
+	      for(auto hsp : panels[ipanel]){
+		digitizeStraw(strawphys,strawele,tracker,*hsp,randgauss,&pd._digis,&pd._digiadcs,&pd._mcdigis);
+	      }
 	    }
-	  }
+	    });
+	for(auto& pd : pdigis){
+	  digis->insert(digis->end(),std::make_move_iterator(pd._digis.begin()),std::make_move_iterator(pd._digis.end()));
+	  digiadcs->insert(digiadcs->end(),std::make_move_iterator(pd._digiadcs.begin()),std::make_move_iterator(pd._digiadcs.end()));
+	  mcdigis->insert(mcdigis->end(),std::make_move_iterator(pd._mcdigis.begin()),std::make_move_iterator(pd._mcdigis.end()));
 	}
       }
       // store the digis in the event
@@ -513,6 +547,35 @@ namespace mu2e {
 
     } // end produce
 
+    void StrawDigisFromStrawGasSteps::digitizeStraw(
+	StrawPhysics const& strawphys,
+	StrawElectronics const& strawele,
+	Tracker const& tracker,
+	StrawClusterSequencePair const& hsp,
+	CLHEP::RandGaussQ& randgauss,
+	StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
+        StrawDigiMCCollection* mcdigis) {
+      Straw const& straw = tracker.getStraw(hsp.strawId());
+      // create primary digis from this clust sequence
+      XTalk self(hsp.strawId()); // this object represents the straws coupling to itself, ie 100%
+      createDigis(strawphys,strawele,tracker,straw,hsp,self,randgauss,digis,digiadcs,mcdigis);
+      // if we're applying x-talk, look for nearby coupled straws
+      if(_addXtalk) {
+	// only apply if the charge is above a threshold
+	double totalCharge = 0;
+	for(auto ih=hsp.clustSequence(StrawEnd::cal).clustList().begin();ih!= hsp.clustSequence(StrawEnd::cal).clustList().end();++ih){
+	  totalCharge += ih->charge();
+	}
+	if( totalCharge > _ctMinCharge){
+	  vector<XTalk> xtalk;
+	  findCrossTalkStraws(straw,xtalk);
+	  for(auto ixtalk=xtalk.begin();ixtalk!=xtalk.end();++ixtalk){
+	    createDigis(strawphys,strawele,tracker,straw,hsp,*ixtalk,randgauss,digis,digiadcs,mcdigis);
+	  }
+	}
+      }
+    }
+
     void StrawDigisFromStrawGasSteps::createDigis(
 	StrawPhysics const& strawphys,
 	StrawElectronics const& strawele,
@@ -520,17 +583,18 @@ namespace mu2e {
         Straw const& straw,
 	StrawClusterSequencePair const& hsp,
 	XTalk const& xtalk,
+	CLHEP::RandGaussQ& randgauss,
 	StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
         StrawDigiMCCollection* mcdigis) {
       // instantiate waveforms for both ends of this straw
-      SWFP waveforms  ={ StrawWaveform(straw,hsp.clustSequence(StrawEnd::cal),xtalk),
-	StrawWaveform(straw,hsp.clustSequence(StrawEnd::hv),xtalk) };
+      SWFP waveforms  ={ StrawWaveform(strawele,straw,hsp.clustSequence(StrawEnd::cal),xtalk),
+	StrawWaveform(strawele,straw,hsp.clustSequence(StrawEnd::hv),xtalk) };
       // find the threshold crossing points for these waveforms
       WFXPList xings;
       // find the threshold crossings
-      findThresholdCrossings(strawele,waveforms,xings);
+      findThresholdCrossings(strawele,waveforms,randgauss,xings);
       // convert the crossing points into digis, and add them to the event data
-      fillDigis(strawphys,strawele,tracker,xings,waveforms,xtalk._dest,digis,digiadcs,mcdigis);
+      fillDigis(strawphys,strawele,tracker,xings,waveforms,xtalk._dest,randgauss,digis,digiadcs,mcdigis);
     }
 
     void StrawDigisFromStrawGasSteps::fillClusterMap(StrawPhysics const& strawphys,
@@ -603,8 +667,8 @@ namespace mu2e {
 	    double gtime = ctime + wireq._time + weq._time;
 	    // create the clust
 	    StrawCluster clust(StrawCluster::primary,sid,end,(float)gtime,weq._charge,weq._wdist,wireq._pos,(float)wireq._time,(float)weq._time,sgsptr,(float)ctime);
-	    // add the clusts to the appropriate sequence.
-	    shsp.clustSequence(end).insert(clust);
+	    // add the clusts to the appropriate sequence.  They are time-ordered once all the steps are added
+	    shsp.clustSequence(end).append(clust);
 	    // if required, add a 'ghost' copy of this clust
             if (_onSpill)
   	      addGhosts(strawele,clust,shsp.clustSequence(end));
@@ -722,19 +786,19 @@ namespace mu2e {
       // at this point cluster times are relative to marker and wrapped at 1695 (if onspill)
       // wrap from beginning of microbunch to times > 1695 to digitize ADCs for hits near end of event window
       if(clust.time() < _mbbuffer)
-	shs.insert(StrawCluster(clust,_mbtime));
+	shs.append(StrawCluster(clust,_mbtime));
       // wrap from end of microbunch to negative time to digitize ADCs for hits at tdc time=0
-      if(clust.time() > _mbtime - _mbbuffer) shs.insert(StrawCluster(clust,-_mbtime));
+      if(clust.time() > _mbtime - _mbbuffer) shs.append(StrawCluster(clust,-_mbtime));
     }
 
-    void StrawDigisFromStrawGasSteps::findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, WFXPList& xings){
+    void StrawDigisFromStrawGasSteps::findThresholdCrossings(StrawElectronics const& strawele, SWFP const& swfp, CLHEP::RandGaussQ& randgauss, WFXPList& xings){
       //randomize the threshold to account for electronics noise; this includes parts that are coherent
       // for both ends (coming from the straw itself)
       // Keep track of crossings on each end to keep them in sequence
-      double strawnoise = _randgauss.fire(0,strawele.strawNoise());
+      double strawnoise = randgauss.fire(0,strawele.strawNoise());
       // add specifics for each end
-      double thresh[2] = {_randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(0))+strawnoise,strawele.analogNoise(StrawElectronics::thresh)),
-	_randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(1))+strawnoise,strawele.analogNoise(StrawElectronics::thresh))};
+      double thresh[2] = {randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(0))+strawnoise,strawele.analogNoise(StrawElectronics::thresh)),
+	randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(1))+strawnoise,strawele.analogNoise(StrawElectronics::thresh))};
       // Initialize search when the electronics becomes enabled:
       double tstart =strawele.digitizationStartFromMarker() - _flashbuffer; 
       // for reading all hits, make sure we start looking for clusters at the minimum possible cluster time
@@ -757,14 +821,14 @@ namespace mu2e {
 	  if(std::min(wfx[0]._time,wfx[1]._time) > 0.0 )xings.push_back(wfx);
 	  // search for next crossing:
 	  // update threshold for straw noise
-	  strawnoise = _randgauss.fire(0,strawele.strawNoise());
+	  strawnoise = randgauss.fire(0,strawele.strawNoise());
 	  for(unsigned iend=0;iend<2;++iend){
 	    // insure a minimum time buffer between crossings
 	    wfx[iend]._time += strawele.deadTimeAnalog();
 	    // skip to the next clust
 	    ++(wfx[iend]._iclust);
 	    // update threshold for incoherent noise
-	    thresh[iend] = _randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(iend)),strawele.analogNoise(StrawElectronics::thresh));
+	    thresh[iend] = randgauss.fire(strawele.threshold(swfp[0].straw().id(),static_cast<StrawEnd::End>(iend)),strawele.analogNoise(StrawElectronics::thresh));
 	    // find next crossing
 	    crosses[iend] = swfp[iend].crossesThreshold(strawele,thresh[iend],wfx[iend]);
 	  }
@@ -783,6 +847,7 @@ namespace mu2e {
 	Tracker const& tracker,
 	WFXPList const& xings, SWFP const& wf,
 	StrawId sid,
+	CLHEP::RandGaussQ& randgauss,
 	StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs,
         StrawDigiMCCollection* mcdigis ) {
 	//
@@ -792,7 +857,7 @@ namespace mu2e {
       for(auto xpair : xings) {
 	// create a digi from this pair.  This also performs a finial test
 	// on whether the pair should make a digi
-	if(createDigi(strawele,xpair,wf,sid,digis,digiadcs,digitization_ready_time)){
+	if(createDigi(strawele,xpair,wf,sid,randgauss,digis,digiadcs,digitization_ready_time)){
 	  // fill associated MC truth matching. Only count the same step once
 	  StrawDigiMC::SGSPA sgspa;
 	  StrawDigiMC::PA cpos;
@@ -827,7 +892,7 @@ namespace mu2e {
     }
 
     bool StrawDigisFromStrawGasSteps::createDigi(StrawElectronics const& strawele, WFXP const& xpair, SWFP const& waveform,
-	StrawId sid, StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time){
+	StrawId sid, CLHEP::RandGaussQ& randgauss, StrawDigiCollection* digis, StrawDigiADCWaveformCollection* digiadcs, double &digitization_ready_time){
       // initialize the float variables that we later digitize
       TDCTimes xtimes = {0.0,0.0};
       TrkTypes::TOTValues tot;
@@ -844,10 +909,10 @@ namespace mu2e {
 	WFX const& wfx = xpair[iend];
 	// record the crossing time for this end, including clock jitter  These already include noise effects
 	// add noise for TDC on each side
-	double tdc_jitter = _randgauss.fire(0.0,strawele.TDCResolution());
+	double tdc_jitter = randgauss.fire(0.0,strawele.TDCResolution());
 	xtimes[iend] = wfx._time+dt+tdc_jitter;
 	// randomize threshold using the incoherent noise
-	double threshold = _randgauss.fire(wfx._vcross,strawele.analogNoise(StrawElectronics::thresh));
+	double threshold = randgauss.fire(wfx._vcross,strawele.analogNoise(StrawElectronics::thresh));
 	// find TOT
 	tot[iend] = waveform[iend].digitizeTOT(strawele,threshold,wfx._time + dt);
 	// sample ADC
@@ -862,7 +927,7 @@ namespace mu2e {
       // add ends and add noise
       ADCVoltages wfsum; wfsum.reserve(adctimes.size());
       for(unsigned isamp=0;isamp<adctimes.size();++isamp){
-	wfsum.push_back(wf[0][isamp]+wf[1][isamp]+_randgauss.fire(0.0,strawele.analogNoise(StrawElectronics::adc)));
+	wfsum.push_back(wf[0][isamp]+wf[1][isamp]+randgauss.fire(0.0,strawele.analogNoise(StrawElectronics::adc)));
       }
       // digitize, and make final test.  This call includes the clock error WRT the proton pulse
       TrkTypes::TDCValues tdcs;
@@ -1076,7 +1141,7 @@ namespace mu2e {
 	// step to the 1st cluster past the blanking time to avoid double-counting
 	StrawClusterList const& clist = wfs[iend].clusts().clustList();
 	auto icl = clist.begin();
-	while(icl->time() < strawele.digitizationStartFromMarker())
+	while(icl != clist.end() && icl->time() < strawele.digitizationStartFromMarker())
 	  icl++;
 	if(icl != clist.end() && nhist < _maxhist && xings.size() >= _minnxinghist &&
 	    ( ((!_xtalkhist) && wfs[iend].xtalk().self()) || (_xtalkhist && !wfs[iend].xtalk().self()) ) ) {
@@ -13,22 +13,27 @@ using namespace std;
 namespace mu2e {
   using namespace TrkTypes;
   namespace TrackerMC {
-    StrawWaveform::StrawWaveform(Straw const& straw, StrawClusterSequence const& hseq, XTalk const& xtalk) :
-      _cseq(hseq), _xtalk(xtalk), _straw(straw)
-    {}
+    StrawWaveform::StrawWaveform(StrawElectronics const& strawele, Straw const& straw, StrawClusterSequence const& hseq, XTalk const& xtalk) :
+      _cseq(hseq), _cbegin(hseq.clustList().begin()), _cend(hseq.clustList().end()), _xtalk(xtalk), _straw(straw)
+    {
+      // the distance and reflection parts of the response are computed once per clust, not once per sample
+      _cresp.reserve(_cend-_cbegin);
+      for(auto iclust = _cbegin; iclust != _cend; ++iclust)
+	_cresp.push_back(strawele.clusterResponse(_straw,iclust->charge(),iclust->wireDistance()));
+    }
 
     StrawWaveform::StrawWaveform(StrawWaveform const& other) : _cseq(other._cseq),
-    _xtalk(other._xtalk), _straw(other._straw)
+    _cbegin(other._cbegin), _cend(other._cend), _cresp(other._cresp), _xtalk(other._xtalk), _straw(other._straw)
     {}
 
     bool StrawWaveform::crossesThreshold(StrawElectronics const& strawele,double threshold,WFX& wfx) const {
       bool retval(false);
       // make sure we start past the input time
-      while(wfx._iclust != _cseq.clustList().end() && wfx._iclust->time()-strawele.clusterLookbackTime()< wfx._time ){
+      while(wfx._iclust != _cend && wfx._iclust->time()-strawele.clusterLookbackTime()< wfx._time ){
 	++(wfx._iclust);
       }
       // loop till we're at the end or we go over threshold
-      if(wfx._iclust != _cseq.clustList().end()){
+      if(wfx._iclust != _cend){
 	// sample initial voltage for this clust
 	wfx._vstart = sampleWaveform(strawele,StrawElectronics::thresh,wfx._iclust->time()-strawele.clusterLookbackTime());
 	// if we start above threhold, scan forward till we're below
@@ -37,13 +42,13 @@ namespace mu2e {
 	// scan ahead quickly from there to where there's enough integral charge to possibly cross threshold.
 	if(roughCrossing(strawele,threshold,wfx)) {
 	  // start the fine scan from this clust.
-	  while(wfx._iclust != _cseq.clustList().end() ){
+	  while(wfx._iclust != _cend ){
 	    // First, get the starting voltage
 	    wfx._vstart = sampleWaveform(strawele,StrawElectronics::thresh,wfx._iclust->time()-strawele.clusterLookbackTime());
 	    //// check if this clust could cross threshold
 	    //if(wfx._vstart + maxLinearResponse(wfx._iclust) > threshold){
 	      // check the actual response
-	      double maxtime = wfx._iclust->time()+strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
+	      double maxtime = wfx._iclust->time()+strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,clustResponse(wfx._iclust));
 	      double maxresp = sampleWaveform(strawele,StrawElectronics::thresh,maxtime);
 	      if(maxresp > threshold){
 		// interpolate to find the precise crossing
@@ -62,14 +67,14 @@ namespace mu2e {
     }
 
     void StrawWaveform::returnCrossing(StrawElectronics const& strawele, double threshold, WFX& wfx) const {
-      while(wfx._iclust != _cseq.clustList().end() && wfx._vstart > threshold) {
+      while(wfx._iclust != _cend && wfx._vstart > threshold) {
 	// move forward in time at least as twice the time to the maxium for this clust
-	double time = wfx._iclust->time()+strawele.clusterLookbackTime() + 2*strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
-	while(wfx._iclust != _cseq.clustList().end() &&
+	double time = wfx._iclust->time()+strawele.clusterLookbackTime() + 2*strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,clustResponse(wfx._iclust));
+	while(wfx._iclust != _cend &&
 	    wfx._iclust->time()-strawele.clusterLookbackTime() < time){
 	  ++(wfx._iclust);
 	}
-	if(wfx._iclust != _cseq.clustList().end()){
+	if(wfx._iclust != _cend){
 	  wfx._vstart = sampleWaveform(strawele,StrawElectronics::thresh,wfx._iclust->time()-strawele.clusterLookbackTime());
 	  wfx._time =wfx._iclust->time()-strawele.clusterLookbackTime();
 	}
@@ -80,22 +85,22 @@ namespace mu2e {
       // add voltage till we go over threshold by simple linear sum.  That's a minimum requirement
       // for actually crossing threshold
       double resp = wfx._vstart;
-      while(wfx._iclust != _cseq.clustList().end()){
+      while(wfx._iclust != _cend){
 	resp += maxLinearResponse(strawele,wfx._iclust);
 	if(resp > threshold)break;
 	++(wfx._iclust);
       }
       // update time
-      if(wfx._iclust != _cseq.clustList().end() )
+      if(wfx._iclust != _cend )
 	wfx._time = wfx._iclust->time()-strawele.clusterLookbackTime();
 
-      return wfx._iclust != _cseq.clustList().end() && resp > threshold;
+      return wfx._iclust != _cend && resp > threshold;
     }
 
     bool StrawWaveform::fineCrossing(StrawElectronics const& strawele, double threshold,double maxresp, WFX& wfx) const {
       static double timestep(0.020); // interpolation minimum to use linear threshold crossing calculation
       double pretime = wfx._iclust->time()-strawele.clusterLookbackTime();
-      double posttime = pretime + strawele.clusterLookbackTime() + strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,wfx._iclust->wireDistance());
+      double posttime = pretime + strawele.clusterLookbackTime() + strawele.maxResponseTime(_straw.id(),StrawElectronics::thresh,clustResponse(wfx._iclust));
       double presample = wfx._vstart;
       double postsample = maxresp;
       static const unsigned maxstep(10); // 10 steps max
@@ -126,12 +131,12 @@ namespace mu2e {
       // record the threshold
       wfx._vcross = threshold;
       // update the referenced clust: this can be different than the one we started with!
-      while(wfx._iclust != _cseq.clustList().end() &&
+      while(wfx._iclust != _cend &&
 	  wfx._iclust->time()-strawele.clusterLookbackTime() < wfx._time){
 	++(wfx._iclust);
       }
       // back off one
-      if(wfx._iclust != _cseq.clustList().begin())--(wfx._iclust);
+      if(wfx._iclust != _cbegin)--(wfx._iclust);
 
       // apply dispersion effects.  This changes the slope of the voltage response FIXME!!!
 
@@ -141,21 +146,23 @@ namespace mu2e {
 
     double StrawWaveform::maxLinearResponse(StrawElectronics const& strawele,StrawClusterList::const_iterator const& iclust) const {
       // ignore saturation effects
-      double linresp = strawele.maxLinearResponse(_straw.id(),StrawElectronics::thresh,iclust->wireDistance(),iclust->charge());
+      double linresp = strawele.maxLinearResponse(_straw.id(),StrawElectronics::thresh,clustResponse(iclust));
       linresp *= (_xtalk._preamp + _xtalk._postamp);
       return linresp;
     }
 
     double StrawWaveform::sampleWaveform(StrawElectronics const& strawele,StrawElectronics::Path ipath,double time) const {
       // loop over all clusts and add their response at this time
-      StrawClusterList const& hlist = _cseq.clustList();
       double linresp(0.0);
-      auto iclust = hlist.begin();
-      while(iclust != hlist.end() && iclust->time()-strawele.clusterLookbackTime() < time){
+      StrawId sid = _straw.id();
+      auto iclust = _cbegin;
+      auto icresp = _cresp.begin();
+      while(iclust != _cend && iclust->time()-strawele.clusterLookbackTime() < time){
 	// compute the linear straw electronics response to this charge.  This is pre-saturation
-	linresp += strawele.linearResponse(_straw,ipath,time-iclust->time(),iclust->charge(),iclust->wireDistance());
+	linresp += strawele.sampleResponse(sid,ipath,*icresp,time-iclust->time());
 	// move to next clust
 	++iclust;
+	++icresp;
       }
       double totresp = linresp * _xtalk._postamp;
       if(_xtalk._preamp>0.0)
@@ -173,21 +180,26 @@ namespace mu2e {
         }
         return;
       }
+      StrawId sid = _straw.id();
+      double lookback = strawele.clusterLookbackTime();
 
       // check if going to be saturated
       double max_possible_voltage = 0;
-      for (auto iclust = _cseq.clustList().begin();iclust != _cseq.clustList().end();++iclust){
+      for (auto iclust = _cbegin;iclust != _cend;++iclust){
         max_possible_voltage += maxLinearResponse(strawele,iclust);
       }
+      // the waveform is accumulated one clust at a time over all the sample times that clust reaches.
+      // Each sample still sums the clusts in time order, so the result is the same as sampling
+      // each time separately
       if (max_possible_voltage > strawele.saturationVoltage()){
         // create waveform of threshold circuit output
         // step along waveform and apply saturation
         // for each time, get contribution from each step in waveform using impulse response
 
         // skip to the first cluster that matters for the first adc time
-        auto iclust = _cseq.clustList().begin();
-        while (iclust != _cseq.clustList().end()){
-          double time = iclust->time()-strawele.clusterLookbackTime();
+        auto iclust = _cbegin;
+        while (iclust != _cend){
+          double time = iclust->time()-lookback;
           if (time + strawele.truncationTime(StrawElectronics::thresh) > times[0])
             break;
           else
@@ -198,29 +210,48 @@ namespace mu2e {
         for (size_t j=0;j<times.size();j++){
           volts.push_back(0);
         }
+        // no cluster left to sample: the clusts are contiguous, don't read past the end
+        if (iclust == _cend) return;
 
-        int num_steps = (int)ceil((times[times.size()-1]-iclust->time()-strawele.clusterLookbackTime())/strawele.saturationTimeStep());
-
+        int num_steps = (int)ceil((times[times.size()-1]-iclust->time()-lookback)/strawele.saturationTimeStep());
+        if (num_steps <= 0) return;
+        std::vector<double> steptimes(num_steps), response(num_steps,0.0);
+        for (int i=0;i<num_steps;i++){
+          steptimes[i] = iclust->time()-lookback + i*strawele.saturationTimeStep();
+        }
+        // sum up the preamp response at each step
+        int istart = 0;
+        for (auto jclust = iclust; jclust != _cend; ++jclust){
+          double ctime = jclust->time();
+          while (istart < num_steps && !(ctime-lookback < steptimes[istart])) ++istart;
+          if (istart == num_steps) break;
+          strawele.addResponse(sid,StrawElectronics::thresh,clustResponse(jclust),ctime,
+              steptimes.data()+istart,num_steps-istart,response.data()+istart,true);
+        }
         for (int i=0;i<num_steps;i++){
-          double time = iclust->time()-strawele.clusterLookbackTime() + i*strawele.saturationTimeStep();
-          // sum up the preamp response at this step
-          double response = 0;
-          auto jclust = iclust;
-          while(jclust != _cseq.clustList().end() && jclust->time()-strawele.clusterLookbackTime() < time){
-            response += strawele.linearResponse(_straw,StrawElectronics::thresh,time-jclust->time(),jclust->charge(),jclust->wireDistance(),true);
-            ++jclust;
-          }
           // now saturate it
-          double sat_response = strawele.saturatedResponse(response);
+          double sat_response = strawele.saturatedResponse(response[i]);
           // then calculate the impulse response at each of the adctimes and add it to that
           for (size_t j=0;j<times.size();j++){
             // this function includes multiplication by number of steps in saturationTimeStep
-            volts[j] += strawele.adcImpulseResponse(_straw.id(),times[j]-time,sat_response);
+            volts[j] += strawele.adcImpulseResponse(sid,times[j]-steptimes[i],sat_response);
           }
         }
       }else{
-        for(auto itime=times.begin();itime!=times.end();++itime){
-          volts.push_back(sampleWaveform(strawele,StrawElectronics::adc,*itime));
+        std::vector<double> dtimes(times.begin(),times.end()), linresp(times.size(),0.0);
+        size_t jstart = 0;
+        for (auto iclust = _cbegin; iclust != _cend; ++iclust){
+          double ctime = iclust->time();
+          while (jstart < times.size() && !(ctime-lookback < times[jstart])) ++jstart;
+          if (jstart == times.size()) break;
+          strawele.addResponse(sid,StrawElectronics::adc,clustResponse(iclust),ctime,
+              dtimes.data()+jstart,times.size()-jstart,linresp.data()+jstart);
+        }
+        for (size_t j=0;j<times.size();j++){
+          double totresp = linresp[j] * _xtalk._postamp;
+          if(_xtalk._preamp>0.0)
+            totresp += _xtalk._preamp*linresp[j];
+          volts.push_back(totresp);
         }
       }
     }
@@ -28,6 +28,7 @@
 #include "Offline/MCDataProducts/inc/MCRelationship.hh"
 // data
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitLeafIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
 #include "Offline/MCDataProducts/inc/StrawDigiMC.hh"
@@ -218,6 +219,7 @@ namespace mu2e {
     _iev=evt.id().event();
 // find the data
     if(findData(evt)) {
+      ComboHitLeafIndex leafIndex(evt);
      // loop over helices
       unsigned ihel(0);
       for(auto const& hseed : *_hscol) {
@@ -248,7 +250,7 @@ namespace mu2e {
 	std::vector<StrawDigiIndex> sdis;
 	for(size_t ihh = 0;ihh < hhits.size(); ++ihh) {
 	  ComboHit const& hhit = hhits[ihh];
-	  hhits.fillStrawDigiIndices(evt,ihh,sdis);
+	  leafIndex.fillStrawDigiIndices(hhits,ihh,sdis);
 	  if(!hhit.flag().hasAnyProperty(StrawHitFlag::outlier))_nused += hhit.nStrawHits();
 	}
 	art::Ptr<SimParticle> pspp;
@@ -272,7 +274,7 @@ namespace mu2e {
 	    for(size_t ihh = 0;ihh < hhits.size(); ++ihh) {
 	      ComboHit const& hhit = hhits[ihh];
 	      vector<StrawDigiIndex> sdis;
-	      hhits.fillStrawDigiIndices(evt,ihh,sdis);
+	      leafIndex.fillStrawDigiIndices(hhits,ihh,sdis);
 	      for(auto idigi : sdis) {
 		StrawDigiMC const& mcdigi = _mcdigis->at(idigi);
 		if ( mcdigi.earlyStrawGasStep()->simParticle() == pspp ){
@@ -146,6 +146,7 @@ namespace mu2e {
     Hep3Vector _mu2eOriginInWorld;
 
     BFieldManager const * _bfMgr;
+    BFieldQueryContext _bfContext;
     TrkExtDetectors _mydet;
     TrkExtInstanceName _trkPatRecInstanceName;
 
@@ -363,6 +364,7 @@ namespace mu2e {
   void TrkExt::beginSubRun(art::SubRun & lblock ) {
     if (_verbosity>=2) cout << "TrkExt: From beginSubRun. " << endl;
     _bfMgr = GeomHandle<BFieldManager>().get();
+    _bfContext.reset();
     _mydet.initialize();
   }
 
@@ -485,7 +487,7 @@ namespace mu2e {
   Hep3Vector TrkExt::getBField (Hep3Vector& x) {
     // x in Detector coordinate
     //mu2e::GeomHandle<BFieldManager> bfMgr;
-    Hep3Vector b = _bfMgr->getBField(x + _origin);
+    Hep3Vector b = _bfMgr->getBField(x + _origin, _bfContext);
     if (b.mag() >10) {
       Hep3Vector xx = x+_origin;
       if (_verbosity>=0) cout << "TrkExt: Crazy bfield : (" << b.x() << ", " << b.y() << ", " << b.z() << ") at (" << xx.x() << ", " << xx.y() << ", " << xx.z() << ")" << endl;
@@ -495,7 +497,7 @@ namespace mu2e {
   
   Hep3Vector TrkExt::getBField (const Hep3Vector& x) { 
     Hep3Vector xx = x + _origin;
-    Hep3Vector b = _bfMgr->getBField(xx);
+    Hep3Vector b = _bfMgr->getBField(xx, _bfContext);
     if (b.mag() >10) {
       if (_verbosity>=0) cout << "TrkExt: Crazy bfield : (" << b.x() << ", " << b.y() << ", " << b.z() << ") at (" << xx.x() << ", " << xx.y() << ", " << xx.z() << ")" << endl;
     }
@@ -104,6 +104,8 @@ namespace mu2e {
       chcolNew->setParent(chH);
 
       combine(chcolOrig, *chcolNew);
+      // the input is ordered by panel, so the output is too: record the panel offsets for downstream modules
+      chcolNew->setPanelOffsets();
       event.put(std::move(chcolNew));
   }
 
@@ -82,7 +82,7 @@ namespace mu2e
          void classifyCluster(BkgClusterCollection& bkgccolFast, BkgClusterCollection& bkgccol, BkgQualCollection& bkgqcol, 
                               StrawHitFlagCollection& chfcol, const ComboHitCollection& chcol) const;
          void fillBkgQual(    const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const;
-         void fillMVA(        BkgQual& cqual) const;
+         void fillMVAVars(    const BkgQual& cqual, std::vector<float>& mvavars) const;
          void countHits(      const BkgCluster& cluster, unsigned& nactive, unsigned& nstereo, const ComboHitCollection& chcol) const;
          void countPlanes(    const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const;
          int  findClusterIdx( BkgClusterCollection& bkgccol, unsigned ich) const;
@@ -263,11 +263,30 @@ namespace mu2e
          for (const auto& chit : cluster.hits()) chfcol[chit] = flag;
       }      
       
-      for (auto& cluster : bkgccol)
-      {                
-           BkgQual cqual;
-           fillBkgQual(cluster, cqual, chcol);
-           fillMVA(cqual);
+      // fill the cluster qualities first, then evaluate the MVA of all filled clusters in one batch
+      std::vector<BkgQual> cquals(bkgccol.size());
+      std::vector<float>   mvavars;
+      std::vector<size_t>  imva;
+      for (size_t ic=0;ic<bkgccol.size();++ic)
+      {
+           fillBkgQual(bkgccol[ic], cquals[ic], chcol);
+           if (cquals[ic].status() == MVAStatus::unset) continue;
+           fillMVAVars(cquals[ic], mvavars);
+           imva.push_back(ic);
+      }
+
+      std::vector<float> mvaout(imva.size());
+      if (!imva.empty()) bkgMVA_.evalMVA(mvavars.data(), imva.size(), mvavars.size()/imva.size(), mvaout.data());
+      for (size_t i=0;i<imva.size();++i)
+      {
+           cquals[imva[i]].setMVAValue(mvaout[i]);
+           cquals[imva[i]].setMVAStatus(MVAStatus::calculated);
+      }
+
+      for (size_t ic=0;ic<bkgccol.size();++ic)
+      {
+           auto& cluster = bkgccol[ic];
+           auto& cqual   = cquals[ic];
 
            StrawHitFlag flag(StrawHitFlag::bkgclust);
            if (cqual.MVAOutput() > bkgMVAcut_)
@@ -323,22 +342,16 @@ namespace mu2e
   
   
   //----------------------------------------------
-  void FlagBkgHits::fillMVA(BkgQual& cqual) const
+  // append the MVA variables of a cluster to mvavars, one row of the batch MVA evaluation
+  void FlagBkgHits::fillMVAVars(const BkgQual& cqual, std::vector<float>& mvavars) const
   {
-       if (cqual.status() == MVAStatus::unset) return;
-
-       std::vector<float> mvavars(7,0.0);
-       mvavars[0] = cqual.varValue(BkgQual::crho);
-       mvavars[1] = cqual.varValue(BkgQual::zmin);
-       mvavars[2] = cqual.varValue(BkgQual::zmax);
-       mvavars[3] = cqual.varValue(BkgQual::zgap);
-       mvavars[4] = cqual.varValue(BkgQual::np);
-       mvavars[5] = cqual.varValue(BkgQual::npfrac);
-       mvavars[6] = cqual.varValue(BkgQual::nhits);
-       float mvaout = bkgMVA_.evalMVA(mvavars);
-
-       cqual.setMVAValue(mvaout);
-       cqual.setMVAStatus(MVAStatus::calculated);
+       mvavars.push_back(cqual.varValue(BkgQual::crho));
+       mvavars.push_back(cqual.varValue(BkgQual::zmin));
+       mvavars.push_back(cqual.varValue(BkgQual::zmax));
+       mvavars.push_back(cqual.varValue(BkgQual::zgap));
+       mvavars.push_back(cqual.varValue(BkgQual::np));
+       mvavars.push_back(cqual.varValue(BkgQual::npfrac));
+       mvavars.push_back(cqual.varValue(BkgQual::nhits));
    }
 
 
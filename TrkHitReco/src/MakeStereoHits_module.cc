@@ -31,6 +31,8 @@
 #include <boost/accumulators/statistics/min.hpp>
 using namespace boost::accumulators;
 
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <float.h>
 using namespace std;
@@ -142,25 +144,56 @@ namespace mu2e {
     chcol->reserve(_chcol->size());
     // reference the parent in the new collection
     chcol->setParent(chH);
-    // sort hits by unique panel.  This should be built in by construction upstream FIXME!!
-    std::array<std::vector<uint16_t>,StrawId::_nupanels> phits;
+    // bucket the selected hits by unique panel, and order each panel's hits in time, so the hits
+    // of an overlapping panel that can match a hit are found by binary search on time.
+    // The input is already bucketed if its producer recorded the panel offsets
     size_t nch = _chcol->size();
     if(_debug > 1)cout << "MakeStereoHits found " << nch << " Input hits" << endl;
-    std::vector<bool> used(nch,false);
-    for(uint16_t ihit=0;ihit<nch;++ihit){
-      ComboHit const& ch = (*_chcol)[ihit];
-      // select hits based on flag
-      if( (!_testflag) ||( ch.flag().hasAllProperties(_shsel) && (!ch.flag().hasAnyProperty(_shmask))) ){
-	phits[ch.strawId().uniquePanel()].push_back(ihit);
+    auto selected = [this](ComboHit const& ch) {
+      return (!_testflag) ||( ch.flag().hasAllProperties(_shsel) && (!ch.flag().hasAnyProperty(_shmask)));
+    };
+    auto hitTime = [this](ComboHit const& ch) { return _useTOT ? ch.correctedTime() : ch.time(); };
+    std::array<uint32_t,StrawId::_nupanels+1> poff;
+    std::vector<uint16_t> phits; // selected hits, by panel then time
+    phits.reserve(nch);
+    if(_chcol->panelSorted()){
+      for (uint16_t ipan=0; ipan < StrawId::_nupanels; ++ipan) {
+	poff[ipan] = phits.size();
+	for(uint32_t ihit=_chcol->panelBegin(ipan);ihit<_chcol->panelEnd(ipan);++ihit)
+	  if(selected((*_chcol)[ihit]))phits.push_back(ihit);
+      }
+      poff[StrawId::_nupanels] = phits.size();
+    } else {
+      // counting sort
+      poff.fill(0);
+      for(uint16_t ihit=0;ihit<nch;++ihit){
+	ComboHit const& ch = (*_chcol)[ihit];
+	if(selected(ch))++poff[ch.strawId().uniquePanel()+1];
+      }
+      for (unsigned ipan=0; ipan < StrawId::_nupanels; ++ipan) poff[ipan+1] += poff[ipan];
+      phits.resize(poff[StrawId::_nupanels]);
+      std::array<uint32_t,StrawId::_nupanels> pfill;
+      std::copy(poff.begin(),poff.end()-1,pfill.begin());
+      for(uint16_t ihit=0;ihit<nch;++ihit){
+	ComboHit const& ch = (*_chcol)[ihit];
+	if(selected(ch))phits[pfill[ch.strawId().uniquePanel()]++] = ihit;
       }
     }
+    std::vector<float> ptimes(phits.size());
+    for (unsigned ipan=0; ipan < StrawId::_nupanels; ++ipan) {
+      std::sort(phits.begin()+poff[ipan],phits.begin()+poff[ipan+1],[this,&hitTime](uint16_t i1, uint16_t i2){
+	  return hitTime((*_chcol)[i1]) < hitTime((*_chcol)[i2]); });
+      for(uint32_t ip=poff[ipan];ip<poff[ipan+1];++ip) ptimes[ip] = hitTime((*_chcol)[phits[ip]]);
+    }
     if(_debug > 2){
       for (unsigned ipan=0; ipan < StrawId::_nupanels; ++ipan) {
-	if(phits[ipan].size() > 0 ){
-	  cout << "Panel " << ipan << " has " << phits[ipan].size() << " hits "<< endl;
+	if(poff[ipan+1] > poff[ipan]){
+	  cout << "Panel " << ipan << " has " << poff[ipan+1]-poff[ipan] << " hits "<< endl;
 	}
       }
     }
+    std::vector<bool> used(nch,false);
+    std::vector<uint16_t> jhits;
     //  Loop over all hits.  Every one must appear somewhere in the output 
     for (size_t ihit=0;ihit<nch;++ihit) {
       if(used[ihit])continue;
@@ -172,10 +205,21 @@ namespace mu2e {
       // zero values that accumulate in pairs
       combohit._qual = 0.0;
       combohit._pos = XYZVec(0.0,0.0,0.0);
+      float t1 = hitTime(ch1);
       // loop over the panels which overlap this hit's panel
       for (auto sid : _panelOverlap[ch1.strawId().uniquePanel()]) {
-      // loop over hits in the overlapping panel
-	for (auto jhit : phits[sid.uniquePanel()]) {
+	// find the unused hits in the overlapping panel inside the time window.  The window includes
+	// every hit that passes the dt cut below; the hits are then taken in input order, as before
+	uint16_t upan = sid.uniquePanel();
+	auto tbegin = ptimes.begin()+poff[upan];
+	auto tend = ptimes.begin()+poff[upan+1];
+	jhits.clear();
+	for(auto it = std::lower_bound(tbegin,tend,t1-_maxDt); it != tend && *it <= t1+_maxDt; ++it){
+	  uint16_t jhit = phits[it-ptimes.begin()];
+	  if(!used[jhit])jhits.push_back(jhit);
+	}
+	std::sort(jhits.begin(),jhits.end());
+	for (auto jhit : jhits) {
 	  const ComboHit& ch2 = (*_chcol)[jhit];
 	  if(_debug > 3) cout << " comparing hits " << ch1.strawId().uniquePanel() << " and " << ch2.strawId().uniquePanel();
 	  if (!used[jhit] ){
@@ -231,6 +275,7 @@ namespace mu2e {
       finalize(combohit);
       chcol->push_back(std::move(combohit));
     }
+    chcol->setPanelOffsets();
     event.put(std::move(chcol));
   } 
 
@@ -233,6 +233,9 @@ namespace mu2e {
         shrUtils.flagCrossTalk(shCol, chCol);
       }
 
+      // record the panel offsets for downstream modules, if the digis came in panel order
+      chCol->setPanelOffsets();
+
       if(_writesh)event.put(std::move(shCol));
       event.put(std::move(chCol));
   }
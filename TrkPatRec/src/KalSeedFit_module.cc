@@ -36,6 +36,7 @@
 // data
 #include "Offline/DataProducts/inc/Helicity.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitLeafIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
 #include "Offline/RecoDataProducts/inc/KalSeed.hh"
@@ -162,8 +163,7 @@ namespace mu2e
     _result()
   {
     // This following consumesMany call is necessary because
-    // ComboHitCollection::fillStrawHitIndices calls getManyByType
-    // under the covers.
+    // ComboHitLeafIndex calls getMany under the covers.
     consumesMany<ComboHitCollection>();
     produces<KalSeedCollection>();
     produces<KalHelixAssns>();
@@ -243,6 +243,8 @@ namespace mu2e
     //    _result.tpart       = _tpart ;
     _result.fdir        = _fdir  ;
 
+    // map from ComboHits to StrawHits, filled once per ComboHit collection
+    ComboHitLeafIndex leafIndex(event);
     // loop over the Helices
     for (size_t iseed=0; iseed<_hscol->size(); ++iseed) {
       // convert the HelixSeed to a TrkDef
@@ -284,7 +286,7 @@ namespace mu2e
 	for(uint16_t ihit=0;ihit < hseed.hits().size(); ++ihit){
 	  ComboHit const& ch = hseed.hits()[ihit];
 	  if((!_fhoutliers) || (!ch.flag().hasAnyProperty(StrawHitFlag::outlier)))
-	    hseed.hits().fillStrawHitIndices(event,ihit,tclust._strawHitIdxs);
+	    leafIndex.fillStrawHitIndices(hseed.hits(),ihit,tclust._strawHitIdxs);
 	}
 	// create a TrkDef; it should be possible to build a fit from the helix seed directly FIXME!
 	//	TrkDef seeddef(tclust,hstraj,_tpart,_fdir);
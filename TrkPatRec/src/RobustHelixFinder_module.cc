@@ -32,6 +32,7 @@
 
 #include "BTrk/BaBar/BaBar.hh"
 #include "Offline/TrkReco/inc/RobustHelixFit.hh"
+#include "Offline/TrkReco/inc/ComboHitSoA.hh"
 
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
 #include "Offline/Mu2eUtilities/inc/ModuleHistToolBase.hh"
@@ -39,6 +40,9 @@
 #include "Offline/Mu2eUtilities/inc/HelixTool.hh"
 #include "art/Utilities/make_tool.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 #include "Offline/TrkPatRec/inc/RobustHelixFinder_types.hh"
 #include "Offline/TrkReco/inc/RobustHelixFinderData.hh"
 #include "Offline/TrkReco/inc/TrkFaceData.hh"
@@ -149,6 +153,7 @@ namespace mu2e {
       fhicl::Table<RobustHelixFinderTypes::Config>DiagPlugin{     Name("DiagPlugin"),           Comment("Diag plugin") };
       fhicl::Table<TrkTimeCalculator::Config>T0Calculator{        Name("T0Calculator"),         Comment("Track Time Calculator config") };
       fhicl::Atom<bool>                     UpdateStereo{         Name("UpdateStereo"),         Comment("Update Stereo") };
+      fhicl::Atom<bool>                     ParallelTimeClusters{ Name("ParallelTimeClusters"), Comment("Search the time clusters in parallel when there are no diagnostics"),true };
     };
 
     explicit RobustHelixFinder(const art::EDProducer::Table<Config>& config);
@@ -193,7 +198,6 @@ namespace mu2e {
     StrawHitFlag  _hsel, _hbkg;
 
     MVATools _stmva, _nsmva;
-    HelixHitMVA _vmva; // input variables to TMVA for filtering hits
 
     TH1F* _niter, *_niterxy, *_niterfz, *_nitermva;
 
@@ -203,6 +207,7 @@ namespace mu2e {
     TrkTimeCalculator _ttcalc;
     StrawHitFlag      _outlier;
     bool              _updateStereo;
+    bool              _parallelTimeClusters; // search the time clusters in TBB tasks
 
     std::unique_ptr<ModuleHistToolBase>   _hmanager;
     RobustHelixFinderTypes::Data_t        _data;
@@ -212,7 +217,14 @@ namespace mu2e {
     ProditionsHandle<Tracker> _alignedTracker_h;
     const Tracker* _tracker;
 
-    void     findHelices(ComboHitCollection& chcol, const TimeClusterCollection& tccol);
+    // helices found in one time cluster: the seeds and the index of the best one, as defined by pickBestHelix
+    struct TimeClusterResult_t {
+      std::vector<HelixSeed> seeds;
+      int                    indexBest = -1;
+    };
+
+    void     findHelices(size_t index, const art::ValidHandle<TimeClusterCollection>& tcH, const ComboHitCollection& chcol,
+			 RobustHelixFit& hfit, RobustHelixFinderData& helixData, TimeClusterResult_t& result);
     void     prefilterHits(RobustHelixFinderData& helixData, int& nFilteredStrawHits);
     unsigned filterCircleHits(RobustHelixFinderData& helixData);
     bool     filterHits(RobustHelixFinderData& helixData);
@@ -224,8 +236,8 @@ namespace mu2e {
     void     pickBestHelix      (std::vector<HelixSeed>& HelVec, int &Index_best);
     void     fillFaceOrderedHits(RobustHelixFinderData& helixData);
     void     fillGoodHits       (RobustHelixFinderData& helixData);
-    void     fitHelix           (RobustHelixFinderData& helixData);
-    void     refitHelix         (RobustHelixFinderData& helixData);
+    void     fitHelix           (RobustHelixFit& hfit, RobustHelixFinderData& helixData);
+    void     refitHelix         (RobustHelixFit& hfit, RobustHelixFinderData& helixData);
     void     fillPluginDiag     (RobustHelixFinderData& helixData, int helCounter);
     void     updateHelixXYInfo  (RobustHelixFinderData& helixData);
     void     updateHelixZPhiInfo(RobustHelixFinderData& helixData);
@@ -270,7 +282,8 @@ namespace mu2e {
     _hfit        (config().HelixFitter()),
     _ttcalc      (config().T0Calculator()),
     _outlier     (StrawHitFlag::outlier),
-    _updateStereo(config().UpdateStereo())
+    _updateStereo(config().UpdateStereo()),
+    _parallelTimeClusters(config().ParallelTimeClusters())
     { 
       std::vector<int> helvals = config().Helicities();
       for(auto hv : helvals) {
@@ -342,107 +355,137 @@ namespace mu2e {
 
     _hfResult._chcol  = &chcol;
 
-    // create initial helicies from time clusters: to begin, don't specificy helicity
-    for (size_t index=0;index< tccol.size();++index) {
-      const auto& tclust = tccol[index];
-      HelixSeed hseed;
-      hseed._status.merge(TrkFitFlag::TPRHelix);
-      //clear the variables in hfResult
-      _hfResult.clearTempVariables();
+    // create initial helicies from time clusters: to begin, don't specificy helicity.
+    // The time clusters are independent: in parallel, each task works on its own copies
+    // of the fitter and of the helix data. The diagnostics fill shared histograms, so they
+    // need the serial loop. The seeds are stored in the time cluster order either way
+    size_t                           nTimeClusters = tccol.size();
+    std::vector<TimeClusterResult_t> results(nTimeClusters);
+
+    if (!_parallelTimeClusters || _diag > 0 || _debug > 0) {
+      for (size_t index=0; index<nTimeClusters; ++index) {
+	findHelices(index, tcH, chcol, _hfit, _hfResult, results[index]);
+      }
+    }
+    else {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, nTimeClusters),
+			[&](const tbb::blocked_range<size_t>& range) {
+			  RobustHelixFit        hfit     (_hfit);
+			  RobustHelixFinderData helixData(_hfResult);
+			  for (size_t index=range.begin(); index!=range.end(); ++index) {
+			    findHelices(index, tcH, chcol, hfit, helixData, results[index]);
+			  }
+			});
+    }
 
-      //set variables used for searching the helix candidate
-      _hfResult._hseed              = hseed;
-      _hfResult._timeCluster        = &tclust;
-      _hfResult._hseed._hhits.setParent(chcol.parent());
-      _hfResult._hseed._t0          = tclust._t0;
-      _hfResult._hseed._timeCluster = art::Ptr<TimeCluster>(tcH,index);
-      // copy combo hits
-      fillFaceOrderedHits(_hfResult);
+    for (auto const& result : results) {
+      int index_best = result.indexBest;
+      if ( (index_best>=0) && (index_best < 2) ){
+	Helicity              hel_best = result.seeds[index_best]._helix._helicity;
+	HelixSeedCollection*  hcol     = helcols[hel_best].get();
+	hcol->push_back(result.seeds[index_best]);
+      } else if (index_best == 2){//both helices need to be saved
+
+	for (unsigned k=0; k<_hels.size(); ++k){
+	  Helicity              hel   = result.seeds[k]._helix._helicity;
+	  HelixSeedCollection*  hcol  = helcols[hel].get();
+	  hcol->push_back(result.seeds[k]);
+	}
+      }
+    }
 
-      //skip the reconstruction if there are few strawHits
-      if (_hfResult._nFiltStrawHits < _minnsh)                  continue;
+    // put final collections into event
+    if (_diag > 0) _hmanager->fillHistograms(&_data);
 
-      // filter hits and test
-      int nFilteredSh(0);
-      if (_prefilter) prefilterHits(_hfResult,nFilteredSh);
+    for(auto const& hel : _hels ) {
+      event.put(std::move(helcols[hel]),Helicity::name(hel));
+    }
+  }
 
-      if ((_hfResult._nFiltStrawHits - nFilteredSh) < _minnsh)  continue;
+//--------------------------------------------------------------------------------
+// search for the helices in the time cluster 'index'
+//--------------------------------------------------------------------------------
+  void RobustHelixFinder::findHelices(size_t index, const art::ValidHandle<TimeClusterCollection>& tcH, const ComboHitCollection& chcol,
+				      RobustHelixFit& hfit, RobustHelixFinderData& helixData, TimeClusterResult_t& result) {
+    const TimeCluster& tclust = (*tcH)[index];
+    HelixSeed hseed;
+    hseed._status.merge(TrkFitFlag::TPRHelix);
+    //clear the variables in hfResult
+    helixData.clearTempVariables();
 
-      _hfResult._hseed._status.merge(TrkFitFlag::hitsOK);
-      if (_diag) _hfResult._diag.circleFitCounter = 0;
+    //set variables used for searching the helix candidate
+    helixData._hseed              = hseed;
+    helixData._timeCluster        = &tclust;
+    helixData._hseed._hhits.setParent(chcol.parent());
+    helixData._hseed._t0          = tclust._t0;
+    helixData._hseed._timeCluster = art::Ptr<TimeCluster>(tcH,index);
+    // copy combo hits
+    fillFaceOrderedHits(helixData);
 
-      // initial circle fit
+    //skip the reconstruction if there are few strawHits
+    if (helixData._nFiltStrawHits < _minnsh)                  return;
 
-	_hfit.fitCircle(_hfResult, _targetconInit, _useTripletAreaWt);//require consistency for the trajectory of being produced in the Al stopping target
+    // filter hits and test
+    int nFilteredSh(0);
+    if (_prefilter) prefilterHits(helixData,nFilteredSh);
 
-      if (_diag) {
-	_hfResult._diag.nShFitCircle = _hfResult._nXYSh;
-	_hfResult._diag.nChFitCircle = _hfResult._sxy.qn()-1;//take into account one hit form the stopping target center
-      }
-      //check the number of points associated with the result of the circle fit
-      // if (_hfResult._nXYSh < _minnsh)                           continue;
+    if ((helixData._nFiltStrawHits - nFilteredSh) < _minnsh)  return;
 
-      if (_hfResult._hseed._status.hasAnyProperty(TrkFitFlag::circleOK)) {
-	// loop over helicities.
-	unsigned    helCounter(0);
-	HelixSeed   helixSeed_from_fitCircle = _hfResult._hseed;
+    helixData._hseed._status.merge(TrkFitFlag::hitsOK);
+    if (_diag) helixData._diag.circleFitCounter = 0;
 
-	std::vector<HelixSeed>          helix_seed_vec;
+    // initial circle fit
 
-	for(auto const& hel : _hels ) {
-	  // tentatively put a copy with the specified helicity in the appropriate output vector
-	  RobustHelixFinderData tmpResult(_hfResult);
-	  tmpResult._hseed._helix._helicity = hel;
+      hfit.fitCircle(helixData, _targetconInit, _useTripletAreaWt);//require consistency for the trajectory of being produced in the Al stopping target
 
-	  //fit the helix: refine the XY-circle fit + performs the ZPhi fit
-	  // it also performs a clean-up of the hits with large residuals
-	  fitHelix(tmpResult);
+    if (_diag) {
+      helixData._diag.nShFitCircle = helixData._nXYSh;
+      helixData._diag.nChFitCircle = helixData._sxy.qn()-1;//take into account one hit form the stopping target center
+    }
+    //check the number of points associated with the result of the circle fit
+    // if (helixData._nXYSh < _minnsh)                           return;
 
+    if (helixData._hseed._status.hasAnyProperty(TrkFitFlag::circleOK)) {
+      // loop over helicities.
+      unsigned    helCounter(0);
+      HelixSeed   helixSeed_from_fitCircle = helixData._hseed;
 
-	  if (tmpResult._hseed.status().hasAnyProperty(_saveflag)){
-	    //fill the hits in the HelixSeedCollection
-	    fillGoodHits(tmpResult);
+      std::vector<HelixSeed>          helix_seed_vec;
 
-	    helix_seed_vec.push_back(tmpResult._hseed);
+      for(auto const& hel : _hels ) {
+	// tentatively put a copy with the specified helicity in the appropriate output vector
+	RobustHelixFinderData tmpResult(helixData);
+	tmpResult._hseed._helix._helicity = hel;
 
-	    // HelixSeedCollection* hcol = helcols[hel].get();
-	    // hcol->push_back(tmpResult._hseed);
+	//fit the helix: refine the XY-circle fit + performs the ZPhi fit
+	// it also performs a clean-up of the hits with large residuals
+	fitHelix(hfit, tmpResult);
 
-	    if (_diag > 0) {
-	      fillPluginDiag(tmpResult, helCounter);
-	    }
-	  }
-	  ++helCounter;
-	}//end loop over the helicity
 
-	if (helix_seed_vec.size() == 0)                       continue;
+	if (tmpResult._hseed.status().hasAnyProperty(_saveflag)){
+	  //fill the hits in the HelixSeedCollection
+	  fillGoodHits(tmpResult);
 
-	int    index_best(-1);
-	pickBestHelix(helix_seed_vec, index_best);
+	  helix_seed_vec.push_back(tmpResult._hseed);
 
-	if ( (index_best>=0) && (index_best < 2) ){
-	  Helicity              hel_best = helix_seed_vec[index_best]._helix._helicity;
-	  HelixSeedCollection*  hcol     = helcols[hel_best].get();
-	  hcol->push_back(helix_seed_vec[index_best]);
-	} else if (index_best == 2){//both helices need to be saved
+	  // HelixSeedCollection* hcol = helcols[hel].get();
+	  // hcol->push_back(tmpResult._hseed);
 
-	  for (unsigned k=0; k<_hels.size(); ++k){
-	    Helicity              hel   = helix_seed_vec[k]._helix._helicity;
-	    HelixSeedCollection*  hcol  = helcols[hel].get();
-	    hcol->push_back(helix_seed_vec[k]);
+	  if (_diag > 0) {
+	    fillPluginDiag(tmpResult, helCounter);
 	  }
 	}
+	++helCounter;
+      }//end loop over the helicity
 
-      }
+      if (helix_seed_vec.size() == 0)                       return;
 
-    }
-    // put final collections into event
-    if (_diag > 0) _hmanager->fillHistograms(&_data);
+      pickBestHelix(helix_seed_vec, result.indexBest);
+      result.seeds = std::move(helix_seed_vec);
 
-    for(auto const& hel : _hels ) {
-      event.put(std::move(helcols[hel]),Helicity::name(hel));
     }
   }
+
 //--------------------------------------------------------------------------------
 // function to select the best Helix among the results of the two helicity hypo
 //--------------------------------------------------------------------------------
@@ -534,6 +577,7 @@ namespace mu2e {
 
     static XYZVec  zaxis(0.0,0.0,1.0); // unit in z direction
     ComboHit*      hhit(0);
+    HelixHitMVA    vmva; // input variables to TMVA for filtering hits
 
     for (unsigned f=0; f<helixData._chHitsToProcess.size(); ++f){
       hhit = &helixData._chHitsToProcess[f];
@@ -550,13 +594,13 @@ namespace mu2e {
       helix.position(hpos);                     // this computes the helix expectation at that z
       XYZVec dh = hhit->pos() - hpos; // this is the vector between them
 
-      _vmva._dtrans = fabs(dh.Dot(wtdir));              // transverse projection
-      _vmva._dwire = fabs(dh.Dot(wdir));               // projection along wire direction
-      _vmva._drho = fabs(sqrtf(cvec.mag2()) - helix.radius()); // radius difference
-      _vmva._dphi = fabs(hhit->helixPhi() - helix.circleAzimuth(hhit->pos().z())); // azimuth difference WRT circle center
-      _vmva._hhrho = sqrtf(cvec.mag2());            // hit transverse radius WRT circle center
-      _vmva._hrho = sqrtf(hpos.Perp2());            // hit detector transverse radius
-      _vmva._rwdot = fabs(wdir.Dot(cdir));  // compare directions of radius and wire
+      vmva._dtrans = fabs(dh.Dot(wtdir));              // transverse projection
+      vmva._dwire = fabs(dh.Dot(wdir));               // projection along wire direction
+      vmva._drho = fabs(sqrtf(cvec.mag2()) - helix.radius()); // radius difference
+      vmva._dphi = fabs(hhit->helixPhi() - helix.circleAzimuth(hhit->pos().z())); // azimuth difference WRT circle center
+      vmva._hhrho = sqrtf(cvec.mag2());            // hit transverse radius WRT circle center
+      vmva._hrho = sqrtf(hpos.Perp2());            // hit detector transverse radius
+      vmva._rwdot = fabs(wdir.Dot(cdir));  // compare directions of radius and wire
 
       // compute the total resolution including hit and helix parameters first along the wire
       float wres2 = std::pow(hhit->posRes(StrawHitPosition::wire),(int)2) +
@@ -568,14 +612,14 @@ namespace mu2e {
 	std::pow(_cradres*cdir.Dot(wtdir),(int)2) +
 	std::pow(_cperpres*cperp.Dot(wtdir),(int)2);
 
-      _vmva._chisq = sqrtf( _vmva._dwire*_vmva._dwire/wres2 + _vmva._dtrans*_vmva._dtrans/wtres2 );
-      _vmva._dt = hhit->time() - helixData._hseed._t0.t0();
+      vmva._chisq = sqrtf( vmva._dwire*vmva._dwire/wres2 + vmva._dtrans*vmva._dtrans/wtres2 );
+      vmva._dt = hhit->time() - helixData._hseed._t0.t0();
 
       if (hhit->_flag.hasAnyProperty(StrawHitFlag::stereo))
 	{
-	  hhit->_qual = _stmva.evalMVA(_vmva._pars);
+	  hhit->_qual = _stmva.evalMVA(vmva._pars);
 	} else {
-	hhit->_qual = _nsmva.evalMVA(_vmva._pars);
+	hhit->_qual = _nsmva.evalMVA(vmva._pars);
       }
     }
   }
@@ -708,8 +752,11 @@ namespace mu2e {
     // size_t nhit = hhits.size();
     int nhit = HelixData._nFiltComboHits;
 
-    ComboHit*  hit(0);
-    ComboHit*  worsthit(0);
+    // the iterations read the positions and the azimuths from a compact copy of the hits
+    ComboHitSoA             chSoA;
+    chSoA.fill(HelixData._chHitsToProcess);
+    const ComboHitSoA::View hits = chSoA.view();
+    int                     worsthit(-1);
 
     NRemovedStrawHits = 0;
 
@@ -720,12 +767,11 @@ namespace mu2e {
 	accumulator_set<float, stats<tag::median(with_p_square_quantile) > > accx;
 	accumulator_set<float, stats<tag::median(with_p_square_quantile) > > accy;
 
-	for (unsigned f=0; f<HelixData._chHitsToProcess.size(); ++f){
-	  hit =  &HelixData._chHitsToProcess[f];
-	  bool trashHit=hit->_flag.hasAnyProperty(_outlier);
+	for (unsigned f=0; f<hits.n; ++f){
+	  bool trashHit=hits.flag[f].hasAnyProperty(_outlier);
 	  if (trashHit)                              continue;
-	  accx(hit->_pos.x());
-	  accy(hit->_pos.y());
+	  accx(hits.x[f]);
+	  accy(hits.y[f]);
 	  ++nhit;
 	}
 
@@ -735,23 +781,23 @@ namespace mu2e {
 
 	float maxdphi{0.0};
 	// auto worsthit = hhits.end();
-	for (unsigned f=0; f<HelixData._chHitsToProcess.size(); ++f){
-	  hit =  &HelixData._chHitsToProcess[f];
-	  bool trashHit = hit->_flag.hasAnyProperty(_outlier);
+	for (unsigned f=0; f<hits.n; ++f){
+	  bool trashHit = hits.flag[f].hasAnyProperty(_outlier);
 	  if (trashHit)                              continue;
-	  float phi  = polyAtan2(hit->pos().y(), hit->pos().x());//ihit->pos().phi();
+	  float phi  = hits.phi[f];
 	  float dphi = fabs(Angles::deltaPhi(phi,mphi));
 	  if(dphi > maxdphi)
 	    {
 	      maxdphi = dphi;
-	      worsthit = hit;
+	      worsthit = f;
 	    }
 	}//end loop over the faces
 
 	if (maxdphi > _maxphisep)
 	  {
-	    worsthit->_flag.merge(_outlier);
-	    NRemovedStrawHits += worsthit->nStrawHits();
+	    HelixData._chHitsToProcess[worsthit]._flag.merge(_outlier);
+	    chSoA.mergeFlag(worsthit,_outlier);
+	    NRemovedStrawHits += hits.nsh[worsthit];
 	    changed = true;
 	  }
       }
@@ -800,7 +846,7 @@ namespace mu2e {
 
     for (int i=0; i<size; ++i) {
       loc = shIndices[i];
-      const ComboHit& ch  = (*_hfResult._chcol)[loc];
+      const ComboHit& ch  = (*HelixData._chcol)[loc];
       if(ch.flag().hasAnyProperty(_hsel) && !ch.flag().hasAnyProperty(_hbkg) ) {
 	ordChCol.push_back(ComboHit(ch));
       }
@@ -816,14 +862,14 @@ namespace mu2e {
 
     for (unsigned i=0; i<ordChCol.size(); ++i) {
       // loc = shIndices[i];
-      // const ComboHit& ch  = _hfResult._chcol->at(loc);
+      // const ComboHit& ch  = HelixData._chcol->at(loc);
       ComboHit& ch = ordChCol[i];
 
       //    if(ch.flag().hasAnyProperty(_hsel) && !ch.flag().hasAnyProperty(_hbkg) ) {
       ComboHit hhit(ch);
       hhit._flag.clear(StrawHitFlag::resolvedphi);
 
-      _hfResult._chHitsToProcess.push_back(hhit);
+      HelixData._chHitsToProcess.push_back(hhit);
 
       cx.Station                 = ch.strawId().station();//straw.id().getStation();
       cx.Plane                   = ch.strawId().plane() % 2;//straw.id().getPlane() % 2;
@@ -837,7 +883,7 @@ namespace mu2e {
       int of       = co.Face;
       int op       = co.Panel;
 
-      _hfResult._chHitsWPos.push_back(XYWVec(hhit.pos(),  of, hhit.nStrawHits()));
+      HelixData._chHitsWPos.push_back(XYWVec(hhit.pos(),  of, hhit.nStrawHits()));
 
       int       stationId = os;
       int       faceId    = of + stationId*StrawId::_nfaces*FaceZ_t::kNPlanesPerStation;//RobustHelixFinderData::kNFaces;
@@ -848,17 +894,17 @@ namespace mu2e {
       //	pz->_chHitsToProcess.push_back(hhit);//[fz->fNHits] = hhit;
       //	pz->fNHits  = pz->fNHits + 1;
       if (pz->idChBegin < 0 ){
-	pz->idChBegin = _hfResult._chHitsToProcess.size() - 1;
-	pz->idChEnd   = _hfResult._chHitsToProcess.size();
+	pz->idChBegin = HelixData._chHitsToProcess.size() - 1;
+	pz->idChEnd   = HelixData._chHitsToProcess.size();
       } else {
-	pz->idChEnd   = _hfResult._chHitsToProcess.size();
+	pz->idChEnd   = HelixData._chHitsToProcess.size();
       }
 
       if (fz->idChBegin < 0 ){
-	fz->idChBegin = _hfResult._chHitsToProcess.size() - 1;
-	fz->idChEnd   = _hfResult._chHitsToProcess.size();
+	fz->idChBegin = HelixData._chHitsToProcess.size() - 1;
+	fz->idChEnd   = HelixData._chHitsToProcess.size();
       } else {
-	fz->idChEnd   = _hfResult._chHitsToProcess.size();
+	fz->idChEnd   = HelixData._chHitsToProcess.size();
       }
 
       if (_debug>0){
@@ -1041,7 +1087,7 @@ namespace mu2e {
   }
 
 
-  void RobustHelixFinder::fitHelix(RobustHelixFinderData& helixData){
+  void RobustHelixFinder::fitHelix(RobustHelixFit& hfit, RobustHelixFinderData& helixData){
     // iteratively fit the helix including filtering
     unsigned niter(0);
     unsigned nitermva(0);
@@ -1051,7 +1097,7 @@ namespace mu2e {
     do {
       niterxy = 0;
       do {
-	_hfit.fitCircle(helixData, _targetcon, _useTripletAreaWt);
+	hfit.fitCircle(helixData, _targetcon, _useTripletAreaWt);
 	xychanged = filterCircleHits(helixData) > 0;
 	++niterxy;
       } while (helixData._hseed._status.hasAllProperties(TrkFitFlag::circleOK) && niterxy < _maxniter && xychanged);
@@ -1078,7 +1124,7 @@ namespace mu2e {
 	niterfz = 0;
 	fzchanged = false;
 	do {
-	  _hfit.fitFZ(helixData);
+	  hfit.fitFZ(helixData);
 	  fzchanged = filterHits(helixData);
 	  ++niterfz;
 	} while (helixData._hseed._status.hasAllProperties(TrkFitFlag::phizOK)  && niterfz < _maxniter && fzchanged);
@@ -1102,13 +1148,13 @@ namespace mu2e {
       // update the stereo hit positions; this checks how much the positions changed
       // do this only in non trigger mode
 
-      if (_updateStereo && _hfit.goodHelix(helixData._hseed.helix()))
+      if (_updateStereo && hfit.goodHelix(helixData._hseed.helix()))
 	changed |= updateStereo(helixData);
-    } while (_hfit.goodHelix(helixData._hseed.helix()) && niter < _maxniter && changed);
+    } while (hfit.goodHelix(helixData._hseed.helix()) && niter < _maxniter && changed);
 
     if (_diag) helixData._diag.niter = niter;
 
-    if (_hfit.goodHelix(helixData._hseed.helix())  &&
+    if (hfit.goodHelix(helixData._hseed.helix())  &&
 	helixData._hseed._status.hasAnyProperty(TrkFitFlag::circleOK) &&
 	helixData._hseed._status.hasAnyProperty(TrkFitFlag::phizOK) ) {
 
@@ -1122,7 +1168,7 @@ namespace mu2e {
 	  fillMVA(helixData);
 	  changed = filterHitsMVA(helixData);
 	  if (!changed) break;
-	  refitHelix(helixData);
+	  refitHelix(hfit, helixData);
 	  // update t0 each iteration as that's used in the MVA
 	  updateT0(helixData);
 	  ++nitermva;
@@ -1146,14 +1192,14 @@ namespace mu2e {
 
   //------------------------------------------------------------------------------------------
 
-  void RobustHelixFinder::refitHelix(RobustHelixFinderData& helixData) {
+  void RobustHelixFinder::refitHelix(RobustHelixFit& hfit, RobustHelixFinderData& helixData) {
     // reset the fit status flags, in case this is called iteratively
 
     helixData._hseed._status.clear(TrkFitFlag::helixOK);
-    _hfit.fitCircle(helixData, _targetcon, _useTripletAreaWt);
+    hfit.fitCircle(helixData, _targetcon, _useTripletAreaWt);
     if (helixData._hseed._status.hasAnyProperty(TrkFitFlag::circleOK)) {
-      _hfit.fitFZ(helixData);
-      if (_hfit.goodHelix(helixData._hseed._helix)) helixData._hseed._status.merge(TrkFitFlag::helixOK);
+      hfit.fitFZ(helixData);
+      if (hfit.goodHelix(helixData._hseed._helix)) helixData._hseed._status.merge(TrkFitFlag::helixOK);
     }
   }
 
@@ -24,6 +24,7 @@
 // tracking
 #include "Offline/TrkReco/inc/TrkUtilities.hh"
 #include "Offline/TrkReco/inc/TrkTimeCalculator.hh"
+#include "Offline/TrkReco/inc/ComboHitSoA.hh"
 // root
 #include "TH1F.h"
 // boost
@@ -123,6 +124,9 @@ namespace mu2e {
        const StrawHitFlagCollection* _shfcol;
        const ComboHitCollection*     _chcol;
        const CaloClusterCollection*  _cccol;
+       ComboHitSoA                   _chSoA;     // compact copy of the event hits, with the flags used for selection
+       ComboHitSoA::View             _hits;
+       std::vector<float>            _htime;     // hit times, from the TrkTimeCalculator
        StrawHitFlag                  _hsel;
        StrawHitFlag                  _hbkg;
        MVATools                      _tcMVA;     
@@ -236,6 +240,10 @@ namespace mu2e {
 	throw cet::exception("RECO")<<"TimeClusterFinder: inconsistent flag collection length " << endl;
     }
 
+    // the loops below read the hits from the compact copy
+    _chSoA.fill(*_chcol, _testflag ? _shfcol : nullptr);
+    _hits = _chSoA.view();
+
     std::unique_ptr<TimeClusterCollection> tccol(new TimeClusterCollection);
     // If requested, use calo clusters to for time cluster seeds
     if (_usecc) findCaloSeeds(*tccol,ccH);
@@ -310,20 +318,20 @@ namespace mu2e {
   //--------------------------------------------------------------------------------------------------------------
   void TimeClusterFinder::fillTimeSpectrum() {
     _timespec.Reset();
-    for (unsigned istr=0; istr<_chcol->size();++istr) {
-      if (_testflag && !goodHit((*_shfcol)[istr])) continue;
-      ComboHit const& ch = (*_chcol)[istr];
-      float time = _ttcalc.comboHitTime((*_chcol)[istr],_pitch);
-      _timespec.Fill(time,ch.nStrawHits());
+    // the hit times are computed once per event, and used by all the steps
+    _htime.resize(_hits.n);
+    for (unsigned istr=0; istr<_hits.n;++istr) {
+      _htime[istr] = _ttcalc.comboHitTime((*_chcol)[istr],_pitch);
+      if (_testflag && !goodHit(_hits.flag[istr])) continue;
+      _timespec.Fill(_htime[istr],_hits.nsh[istr]);
     }
   }
 
   void TimeClusterFinder::assignHits(TimeClusterCollection& tccol ) {
   // assign hits to the closest time peak
-    for(size_t istr=0; istr<_chcol->size(); ++istr) {
-      if ((!_testflag) || goodHit((*_shfcol)[istr])) {
-	ComboHit const& ch =(*_chcol)[istr];
-	float time = _ttcalc.comboHitTime(ch,_pitch);
+    for(size_t istr=0; istr<_hits.n; ++istr) {
+      if ((!_testflag) || goodHit(_hits.flag[istr])) {
+	float time = _htime[istr];
 	float mindt(1e5);
 	auto besttc = tccol.end();
 	// find the closest seed (if any)
@@ -387,19 +395,17 @@ namespace mu2e {
     unsigned nstrs = tc._strawHitIdxs.size();
     tc._nsh = 0;
     for(auto ish :tc._strawHitIdxs) {
-      if (_testflag && !goodHit((*_shfcol)[ish])) continue;
-      ComboHit const& ch = (*_chcol)[ish];
-      unsigned nsh = ch.nStrawHits();
+      if (_testflag && !goodHit(_hits.flag[ish])) continue;
+      unsigned nsh = _hits.nsh[ish];
       tc._nsh += nsh;
-      const XYZVec& pos = ch.pos();
-      float htime = _ttcalc.comboHitTime(ch,_pitch);
-      float hwt = ch.nStrawHits();
+      float htime = _htime[ish];
+      float hwt = nsh;
       tmin(htime);
       tmax(htime);
       tacc(htime,weight=hwt);
-      xacc(pos.x(),weight=hwt);
-      yacc(pos.y(),weight=hwt);
-      zacc(pos.z(),weight=hwt);
+      xacc(_hits.x[ish],weight=hwt);
+      yacc(_hits.y[ish],weight=hwt);
+      zacc(_hits.z[ish],weight=hwt);
     }
 
     if (tc.hasCaloCluster()) {
@@ -430,8 +436,7 @@ namespace mu2e {
       auto iworst = tc._strawHitIdxs.end();
       float maxadPhi(_maxdPhi);
       for( auto ips = tc._strawHitIdxs.begin(); ips != tc._strawHitIdxs.end(); ++ips){
-	ComboHit const& ch = (*_chcol)[*ips];
-	float phi   = polyAtan2(ch.pos().y(), ch.pos().x()); 
+	float phi   = _hits.phi[*ips];
 	float dphi  = Angles::deltaPhi(phi,pphi);
 	float adphi = std::abs(dphi);
 	if(adphi > maxadPhi ){
@@ -451,16 +456,15 @@ namespace mu2e {
     while (changed) {
       changed = false;
       float pphi = polyAtan2(tc._pos.y(), tc._pos.x());
-      for(size_t ich=0;ich < _chcol->size(); ++ich){
-	if ((!_testflag) || goodHit((*_shfcol)[ich])) {
+      for(size_t ich=0;ich < _hits.n; ++ich){
+	if ((!_testflag) || goodHit(_hits.flag[ich])) {
 	  if(std::find(tc._strawHitIdxs.begin(),tc._strawHitIdxs.end(),ich) == tc._strawHitIdxs.end()){
-	    ComboHit const& ch = (*_chcol)[ich];
-	    float cht = _ttcalc.comboHitTime(ch,_pitch);
-	    _pmva._dt = fabs(cht - tc._t0._t0);
+	    _pmva._dt = fabs(_htime[ich] - tc._t0._t0);
 	    if(_pmva._dt < _maxdt+tc._t0._t0err){
-	      float phi = polyAtan2(ch.pos().y(), ch.pos().x());//ch.phi();
+	      float phi = _hits.phi[ich];
 	      float dphi = fabs(Angles::deltaPhi(phi,pphi));
 	      if(dphi < _maxdPhi){ 
+		ComboHit const& ch = (*_chcol)[ich];
 		_pmva._dphi = dphi;
 		_pmva._rho = ch.pos().Perp2();
 		_pmva._nsh = ch.nStrawHits();
@@ -491,7 +495,7 @@ namespace mu2e {
     float denom = float(tc._nsh - nsh);
     // update time cluster properties 
     if(!tc.hasCaloCluster()){
-      float cht = _ttcalc.comboHitTime(ch,_pitch);
+      float cht = _htime[*iworst];
       float newt0  = (tc._t0._t0*tc._nsh - cht*nsh)/denom;
       tc._t0._t0err = sqrt((tc._t0._t0err*tc._t0._t0err*tc._nsh - (cht-newt0)*(cht-tc._t0._t0)*nsh )/denom);
       tc._t0._t0 = newt0;
@@ -509,7 +513,7 @@ namespace mu2e {
     float denom = float(tc._nsh + nsh);
     // update time cluster properties 
     if(!tc.hasCaloCluster()){
-      float cht = _ttcalc.comboHitTime(ch,_pitch);
+      float cht = _htime[iadd];
       float newt0  = (tc._t0._t0*tc._nsh + cht*nsh)/denom;
       tc._t0._t0err = sqrt((tc._t0._t0err*tc._t0._t0err*tc._nsh + (cht-newt0)*(cht-tc._t0._t0)*nsh )/denom);
       tc._t0._t0 = newt0;
@@ -526,13 +530,11 @@ namespace mu2e {
     accumulator_set<float, stats<tag::weighted_variance(lazy)>, float > terr;
     accumulator_set<float, stats<tag::weighted_mean >,float > xacc, yacc, zacc;
     for(StrawHitIndex ish : tc._strawHitIdxs) {
-      ComboHit const& ch = (*_chcol)[ish];
-      float hwt = ch.nStrawHits();
-      float cht = _ttcalc.comboHitTime(ch,_pitch);
-      terr(cht,weight=hwt);
-      xacc(ch.pos().x(),weight=hwt);
-      yacc(ch.pos().y(),weight=hwt);
-      zacc(ch.pos().z(),weight=hwt);
+      float hwt = _hits.nsh[ish];
+      terr(_htime[ish],weight=hwt);
+      xacc(_hits.x[ish],weight=hwt);
+      yacc(_hits.y[ish],weight=hwt);
+      zacc(_hits.z[ish],weight=hwt);
     }
     if (tc.hasCaloCluster()) {
       if(_useccpos){
@@ -559,10 +561,9 @@ namespace mu2e {
       float pphi = polyAtan2(tc._pos.y(), tc._pos.x());
       for (auto ips=tc._strawHitIdxs.begin();ips != tc._strawHitIdxs.end();++ips) {
         ComboHit const& ch = (*_chcol)[*ips];
-        float cht = _ttcalc.comboHitTime(ch,_pitch);
 
-        _pmva._dt = fabs(cht - tc._t0._t0);
-        float phi = polyAtan2(ch.pos().y(), ch.pos().x());//ch.phi();
+        _pmva._dt = fabs(_htime[*ips] - tc._t0._t0);
+        float phi = _hits.phi[*ips];
         float dphi = Angles::deltaPhi(phi,pphi);
         _pmva._dphi = fabs(dphi);
 	_pmva._rho = ch.pos().Perp2();
@@ -0,0 +1,72 @@
+//
+// Compact copy of the ComboHit fields read by the pattern recognition loops:
+// position, time, azimuth, energy deposition, number of straw hits and flag,
+// in single precision and in separate arrays (structure of arrays).
+// A ComboHit is 124 bytes, of which these loops read ~30, so looping over
+// the ComboHits themselves touches several cache lines per hit.
+//
+// Fill once per event (or per time cluster) and pass the View, a set of
+// pointers to the arrays, to the loops.  The azimuth is computed once, at
+// fill time, with polyAtan2.  Only the flags can be changed after filling.
+// The ComboHit collections themselves are unchanged, as they are persisted.
+//
+#ifndef TrkReco_ComboHitSoA_HH
+#define TrkReco_ComboHitSoA_HH
+
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace mu2e {
+
+  class ComboHitSoA {
+  public:
+
+    // non-owning view of the arrays, valid until the next fill, push_back or clear
+    struct View {
+      size_t               n     = 0;
+      const float*         x     = nullptr;
+      const float*         y     = nullptr;
+      const float*         z     = nullptr;
+      const float*         t     = nullptr;   // ComboHit::time()
+      const float*         phi   = nullptr;   // azimuth of the position
+      const float*         edep  = nullptr;
+      const uint16_t*      nsh   = nullptr;
+      const StrawHitFlag*  flag  = nullptr;
+      const StrawHitIndex* index = nullptr;   // index of the hit in the collection it was copied from
+    };
+
+    void   clear();
+    void   reserve(size_t n);
+    void   push_back(ComboHit const& ch, StrawHitIndex index, StrawHitFlag const& flag);
+    void   push_back(ComboHit const& ch, StrawHitIndex index) { push_back(ch, index, ch.flag()); }
+
+    // copy all the hits, in order.  If shfcol is given, the flags are taken from it
+    void   fill(std::vector<ComboHit> const& chcol, StrawHitFlagCollection const* shfcol = nullptr);
+    // copy the hits with the given indices (for example the hits of a TimeCluster), in that order
+    void   fill(std::vector<ComboHit> const& chcol, std::vector<StrawHitIndex> const& indices,
+		StrawHitFlagCollection const* shfcol = nullptr);
+
+    size_t size () const { return _x.size(); }
+    View   view () const;
+    // memory used by the arrays
+    size_t bytes() const;
+
+    void   mergeFlag(size_t i, StrawHitFlag const& flag) { _flag[i].merge(flag); }
+    void   clearFlag(size_t i, StrawHitFlag const& flag) { _flag[i].clear(flag); }
+
+  private:
+    void   resize(size_t n);
+    void   set(size_t i, ComboHit const& ch, StrawHitIndex index, StrawHitFlag const& flag);
+
+    std::vector<float>          _x, _y, _z, _t, _phi, _edep;
+    std::vector<uint16_t>       _nsh;
+    std::vector<StrawHitFlag>   _flag;
+    std::vector<StrawHitIndex>  _index;
+  };
+}
+#endif
@@ -0,0 +1,68 @@
+//
+// Work arrays for RobustHelixFit: the hits used in a fit, copied once per
+// fit into contiguous float arrays, and the histograms of the lambda and phi
+// searches.
+// The buffers are kept from one fit to the next.
+//
+// The sums over hits are accumulated in kNLanes partial sums, so that the
+// compiler can vectorize them.
+//
+#ifndef TrkReco_HelixFitWorkspace_HH
+#define TrkReco_HelixFitWorkspace_HH
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace mu2e {
+
+  // struct to hold AGE sums
+  struct AGESums {
+    // (s)ums of (c)osine and (s)in for points on (c)ircumference, (o)utside the median radius, or (i)nside the median radius
+    float _scc, _ssc, _sco, _sso, _sci, _ssi;
+    unsigned _nc, _no, _ni;
+    AGESums() : _scc(0.0),_ssc(0.0),_sco(0.0),_sso(0.0),_sci(0.0),_ssi(0.0){}
+    void clear() { _scc = _ssc = _sco = _sso = _sci = _ssi = 0.0;
+      _nc = _no = _ni = 0; }
+  };
+
+  class HelixFitWorkspace {
+  public:
+
+    constexpr static unsigned kNLanes = 8;
+
+    void   clear();
+    void   push(float X, float Y, float Z, float Phi, float Wt, uint16_t Face);
+    size_t size() const { return _x.size(); }
+
+    // sum of the weights of the hits
+    float  weightSum() const;
+    // radii of the hits wrt the center (CX,CY), in radii()
+    void   fillRadii(float CX, float CY);
+    // sum of weight*|radius-RMed| over the radii filled last
+    float  absDevSum(float RMed) const;
+    // sums of the AGE descent vector for the center (CX,CY), unnormalized.  Refills radii()
+    void   fillAGESums(float CX, float CY, float RMed, float RWind, AGESums& Sums);
+    // histogram |dz| of all the pairs of hits in different faces, returns the number of entries
+    unsigned fillDzHist(float StartDz, float BinSize, std::vector<int>& Hist);
+
+    const std::vector<float>&    x     () const { return _x;     }
+    const std::vector<float>&    y     () const { return _y;     }
+    const std::vector<float>&    z     () const { return _z;     }
+    const std::vector<float>&    phi   () const { return _phi;   }
+    const std::vector<float>&    weight() const { return _wt;    }
+    const std::vector<uint16_t>& face  () const { return _face;  }
+    const std::vector<float>&    radii () const { return _rad;   }
+
+    std::vector<int>             _hist;    // lambda histograms, reused by the callers
+    std::vector<int>             _histSum;
+    std::vector<int>             _phiHist; // phi at z=0 histogram of extractFZ0
+
+  private:
+    std::vector<float>           _x, _y, _z, _phi, _wt;
+    std::vector<uint16_t>        _face;
+    std::vector<float>           _rad;     // radii wrt the last center
+    std::vector<int>             _bin;     // work array for fillDzHist
+  };
+}
+#endif
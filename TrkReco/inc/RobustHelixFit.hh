@@ -11,11 +11,11 @@
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
 #include "BTrk/TrkBase/TrkErrCode.hh"
-#include "TH1F.h"
 #include "Math/VectorUtil.h"
 #include "Math/Vector2D.h"
 //#include "Mu2eUtilities/inc/LsqSums4.hh"
 #include "Offline/TrkReco/inc/RobustHelixFinderData.hh"
+#include "Offline/TrkReco/inc/HelixFitWorkspace.hh"
 
 #include "Offline/Mu2eUtilities/inc/MedianCalculator.hh"
 
@@ -35,16 +35,6 @@ namespace mu2e
     FZ(XYZVec const& hpos, XYZVec const& center);
   };
 
-  // struct to hold AGE sums
-  struct AGESums {
-    // (s)ums of (c)osine and (s)in for points on (c)ircumference, (o)utside the median radius, or (i)nside the median radius
-    float _scc, _ssc, _sco, _sso, _sci, _ssi;
-    unsigned _nc, _no, _ni;
-    AGESums() : _scc(0.0),_ssc(0.0),_sco(0.0),_sso(0.0),_sci(0.0),_ssi(0.0){}
-    void clear() { _scc = _ssc = _sco = _sso = _sci = _ssi = 0.0;
-      _nc = _no = _ni = 0; }
-  };
-
 
   class RobustHelixFit
   {
@@ -155,8 +145,10 @@ namespace mu2e
     void fitHelix(RobustHelixFinderData& helixData, bool forceTargetCon, bool useTripletAreaWt=false);
     void fitCircleAGE(RobustHelixFinderData& helixData);
     void fitCircleMean(RobustHelixFinderData& helixData);
-    void findAGE(RobustHelixFinderData  const& helixData, XYZVec const& center,float& rmed, float& age);
-    void fillSums(RobustHelixFinderData const& helixData, XYZVec const& center,float rmed,AGESums& sums);
+    void findAGE(XYZVec const& center,float& rmed, float& age);
+    void fillSums(XYZVec const& center,float rmed,AGESums& sums);
+    // copy the hits used in the fit into the workspace
+    void loadWorkspace(std::vector<ComboHit> const& hhits);
     void forceTargetInter(XYZVec& center, float& radius);
 
     bool use(ComboHit const&) const;
@@ -208,7 +200,6 @@ namespace mu2e
     float _trackerradius; // tracker radius to use in init
     float _rwind; // raidus window for defining points to be 'on' the helix
     Helicity _helicity; // helicity value to look for.  This defines the sign of dphi/dz
-    TH1F _hphi;
     unsigned _ntripleMin, _ntripleMax;
     bool     _use_initFZ_from_dzFrequency;
     float    _initFZFrequencyNSigma;
@@ -220,7 +211,12 @@ namespace mu2e
     float    _initFZMinL, _initFZMaxL, _initFZStepL;
     unsigned _fitFZNBins;
     float    _fitFZMinL, _fitFZMaxL, _fitFZStepL;
-    MedianCalculator  _medianCalculator;
+    // state of the current fit, the only members modified by the fits: to run fits
+    // concurrently, use one copy of the RobustHelixFit per task
+    MedianCalculator  _medianCalculator; // incremental, for the AGE iterations
+    HelixFitWorkspace _ws; // hits of the current fit, and histogram buffers
+    bool     _ccInFit; // the AGE fit uses the calorimeter cluster
+    XYZVec   _ccPos;   // its position in the tracker frame
   };
 }
 #endif
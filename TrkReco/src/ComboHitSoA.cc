@@ -0,0 +1,113 @@
+//
+// Compact structure-of-arrays copy of ComboHits for the pattern recognition
+//
+#include "Offline/TrkReco/inc/ComboHitSoA.hh"
+#include "Offline/Mu2eUtilities/inc/polyAtan2.hh"
+#include "cetlib_except/exception.h"
+
+namespace mu2e {
+
+  void ComboHitSoA::clear() {
+    _x.clear();
+    _y.clear();
+    _z.clear();
+    _t.clear();
+    _phi.clear();
+    _edep.clear();
+    _nsh.clear();
+    _flag.clear();
+    _index.clear();
+  }
+
+  void ComboHitSoA::reserve(size_t n) {
+    _x.reserve(n);
+    _y.reserve(n);
+    _z.reserve(n);
+    _t.reserve(n);
+    _phi.reserve(n);
+    _edep.reserve(n);
+    _nsh.reserve(n);
+    _flag.reserve(n);
+    _index.reserve(n);
+  }
+
+  void ComboHitSoA::push_back(ComboHit const& ch, StrawHitIndex index, StrawHitFlag const& flag) {
+    float x = ch.pos().x();
+    float y = ch.pos().y();
+    _x.push_back(x);
+    _y.push_back(y);
+    _z.push_back(ch.pos().z());
+    _t.push_back(ch.time());
+    _phi.push_back(polyAtan2(y,x));
+    _edep.push_back(ch.energyDep());
+    _nsh.push_back(ch.nStrawHits());
+    _flag.push_back(flag);
+    _index.push_back(index);
+  }
+
+  void ComboHitSoA::fill(std::vector<ComboHit> const& chcol, StrawHitFlagCollection const* shfcol) {
+    if (shfcol && shfcol->size() != chcol.size())
+      throw cet::exception("RECO")<<"ComboHitSoA: inconsistent flag collection length" << std::endl;
+    resize(chcol.size());
+    for (size_t i=0; i<chcol.size(); ++i) {
+      set(i, chcol[i], i, shfcol ? (*shfcol)[i] : chcol[i].flag());
+    }
+  }
+
+  void ComboHitSoA::fill(std::vector<ComboHit> const& chcol, std::vector<StrawHitIndex> const& indices,
+			 StrawHitFlagCollection const* shfcol) {
+    if (shfcol && shfcol->size() != chcol.size())
+      throw cet::exception("RECO")<<"ComboHitSoA: inconsistent flag collection length" << std::endl;
+    resize(indices.size());
+    for (size_t i=0; i<indices.size(); ++i) {
+      StrawHitIndex ich = indices[i];
+      set(i, chcol[ich], ich, shfcol ? (*shfcol)[ich] : chcol[ich].flag());
+    }
+  }
+
+  void ComboHitSoA::resize(size_t n) {
+    _x.resize(n);
+    _y.resize(n);
+    _z.resize(n);
+    _t.resize(n);
+    _phi.resize(n);
+    _edep.resize(n);
+    _nsh.resize(n);
+    _flag.resize(n);
+    _index.resize(n);
+  }
+
+  void ComboHitSoA::set(size_t i, ComboHit const& ch, StrawHitIndex index, StrawHitFlag const& flag) {
+    float x   = ch.pos().x();
+    float y   = ch.pos().y();
+    _x   [i]  = x;
+    _y   [i]  = y;
+    _z   [i]  = ch.pos().z();
+    _t   [i]  = ch.time();
+    _phi [i]  = polyAtan2(y,x);
+    _edep[i]  = ch.energyDep();
+    _nsh [i]  = ch.nStrawHits();
+    _flag[i]  = flag;
+    _index[i] = index;
+  }
+
+  ComboHitSoA::View ComboHitSoA::view() const {
+    View v;
+    v.n     = _x.size();
+    v.x     = _x.data();
+    v.y     = _y.data();
+    v.z     = _z.data();
+    v.t     = _t.data();
+    v.phi   = _phi.data();
+    v.edep  = _edep.data();
+    v.nsh   = _nsh.data();
+    v.flag  = _flag.data();
+    v.index = _index.data();
+    return v;
+  }
+
+  size_t ComboHitSoA::bytes() const {
+    return _x.capacity()*sizeof(float)*6 + _nsh.capacity()*sizeof(uint16_t)
+      + _flag.capacity()*sizeof(StrawHitFlag) + _index.capacity()*sizeof(StrawHitIndex);
+  }
+}
@@ -0,0 +1,145 @@
+//
+// Work arrays for RobustHelixFit
+//
+#include "Offline/TrkReco/inc/HelixFitWorkspace.hh"
+
+#include <cmath>
+
+namespace mu2e {
+
+  void HelixFitWorkspace::clear() {
+    _x.clear();
+    _y.clear();
+    _z.clear();
+    _phi.clear();
+    _wt.clear();
+    _face.clear();
+  }
+
+  void HelixFitWorkspace::push(float X, float Y, float Z, float Phi, float Wt, uint16_t Face) {
+    _x.push_back(X);
+    _y.push_back(Y);
+    _z.push_back(Z);
+    _phi.push_back(Phi);
+    _wt.push_back(Wt);
+    _face.push_back(Face);
+  }
+
+  float HelixFitWorkspace::weightSum() const {
+    size_t n(_wt.size());
+    float  acc[kNLanes] = {0};
+    size_t i(0);
+    for (; i+kNLanes<=n; i+=kNLanes)
+      for (unsigned l=0; l<kNLanes; ++l) acc[l] += _wt[i+l];
+    for (; i<n; ++i) acc[0] += _wt[i];
+    float sum(0);
+    for (unsigned l=0; l<kNLanes; ++l) sum += acc[l];
+    return sum;
+  }
+
+  void HelixFitWorkspace::fillRadii(float CX, float CY) {
+    size_t n(_x.size());
+    _rad.resize(n);
+    const float* x   = _x.data();
+    const float* y   = _y.data();
+    float*       rad = _rad.data();
+    for (size_t i=0; i<n; ++i) {
+      float dx = x[i]-CX;
+      float dy = y[i]-CY;
+      rad[i]   = std::sqrt(dx*dx+dy*dy);
+    }
+  }
+
+  float HelixFitWorkspace::absDevSum(float RMed) const {
+    size_t       n(_rad.size());
+    const float* rad = _rad.data();
+    const float* wt  = _wt.data();
+    float        acc[kNLanes] = {0};
+    size_t       i(0);
+    for (; i+kNLanes<=n; i+=kNLanes)
+      for (unsigned l=0; l<kNLanes; ++l) acc[l] += wt[i+l]*std::fabs(rad[i+l]-RMed);
+    for (; i<n; ++i) acc[0] += wt[i]*std::fabs(rad[i]-RMed);
+    float sum(0);
+    for (unsigned l=0; l<kNLanes; ++l) sum += acc[l];
+    return sum;
+  }
+
+  void HelixFitWorkspace::fillAGESums(float CX, float CY, float RMed, float RWind, AGESums& Sums) {
+    // 3 conditions: either the radius is inside the median, outside the median, or 'on' the median.
+    // Each hit is added to one of the three sums, selected by multiplying with 0 or 1 rather than
+    // by branches or comparisons, which stop the vectorization.  The radii are computed first, in a
+    // separate loop, for the same reason
+    fillRadii(CX,CY);
+    size_t       n(_x.size());
+    const float* x   = _x.data();
+    const float* y   = _y.data();
+    const float* wt  = _wt.data();
+    const float* rad = _rad.data();
+    float        scc[kNLanes] = {0}, ssc[kNLanes] = {0};
+    float        sco[kNLanes] = {0}, sso[kNLanes] = {0};
+    float        sci[kNLanes] = {0}, ssi[kNLanes] = {0};
+    float        nc [kNLanes] = {0}, no [kNLanes] = {0};
+
+    auto accumulate = [&](size_t i, unsigned l) {
+      float pcos  = (x[i]-CX)/rad[i];
+      float psin  = (y[i]-CY)/rad[i];
+      float wcos  = wt[i]*pcos;
+      float wsin  = wt[i]*psin;
+      // 1 if |rmed-rad| < window (resp. rad > rmed), 0 otherwise
+      float on    = 0.5f - 0.5f*std::copysign(1.f, std::fabs(RMed-rad[i])-RWind);
+      float above = 0.5f - 0.5f*std::copysign(1.f, RMed-rad[i]);
+      float out   = (1.f-on)*above;
+      float in    = (1.f-on)*(1.f-above);
+      scc[l] += on*std::fabs(wcos);    // the weights are positive
+      ssc[l] += on*std::fabs(wsin);
+      sco[l] += out*wcos;
+      sso[l] += out*wsin;
+      sci[l] += in*wcos;
+      ssi[l] += in*wsin;
+      nc [l] += on;
+      no [l] += out;
+    };
+
+    size_t i(0);
+    for (; i+kNLanes<=n; i+=kNLanes)
+      for (unsigned l=0; l<kNLanes; ++l) accumulate(i+l,l);
+    for (; i<n; ++i) accumulate(i,0);
+
+    Sums.clear();
+    for (unsigned l=0; l<kNLanes; ++l) {
+      Sums._scc += scc[l];
+      Sums._ssc += ssc[l];
+      Sums._sco += sco[l];
+      Sums._sso += sso[l];
+      Sums._sci += sci[l];
+      Sums._ssi += ssi[l];
+      Sums._nc  += nc [l];
+      Sums._no  += no [l];
+    }
+    Sums._ni = n - Sums._nc - Sums._no;
+  }
+
+  unsigned HelixFitWorkspace::fillDzHist(float StartDz, float BinSize, std::vector<int>& Hist) {
+    int      nbins = Hist.size();
+    size_t   n(_z.size());
+    unsigned counter(0);
+    _bin.resize(n);
+    const float*    z    = _z.data();
+    const uint16_t* face = _face.data();
+    int*            bin  = _bin.data();
+    for (size_t i1=0; i1+1<n; ++i1) {
+      // bin the pairs (i1,i2) first, then fill the histogram
+      for (size_t i2=i1+1; i2<n; ++i2) {
+        float dz = std::fabs(z[i2]-z[i1]);
+        int   i  = (dz-StartDz)/BinSize;
+        bin[i2]  = (face[i2] != face[i1] && i < nbins) ? i : -1;
+      }
+      for (size_t i2=i1+1; i2<n; ++i2) {
+        if (bin[i2] < 0) continue;
+        Hist[bin[i2]] += 1;
+        ++counter;
+      }
+    }
+    return counter;
+  }
+}
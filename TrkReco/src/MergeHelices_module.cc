@@ -13,6 +13,7 @@
 #include "art/Framework/Principal/Handle.h"
 // mu2e data products
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitLeafIndex.hh"
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
 // utilities
 #include "Offline/TrkReco/inc/TrkUtilities.hh"
@@ -58,9 +59,9 @@ namespace mu2e {
     StrawHitFlag _badhit;
     // helper functions
     typedef std::vector<StrawHitIndex> SHIV;
-    HelixComp compareHelices(art::Event const& evt,
+    HelixComp compareHelices(ComboHitLeafIndex const& leafIndex,
 	HelixSeed const& h1, HelixSeed const& h2);
-    void countHits(art::Event const& evt,
+    void countHits(ComboHitLeafIndex const& leafIndex,
 	HelixSeed const& h1, HelixSeed const& h2,
 	unsigned& nh1, unsigned& nh2, unsigned& nover);
     unsigned countOverlaps(SHIV const& s1, SHIV const& s2);
@@ -98,12 +99,13 @@ namespace mu2e {
 	hseeds.insert(hseeds.end(),&hs);
       }
     }
-// now loop over all combinations
+// now loop over all combinations; the StrawHits of each ComboHit collection are found once
+    ComboHitLeafIndex leafIndex(event);
     for(auto ihel = hseeds.begin(); ihel != hseeds.end();) {
       auto jhel = ihel; jhel++;
       while( jhel != hseeds.end()){
 	// compare the helice 
-	auto hcomp = compareHelices(event, **ihel, **jhel);
+	auto hcomp = compareHelices(leafIndex, **ihel, **jhel);
 	if(hcomp == unique) {
 	  // both helices are unique: simply advance the iterator to keep both
 	  jhel++;
@@ -135,12 +137,12 @@ namespace mu2e {
     event.put(std::move(tcs));
   }
 
-  MergeHelices::HelixComp MergeHelices::compareHelices(art::Event const& evt,
+  MergeHelices::HelixComp MergeHelices::compareHelices(ComboHitLeafIndex const& leafIndex,
     HelixSeed const& h1, HelixSeed const& h2) {
     HelixComp retval(unique);
   // count the StrawHit overlap between the helices
     unsigned nh1, nh2, nover;
-    countHits(evt,h1,h2, nh1, nh2, nover);
+    countHits(leafIndex,h1,h2, nh1, nh2, nover);
     unsigned minh = std::min(nh1, nh2);
     if(nover >= _minnover && nover/float(minh) > _minoverfrac) {
     // overlapping helices: decide which is best
@@ -165,7 +167,7 @@ namespace mu2e {
     return retval;
   }
 
-  void MergeHelices::countHits(art::Event const& evt,
+  void MergeHelices::countHits(ComboHitLeafIndex const& leafIndex,
     HelixSeed const& h1, HelixSeed const& h2,
     unsigned& nh1, unsigned& nh2, unsigned& nover) {
     nh1 = nh2 = nover = 0;
@@ -173,12 +175,12 @@ namespace mu2e {
     for(size_t ihit=0;ihit < h1.hits().size(); ihit++){
       auto const& hh = h1.hits()[ihit];
       if(!hh.flag().hasAnyProperty(_badhit))
-	h1.hits().fillStrawHitIndices(evt,ihit,shiv1);
+	leafIndex.fillStrawHitIndices(h1.hits(),ihit,shiv1);
     }
     for(size_t ihit=0;ihit < h2.hits().size(); ihit++){
       auto const& hh = h2.hits()[ihit];
       if(!hh.flag().hasAnyProperty(_badhit))
-	h2.hits().fillStrawHitIndices(evt,ihit,shiv2);
+	leafIndex.fillStrawHitIndices(h2.hits(),ihit,shiv2);
     }
     nh1 = shiv1.size();
     nh2 = shiv2.size();
@@ -23,6 +23,7 @@
 //c++
 #include <vector>
 #include <utility>
+#include <algorithm>
 #include <string>
 #include <cmath>
 
@@ -78,7 +79,6 @@ namespace mu2e
     _targetradius(config.targetradius()), // effective target radius (mm)
     _trackerradius(config.trackerradius()), // tracker out radius; (mm)
     _rwind(config.RadiusWindow()), // window for calling a point to be 'on' the helix in the AGG fit (mm)
-    _hphi("hphi","phi value",_nphibins,-_phifactor*CLHEP::pi,_phifactor*CLHEP::pi),
     _ntripleMin(config.ntripleMin()),
     _ntripleMax(config.ntripleMax()),
     _use_initFZ_from_dzFrequency(config.use_initFZ_from_dzFrequency()),
@@ -87,7 +87,9 @@ namespace mu2e
     _initFZStepL(config.initFZStepLambda()),
     _fitFZMinL(config.fitFZMinLambda()),
     _fitFZMaxL(config.fitFZMaxLambda()),
-    _fitFZStepL(config.fitFZStepLambda())
+    _fitFZStepL(config.fitFZStepLambda()),
+    _medianCalculator(0,true),
+    _ccInFit(false)
   { 
     _maxdphi=_minzsep/_initFZMinL;
     float minarea(config.minArea());
@@ -176,15 +178,20 @@ namespace mu2e
     float rmed = rhel.radius();
     // initialize step
     float lambda = _lambda0;
+    // copy the hits, and optionally the calo cluster position, for the iterations
+    loadWorkspace(HelixData._hseed._hhits);
+    _ccInFit = _usecc && HelixData._hseed.caloCluster().isNonnull();
+    if(_ccInFit)
+      _ccPos = Geom::toXYZVec(_calorimeter->geomUtil().mu2eToTracker(_calorimeter->geomUtil().diskFFToMu2e(HelixData._hseed.caloCluster()->diskID(),HelixData._hseed.caloCluster()->cog3Vector())));
     // find median and AGE for the initial center
-    findAGE(HelixData,center,rmed,age);
+    findAGE(center,rmed,age);
     // loop while step is large
     XYZVec descent(1.0,0.0,0.0);
     while(lambda*sqrtf(descent.mag2()) > _minlambda && niter < _maxniter)
       {
 	// fill the sums for computing the descent vector
 	AGESums sums;
-	fillSums(HelixData,center,rmed,sums);
+	fillSums(center,rmed,sums);
 	// descent vector cases: if the inner vs outer difference is significant (compared to the median), damp using the median sums,
 	// otherwise not.  These expressions take care of the undiferentiable condition on the boundary.
 	float dx(sums._sco-sums._sci);
@@ -197,7 +204,7 @@ namespace mu2e
 	// compute error function, decreasing lambda until this is better than the previous
 	float agenew;
 	XYZVec cnew = center + lambda*descent;
-	findAGE(HelixData,cnew,rmed,agenew);
+	findAGE(cnew,rmed,agenew);
 	// if we've improved, increase the step size and iterate
 	if(agenew < age){
 	  lambda *= (1.0+_lstep);
@@ -207,7 +214,7 @@ namespace mu2e
 	  while(agenew > age && miter < _maxniter && lambda*sqrtf(descent.mag2()) > _minlambda){
 	    lambda *= (1.0-_lstep);
 	    cnew = center + lambda*descent;
-	    findAGE(HelixData,cnew,rmed,agenew);
+	    findAGE(cnew,rmed,agenew);
 	    ++miter;
 	  }
 	  // if this fails, reverse the descent drection and try again
@@ -215,7 +222,7 @@ namespace mu2e
 	    descent *= -1.0;
 	    lambda *= (1.0 +_lstep);
 	    cnew = center + lambda*descent;
-	    findAGE(HelixData,cnew,rmed,agenew);
+	    findAGE(cnew,rmed,agenew);
 	  }
 	}
 	// prepare for next iteration
@@ -290,13 +297,16 @@ namespace mu2e
     }
 
     // make initial estimate of dfdz using 'nearby' pairs.  This insures they are on the same loop
-    ComboHit*      hitP1(0), *hitP2(0);
-    uint16_t       facezF1(0), facezF2(0);
-    int            nHits(HelixData._chHitsToProcess.size());
+    loadWorkspace(HelixData._chHitsToProcess);
+    const float*    hitZ   = _ws.z().data();
+    const float*    hitPhi = _ws.phi().data();
+    const uint16_t* hitFace= _ws.face().data();
+    int            nHits(_ws.size());
     // float          minX(30);
     // float          maxX(530);
     // float          stepX(20);
-    int            hist[_initFZNBins] = {0};
+    std::vector<int>& hist = _ws._hist;
+    hist.assign(_initFZNBins,0);
     // int            nbins(25);
     int            wg      = 1;
     unsigned       counter = 0;
@@ -311,20 +321,12 @@ namespace mu2e
     }
 
     for (int f1=0; f1<nHits-1; ++f1){
-      hitP1   = &HelixData._chHitsToProcess[f1];
-      if (!use(*hitP1))            continue;
-      facezF1 = hitP1->strawId().uniqueFace();
-	    
       for (int f2=f1+1; f2<nHits; ++f2){
-	hitP2 = &HelixData._chHitsToProcess[f2];
-	if (!use(*hitP2))          continue;
-
-	facezF2 = hitP2->strawId().uniqueFace();
-	if ( facezF1 == facezF2 )  continue;
+	if ( hitFace[f1] == hitFace[f2] )  continue;
 
-	float dz = hitP2->pos().z() - hitP1->pos().z();//facezF2->z - facezF1->z;
+	float dz = hitZ[f2] - hitZ[f1];
 	if (fabs(dz) < _minzsep || fabs(dz) > _maxzsep)          continue;
-	float dphi = deltaPhi(hitP1->_hphi, hitP2->_hphi);
+	float dphi = deltaPhi(hitPhi[f1], hitPhi[f2]);
 
 	int bin(-1), bin_last(-1);
 	for (int dphiloop=0; dphiloop<_nLoopsdfdz; ++dphiloop){
@@ -675,34 +677,9 @@ namespace mu2e
 // the possible combinations of faces
 //--------------------------------------------------------------------------------
   bool RobustHelixFit::fillArrayDz(RobustHelixFinderData& HelixData, std::vector<int> &hist, float &bin_size, float &start_dz){
-    ComboHit*      hitP1(0), *hitP2(0);
-    uint16_t       facezF1(0), facezF2(0);
-    int            nHits(HelixData._chHitsToProcess.size());
-    unsigned       counter = 0;
-    
-    for (int f1=0; f1<nHits-1; ++f1){
-      hitP1   = &HelixData._chHitsToProcess[f1];
-      if (!use(*hitP1))            continue;
-      facezF1 = hitP1->strawId().uniqueFace();
-	    
-      for (int f2=f1+1; f2<nHits; ++f2){
-	hitP2 = &HelixData._chHitsToProcess[f2];
-	if (!use(*hitP2))          continue;
-
-	facezF2 = hitP2->strawId().uniqueFace();
-	if ( facezF1 == facezF2 )  continue;
-
-	float dz = fabs(hitP2->pos().z() - hitP1->pos().z());
+    loadWorkspace(HelixData._chHitsToProcess);
+    unsigned counter = _ws.fillDzHist(start_dz, bin_size, hist);
 
-	//increment the hist array in the correct position
-	int i = (dz-start_dz)/bin_size;
-	if (i < _initFZFrequencyArraySize)  {
-	  hist[i] = hist[i] + 1.;
-	  ++counter;
-	}
-      }//end secondloop over the hits
-    }//end first loop over the hits
-     
     return (counter >= _minnhit);
   }
 
@@ -718,26 +695,38 @@ namespace mu2e
     RobustHelix& rhel         = HelixData._hseed._helix;
     int          nHits(HelixData._chHitsToProcess.size());
 
-    _hphi.Reset();
+    // histogram with the binning of a TH1: bin 0 is the underflow, _nphibins+1 the overflow
+    std::vector<int>& hphi = _ws._phiHist;
+    hphi.assign(_nphibins+2,0);
+    const double phimin  = -_phifactor*CLHEP::pi;
+    const double phimax  =  _phifactor*CLHEP::pi;
+    const double binSize = (phimax-phimin)/_nphibins;
+    auto fillPhi = [&](double phi) {
+      int ibin;
+      if      (phi <  phimin) ibin = 0;
+      else if (phi >= phimax) ibin = _nphibins+1;
+      else                    ibin = 1 + int(_nphibins*(phi-phimin)/(phimax-phimin));
+      ++hphi[ibin];
+    };
     for (int f=0; f<nHits; ++f){
       hitP1 = &HelixData._chHitsToProcess[f];
       if (!use(*hitP1) )             continue;   
       
       float phiex = rhel.circleAzimuth(hitP1->pos().z());
       float dphi  = deltaPhi(phiex,hitP1->helixPhi());
-      _hphi.Fill(dphi);
-      _hphi.Fill(dphi-CLHEP::twopi);
-      _hphi.Fill(dphi+CLHEP::twopi);
+      fillPhi(dphi);
+      fillPhi(dphi-CLHEP::twopi);
+      fillPhi(dphi+CLHEP::twopi);
     }//end loop over the hits
 
     // take the average of the maximum bin +- 1
-    int imax = _hphi.GetMaximumBin();
+    int imax = std::max_element(hphi.begin()+1,hphi.begin()+_nphibins+1) - hphi.begin();
     unsigned count(0);
 
     for (int ibin=std::max((int)0,imax-1); ibin <= std::min((int)imax+1,(int)_nphibins); ++ibin)
       {
-	count += _hphi.GetBinContent(ibin);
-	fz0   += _hphi.GetBinContent(ibin)*_hphi.GetBinCenter(ibin);
+	count += hphi[ibin];
+	fz0   += hphi[ibin]*(phimin + (ibin-0.5)*binSize);
       }
      
     fz0 /= count;
@@ -836,8 +825,10 @@ namespace mu2e
 
     // make initial estimate of dfdz using 'nearby' pairs.  This insures they are on the same loop
     // need to define an array of a given length 
-    std::vector<int> hist(_initFZFrequencyArraySize);
-    std::vector<int> hist_sum(_initFZFrequencyArraySize);
+    std::vector<int>& hist     = _ws._hist;
+    std::vector<int>& hist_sum = _ws._histSum;
+    hist.assign(_initFZFrequencyArraySize,0);
+    hist_sum.assign(_initFZFrequencyArraySize,0);
     float            bin_size(16.);//mm
     float            start_dz(0);
     float            dzdphisign(0);
@@ -853,13 +844,17 @@ namespace mu2e
       return false;
     }
       
-    //create the histogram of the sum of N-consectutive bins
-    for (int i = 0; i<_initFZFrequencyArraySize - _initFZFrequencyBinsToIntegrate; i++){ 
+    //create the histogram of the sum of N-consectutive bins, as a running sum
+    int nsum = _initFZFrequencyArraySize - _initFZFrequencyBinsToIntegrate;
+    if (nsum > 0){
       int sum(0);
       for (int j = 0; j< _initFZFrequencyBinsToIntegrate; j++){
-	sum += hist[i+j];
+	sum += hist[j];
+      }
+      for (int i = 0; i<nsum; i++){ 
+	hist_sum[i] = sum;
+	sum        += hist[i+_initFZFrequencyBinsToIntegrate] - hist[i];
       }
-      hist_sum[i] = sum;
     }
 
     if (InitHiPhi > 0) {
@@ -955,7 +950,7 @@ namespace mu2e
     // float          minX(10);
     // float          maxX(510);//500
     // float          stepX(4); //10
-    int            hist[_fitFZNBins] = {0};// 49
+    std::vector<int>& hist = _ws._hist;
     // int            nbins(125);     // 49
 
     //iterate over lambda and loop resolution
@@ -965,28 +960,26 @@ namespace mu2e
       {
 	changed = false;
 
-	ComboHit*      hitP1(0), *hitP2(0);
-	uint16_t       facezF1(0), facezF2(0);
-        int            nHits(HelixData._chHitsToProcess.size());
+	ComboHit*      hitP1(0);
 	int            wg  = 1;
 	int            counter = 0;
 
+	// the hit phi values change with the loop resolution, reload them
+	loadWorkspace(HelixData._chHitsToProcess);
+	const float*    hitZ   = _ws.z().data();
+	const float*    hitPhi = _ws.phi().data();
+	const uint16_t* hitFace= _ws.face().data();
+        int            nHits(_ws.size());
+
 	//reset the array
-	for (unsigned i=0; i<_fitFZNBins; ++i) hist[i]=0;
+	hist.assign(_fitFZNBins,0);
 
 	for (int f1=0; f1<nHits-1; ++f1){
-	  hitP1 = &HelixData._chHitsToProcess[f1];
-	  if (!use(*hitP1))                               continue;
-	  facezF1 = hitP1->strawId().uniqueFace();
-
 	  for (int f2=f1+1; f2<nHits; ++f2){
-	    hitP2 = &HelixData._chHitsToProcess[f2];
-	    facezF2 = hitP2->strawId().uniqueFace();
-
-	    if (!use(*hitP2) || (facezF1 == facezF2) )    continue;
+	    if (hitFace[f1] == hitFace[f2])    continue;
 		
-	    float dz   = hitP2->pos().z() - hitP1->pos().z();//facezF2->z - facezF1->z;
-	    float dphi = hitP2->helixPhi()- hitP1->helixPhi(); 
+	    float dz   = hitZ[f2] - hitZ[f1];
+	    float dphi = hitPhi[f2]- hitPhi[f1]; 
 	    if (fabs(dphi) < _mindphi)          continue;
   
 	    float lambda = dz/dphi;
@@ -1249,89 +1242,61 @@ namespace mu2e
     }
   }
   
-  void RobustHelixFit::findAGE(RobustHelixFinderData const& HelixData, XYZVec const& center,float& rmed, float& age)
-  {     
-    const ComboHitCollection& hhits = HelixData._hseed._hhits;
-
-    // fill radial information for all points, given this center
-    std::vector<WVal> radii;
-    float wtot(0.0);
+  void RobustHelixFit::loadWorkspace(std::vector<ComboHit> const& hhits)
+  {
+    _ws.clear();
     for(auto const& hhit : hhits)
       {
 	if(use(hhit))
-	  {
-	    // find radial information for this point
-	    float rad = sqrtf(XYZVec(hhit._pos - center).perp2());
-	    float wt = hitWeight(hhit);
-	    radii.push_back(make_pair(rad,wt));
-	    wtot += wt;
-	  }
+	  _ws.push(hhit._pos.x(),hhit._pos.y(),hhit._pos.z(),hhit._hphi,hitWeight(hhit),hhit.strawId().uniqueFace());
       }
+  }
+
+  void RobustHelixFit::findAGE(XYZVec const& center,float& rmed, float& age)
+  {     
+    // fill radial information for all points, given this center
+    _ws.fillRadii(center.x(),center.y());
+    std::vector<float> const& radii = _ws.radii();
+    std::vector<float> const& wts   = _ws.weight();
 
     // optionally add calo cluster
-    if(_usecc && HelixData._hseed.caloCluster().isNonnull())
-      {
-	// mu2e::GeomHandle<mu2e::Calorimeter> ch;
-	// const Calorimeter* calo = ch.get();
-	XYZVec cog = Geom::toXYZVec(_calorimeter->geomUtil().mu2eToTracker(_calorimeter->geomUtil().diskFFToMu2e(HelixData._hseed.caloCluster()->diskID(),HelixData._hseed.caloCluster()->cog3Vector())));
-	float rad = sqrtf(XYZVec(cog - center).perp2());
-	radii.push_back(make_pair(rad,_ccwt));
-      }
+    float rcc(0.0);
+    if(_ccInFit)
+      rcc = sqrtf(XYZVec(_ccPos - center).perp2());
+    size_t npoints = radii.size() + (_ccInFit ? 1 : 0);
 
     // compute AGE
-    if (radii.size() > _minnhit)
+    if (npoints > _minnhit)
       {
-        // find the median radius
-	MedianCalculator accr(radii.size());
+        // find the median radius.  fitCircleAGE calls this for a sequence of nearby centers, so the
+        // radii keep nearly the same order: the incremental calculator reuses the previous order
+	MedianCalculator& accr = _medianCalculator;
+	accr.clear();
         for(unsigned irad=0;irad<radii.size();++irad)
-	  accr.push(radii[irad].first, radii[irad].second);
+	  accr.push(radii[irad], wts[irad]);
+	if(_ccInFit)
+	  accr.push(rcc, _ccwt);
 
         rmed = accr.weightedMedian();
         // now compute the AGE (Absolute Geometric Error)
-        age = 0.0;
-        for(unsigned irad=0;irad<radii.size();++irad)
-	  age += radii[irad].second*abs(radii[irad].first-rmed);
+        age = _ws.absDevSum(rmed);
+	if(_ccInFit)
+	  age += _ccwt*fabs(rcc-rmed);
 
         // normalize
-        age *= radii.size()/wtot;
+        age *= npoints/_ws.weightSum();
       }
   }
 
 
-  void RobustHelixFit::fillSums(RobustHelixFinderData const& HelixData, XYZVec const& center,float rmed, AGESums& sums)
+  void RobustHelixFit::fillSums(XYZVec const& center,float rmed, AGESums& sums)
   {    
-    ComboHitCollection const& hhits = HelixData._hseed._hhits;
-    sums.clear();
-
-    float wtot(0.0);
-    for (const auto& hhit : hhits)
-      {
-	if (!use(hhit)) continue;
-	// find radial information for this point
-	float rad = sqrtf(XYZVec(hhit._pos - center).perp2());
-	float wt = hitWeight(hhit);
-	// now x,y projections
-	float pcos = (hhit._pos.x()-center.x())/rad;
-	float psin = (hhit._pos.y()-center.y())/rad;
-	// 3 conditions: either the radius is inside the median, outside the median, or 'on' the median.  We define 'on'
-	// in terms of a window
-	if(fabs(rmed - rad) < _rwind  ){
-	  sums._scc += wt*fabs(pcos);
-	  sums._ssc += wt*fabs(psin);
-	  ++sums._nc;
-	} else if (rad > rmed  ) {
-	  sums._sco += wt*pcos;
-	  sums._sso += wt*psin;
-	  ++sums._no;
-	} else {
-	  sums._sci += wt*pcos;
-	  sums._ssi += wt*psin;
-	  ++sums._ni;
-	}
-	wtot += wt;
-      }
+    // 3 conditions: either the radius is inside the median, outside the median, or 'on' the median.  We define 'on'
+    // in terms of a window
+    _ws.fillAGESums(center.x(),center.y(),rmed,_rwind,sums);
 
     // normalize to unit weight
+    float wtot = _ws.weightSum();
     unsigned nused = sums._nc + sums._no + sums._ni;
     sums._scc *= nused/wtot;
     sums._ssc *= nused/wtot;
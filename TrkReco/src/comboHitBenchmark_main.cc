@@ -0,0 +1,228 @@
+//
+// Compare the memory and the speed of the pattern recognition hit loops run
+// on ComboHits and on their ComboHitSoA copy, on a mixed sample: a helix of
+// conversion electron hits, compact delta electron clusters, and hits flat in
+// space and time.  The loops are those of
+//  - assign: TimeClusterFinder::assignHits, closest time peak of each hit
+//  - phi:    TimeClusterFinder::prefilterCluster, largest azimuth difference
+//            of the time peak hits wrt the peak direction
+//  - select: CalHelixFinderAlg::fillFaceOrderedHits, selection of the time
+//            peak hits on flag, energy and azimuth wrt the calorimeter cluster
+// The time to fill the ComboHitSoA, once per event, is given separately.
+// The results are checked against the ComboHit loops.
+//
+// usage: comboHitBenchmark [ntrials]
+//
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/TrkReco/inc/ComboHitSoA.hh"
+#include "Offline/Mu2eUtilities/inc/polyAtan2.hh"
+
+using namespace mu2e;
+
+namespace {
+
+  const StrawHitFlag sel(StrawHitFlag::energysel);
+  const StrawHitFlag bkg(StrawHitFlag::bkg);
+  const float        maxdt(40.0), maxEdep(0.0045);
+
+  bool good(StrawHitFlag const& flag) { return flag.hasAllProperties(sel) && !flag.hasAnyProperty(bkg); }
+
+  // closest peak within maxdt, or -1
+  int closestPeak(float time, std::vector<float> const& peaks) {
+    int   best(-1);
+    float mindt(1e5);
+    for (size_t ip=0; ip<peaks.size(); ++ip) {
+      float dt = std::fabs(time - peaks[ip]);
+      if (dt < maxdt && dt < mindt) { mindt = dt; best = ip; }
+    }
+    return best;
+  }
+
+  void assignComboHits(ComboHitCollection const& chcol, std::vector<float> const& peaks, std::vector<int>& npeak) {
+    std::fill(npeak.begin(), npeak.end(), 0);
+    for (auto const& ch : chcol) {
+      if (!good(ch.flag())) continue;
+      int ip = closestPeak(ch.time(), peaks);
+      if (ip >= 0) ++npeak[ip];
+    }
+  }
+
+  void assignSoA(ComboHitSoA::View const& hits, std::vector<float> const& peaks, std::vector<int>& npeak) {
+    std::fill(npeak.begin(), npeak.end(), 0);
+    for (size_t i=0; i<hits.n; ++i) {
+      if (!good(hits.flag[i])) continue;
+      int ip = closestPeak(hits.t[i], peaks);
+      if (ip >= 0) ++npeak[ip];
+    }
+  }
+
+  float deltaPhi(float phi, float ref) {
+    float dphi = phi - ref;
+    if (dphi >  M_PI) dphi -= 2*M_PI;
+    if (dphi < -M_PI) dphi += 2*M_PI;
+    return std::fabs(dphi);
+  }
+
+  float maxDPhiComboHits(ComboHitCollection const& chcol, std::vector<StrawHitIndex> const& hits, float pphi) {
+    float maxdphi(0);
+    for (auto i : hits) maxdphi = std::max(maxdphi, deltaPhi(polyAtan2(chcol[i].pos().y(), chcol[i].pos().x()), pphi));
+    return maxdphi;
+  }
+
+  float maxDPhiSoA(ComboHitSoA::View const& v, std::vector<StrawHitIndex> const& hits, float pphi) {
+    float maxdphi(0);
+    for (auto i : hits) maxdphi = std::max(maxdphi, deltaPhi(v.phi[i], pphi));
+    return maxdphi;
+  }
+
+  unsigned selectComboHits(ComboHitCollection const& chcol, std::vector<StrawHitIndex> const& hits, float clPhi) {
+    unsigned nsel(0);
+    for (auto i : hits) {
+      ComboHit const& ch = chcol[i];
+      if (!good(ch.flag()) || ch.energyDep() > maxEdep) continue;
+      if (deltaPhi(polyAtan2(ch.pos().y(), ch.pos().x()), clPhi) > M_PI/2) continue;
+      ++nsel;
+    }
+    return nsel;
+  }
+
+  unsigned selectSoA(ComboHitSoA::View const& v, std::vector<StrawHitIndex> const& hits, float clPhi) {
+    unsigned nsel(0);
+    for (auto i : hits) {
+      if (!good(v.flag[i]) || v.edep[i] > maxEdep) continue;
+      if (deltaPhi(v.phi[i], clPhi) > M_PI/2) continue;
+      ++nsel;
+    }
+    return nsel;
+  }
+
+  template<class F>
+  double timeIt(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+  }
+}
+
+int main(int argc, char** argv) {
+
+  const unsigned ntrials = argc > 1 ? std::stoi(argv[1]) : 200;
+
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> flat(0., 1.);
+  std::normal_distribution<float> gauss(0., 1.);
+  bool ok = true;
+  volatile float sink(0);
+
+  std::cout << "sizeof(ComboHit) = " << sizeof(ComboHit) << " bytes" << std::endl;
+  std::cout << "memory in kB, ComboHits / SoA; times in us per event, ComboHit loops / SoA" << std::endl;
+  std::cout << std::setw(6) << "nhits" << std::setw(16) << "memory" << std::setw(10) << "fill"
+            << std::setw(16) << "assign" << std::setw(16) << "phi" << std::setw(16) << "select" << std::endl;
+
+  for (unsigned nhits : {1000, 3000, 6000, 12000}) {
+    // 5 conversion-like helices of 50 hits, delta clusters of 10 hits for a third of the hits, the rest flat
+    ComboHitCollection chcol;
+    std::vector<float> peaks;
+    auto addHit = [&](float x, float y, float z, float t, float edep, bool isbkg) {
+      ComboHit hit;
+      hit._pos  = XYZVec(x,y,z);
+      hit._time = t;
+      hit._edep = edep;
+      hit._nsh  = 1 + 2*flat(gen);
+      hit._flag.merge(StrawHitFlag::energysel);
+      if (isbkg) hit._flag.merge(StrawHitFlag::bkg);
+      chcol.push_back(hit);
+    };
+    for (unsigned ih=0; ih<5; ++ih) {
+      float t0 = 600. + 200.*ih + 20.*flat(gen);
+      float cx = 200.*(flat(gen)-0.5), cy = 200.*(flat(gen)-0.5), phi0 = 6.283*flat(gen);
+      peaks.push_back(t0);
+      for (unsigned i=0; i<50; ++i) {
+        float z = -1500. + 3000.*flat(gen), phi = phi0 + z/150.;
+        addHit(cx + 250.*cos(phi), cy + 250.*sin(phi), z, t0 + 5.*gauss(gen), 0.002 + 0.0005*gauss(gen), false);
+      }
+    }
+    while (chcol.size() < nhits/3) {
+      float r = 400. + 300.*flat(gen), phi = 6.283*flat(gen), z = -1500. + 3000.*flat(gen), t = 500. + 1200.*flat(gen);
+      for (unsigned i=0; i<10; ++i)
+        addHit(r*cos(phi) + 5.*gauss(gen), r*sin(phi) + 5.*gauss(gen), z + 20.*gauss(gen), t + 3.*gauss(gen), 0.003*flat(gen), flat(gen) < 0.8);
+    }
+    while (chcol.size() < nhits) {
+      float r = 380. + 320.*std::sqrt(flat(gen)), phi = 6.283*flat(gen);
+      addHit(r*cos(phi), r*sin(phi), -1500. + 3000.*flat(gen), 500. + 1200.*flat(gen), 0.006*flat(gen), flat(gen) < 0.1);
+    }
+    std::shuffle(chcol.begin(), chcol.end(), gen);
+
+    ComboHitSoA soa;
+    soa.fill(chcol);
+    ComboHitSoA::View hits = soa.view();
+
+    // the hits of each time peak, and its direction
+    std::vector<std::vector<StrawHitIndex> > peakHits(peaks.size());
+    std::vector<float> peakPhi(peaks.size());
+    for (size_t i=0; i<chcol.size(); ++i) {
+      int ip = closestPeak(chcol[i].time(), peaks);
+      if (ip >= 0) peakHits[ip].push_back(i);
+    }
+    for (size_t ip=0; ip<peaks.size(); ++ip) peakPhi[ip] = 6.283*flat(gen) - 3.1416;
+
+    // check
+    std::vector<int> n1(peaks.size()), n2(peaks.size());
+    assignComboHits(chcol, peaks, n1);
+    assignSoA(hits, peaks, n2);
+    if (n1 != n2) ok = false;
+    for (size_t ip=0; ip<peaks.size(); ++ip) {
+      if (maxDPhiComboHits(chcol, peakHits[ip], peakPhi[ip]) != maxDPhiSoA(hits, peakHits[ip], peakPhi[ip])) ok = false;
+      if (selectComboHits(chcol, peakHits[ip], peakPhi[ip]) != selectSoA(hits, peakHits[ip], peakPhi[ip])) ok = false;
+    }
+
+    double tfill = timeIt([&]{ for (unsigned i=0; i<ntrials; ++i) { soa.fill(chcol); sink = sink + soa.view().x[0]; } });
+    double ta0 = timeIt([&]{ for (unsigned i=0; i<ntrials; ++i) { assignComboHits(chcol, peaks, n1); sink = sink + n1[0]; } });
+    double ta1 = timeIt([&]{ for (unsigned i=0; i<ntrials; ++i) { assignSoA(hits, peaks, n2); sink = sink + n2[0]; } });
+    // the phi loop runs once per removed hit: 10 times per peak
+    double tp0 = timeIt([&]{
+        for (unsigned i=0; i<ntrials; ++i)
+          for (size_t ip=0; ip<peaks.size(); ++ip)
+            for (unsigned k=0; k<10; ++k) sink = sink + maxDPhiComboHits(chcol, peakHits[ip], peakPhi[ip]);
+      });
+    double tp1 = timeIt([&]{
+        for (unsigned i=0; i<ntrials; ++i)
+          for (size_t ip=0; ip<peaks.size(); ++ip)
+            for (unsigned k=0; k<10; ++k) sink = sink + maxDPhiSoA(hits, peakHits[ip], peakPhi[ip]);
+      });
+    double ts0 = timeIt([&]{
+        for (unsigned i=0; i<ntrials; ++i)
+          for (size_t ip=0; ip<peaks.size(); ++ip) sink = sink + selectComboHits(chcol, peakHits[ip], peakPhi[ip]);
+      });
+    double ts1 = timeIt([&]{
+        for (unsigned i=0; i<ntrials; ++i)
+          for (size_t ip=0; ip<peaks.size(); ++ip) sink = sink + selectSoA(hits, peakHits[ip], peakPhi[ip]);
+      });
+
+    auto pr = [](double t0, double t1, unsigned n) {
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(1) << t0/n*1e6 << " / " << t1/n*1e6;
+      return os.str();
+    };
+    std::ostringstream mem;
+    mem << std::fixed << std::setprecision(1) << chcol.size()*sizeof(ComboHit)/1024. << " / " << soa.bytes()/1024.;
+    std::cout << std::setw(6) << chcol.size() << std::setw(16) << mem.str()
+              << std::setw(10) << std::fixed << std::setprecision(1) << tfill/ntrials*1e6
+              << std::setw(16) << pr(ta0,ta1,ntrials) << std::setw(16) << pr(tp0,tp1,ntrials)
+              << std::setw(16) << pr(ts0,ts1,ntrials) << std::endl;
+  }
+
+  if (!ok) std::cout << "ERROR: SoA results differ from the ComboHit loops" << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+//
+// Time the per-hit loops of RobustHelixFit on the HelixFitWorkspace arrays,
+// and compare them to the loops over the ComboHits they replace:
+//  - AGE:  radii wrt a center and the weighted absolute deviation, as in findAGE
+//  - sums: the AGE descent sums, as in fillSums
+//  - dz:   the |dz| histogram of all the pairs of hits in different faces, as in fillArrayDz
+// The hits are on a helix of radius 250 mm, with uniform background hits.
+// The results are checked against the ComboHit loops.
+//
+// usage: helixFitBenchmark [ntrials]
+//
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/TrkReco/inc/HelixFitWorkspace.hh"
+
+using namespace mu2e;
+
+namespace {
+
+  StrawHitFlag dontUse(StrawHitFlag::outlier);
+
+  // the AGE of the hits wrt center, given the median radius
+  float comboHitAGE(ComboHitCollection const& hhits, XYZVec const& center, float rmed) {
+    std::vector<std::pair<float,float> > radii;
+    float wtot(0.0);
+    for (auto const& hhit : hhits) {
+      if (hhit._flag.hasAnyProperty(dontUse)) continue;
+      float rad = sqrtf(XYZVec(hhit._pos - center).perp2());
+      float wt  = hhit.nStrawHits();
+      radii.push_back(std::make_pair(rad,wt));
+      wtot += wt;
+    }
+    float age(0.0);
+    for (auto const& r : radii) age += r.second*std::fabs(r.first-rmed);
+    return age*radii.size()/wtot;
+  }
+
+  void comboHitSums(ComboHitCollection const& hhits, XYZVec const& center, float rmed, float rwind, AGESums& sums) {
+    sums.clear();
+    for (auto const& hhit : hhits) {
+      if (hhit._flag.hasAnyProperty(dontUse)) continue;
+      float rad  = sqrtf(XYZVec(hhit._pos - center).perp2());
+      float wt   = hhit.nStrawHits();
+      float pcos = (hhit._pos.x()-center.x())/rad;
+      float psin = (hhit._pos.y()-center.y())/rad;
+      if (std::fabs(rmed - rad) < rwind) {
+        sums._scc += wt*std::fabs(pcos);
+        sums._ssc += wt*std::fabs(psin);
+        ++sums._nc;
+      } else if (rad > rmed) {
+        sums._sco += wt*pcos;
+        sums._sso += wt*psin;
+        ++sums._no;
+      } else {
+        sums._sci += wt*pcos;
+        sums._ssi += wt*psin;
+        ++sums._ni;
+      }
+    }
+  }
+
+  unsigned comboHitDzHist(ComboHitCollection const& hhits, float startDz, float binSize, std::vector<int>& hist) {
+    unsigned counter(0);
+    int      nhits = hhits.size();
+    int      nbins = hist.size();
+    for (int f1=0; f1<nhits-1; ++f1) {
+      ComboHit const& h1 = hhits[f1];
+      if (h1._flag.hasAnyProperty(dontUse)) continue;
+      for (int f2=f1+1; f2<nhits; ++f2) {
+        ComboHit const& h2 = hhits[f2];
+        if (h2._flag.hasAnyProperty(dontUse)) continue;
+        if (h1.strawId().uniqueFace() == h2.strawId().uniqueFace()) continue;
+        float dz = std::fabs(h2.pos().z() - h1.pos().z());
+        int   i  = (dz-startDz)/binSize;
+        if (i < nbins) {
+          hist[i] += 1;
+          ++counter;
+        }
+      }
+    }
+    return counter;
+  }
+
+  template<class F>
+  double timeIt(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+  }
+
+  float relDiff(float a, float b) { return std::fabs(a-b)/std::max(1.f,std::fabs(b)); }
+}
+
+int main(int argc, char** argv) {
+
+  const unsigned ntrials = argc > 1 ? std::stoi(argv[1]) : 2000;
+  const float    rwind(10.0), binSize(16.0);
+  const int      nbins(200);
+
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> flat(0., 1.);
+  std::normal_distribution<float> gauss(0., 1.);
+  bool ok = true;
+  volatile float sink(0);
+
+  std::cout << "times in us per call, ComboHit loops / workspace" << std::endl;
+  std::cout << std::setw(6) << "nhits" << std::setw(16) << "AGE" << std::setw(16) << "sums"
+            << std::setw(16) << "dz pairs" << std::setw(12) << "max diff" << std::endl;
+
+  for (unsigned nhits : {20, 50, 100, 200}) {
+    // hits on a helix, 20% background
+    ComboHitCollection hhits;
+    const XYZVec center(100.,50.,0.);
+    for (unsigned i=0; i<nhits; ++i) {
+      ComboHit hit;
+      uint16_t plane = 36*flat(gen);
+      float    z     = -1500. + 86.*plane;
+      float    phi   = z/150. + 0.1*gauss(gen);
+      if (flat(gen) < 0.2) {
+        float r = 400.*std::sqrt(flat(gen)) + 300.;
+        phi = 6.283*flat(gen);
+        hit._pos = XYZVec(r*cos(phi), r*sin(phi), z);
+      } else {
+        float r = 250. + 5.*gauss(gen);
+        hit._pos = XYZVec(center.x() + r*cos(phi), center.y() + r*sin(phi), z);
+      }
+      hit._nsh = 1 + 2*flat(gen);
+      hit._sid = StrawId(plane, uint16_t(6*flat(gen)), uint16_t(96*flat(gen)));
+      if (flat(gen) < 0.05) hit._flag.merge(StrawHitFlag::outlier);
+      hhits.push_back(hit);
+    }
+    HelixFitWorkspace ws;
+    for (auto const& hhit : hhits) {
+      if (hhit._flag.hasAnyProperty(dontUse)) continue;
+      ws.push(hhit._pos.x(),hhit._pos.y(),hhit._pos.z(),hhit._hphi,hhit.nStrawHits(),hhit.strawId().uniqueFace());
+    }
+    // a sequence of nearby centers, as in the AGE iterations
+    std::vector<XYZVec> centers;
+    for (unsigned i=0; i<ntrials; ++i) centers.push_back(XYZVec(center.x()+2.*gauss(gen), center.y()+2.*gauss(gen), 0.));
+    const float rmed(250.);
+
+    float maxdiff(0);
+    for (unsigned i=0; i<std::min(ntrials,100u); ++i) {
+      ws.fillRadii(centers[i].x(), centers[i].y());
+      float age = ws.absDevSum(rmed)*ws.size()/ws.weightSum();
+      maxdiff = std::max(maxdiff, relDiff(age, comboHitAGE(hhits, centers[i], rmed)));
+      AGESums s1, s2;
+      ws.fillAGESums(centers[i].x(), centers[i].y(), rmed, rwind, s1);
+      comboHitSums(hhits, centers[i], rmed, rwind, s2);
+      maxdiff = std::max({maxdiff, relDiff(s1._scc,s2._scc), relDiff(s1._ssc,s2._ssc), relDiff(s1._sco,s2._sco),
+                          relDiff(s1._sso,s2._sso), relDiff(s1._sci,s2._sci), relDiff(s1._ssi,s2._ssi)});
+      if (s1._nc != s2._nc || s1._no != s2._no || s1._ni != s2._ni) ok = false;
+    }
+    std::vector<int> h1(nbins), h2(nbins);
+    if (ws.fillDzHist(0., binSize, h1) != comboHitDzHist(hhits, 0., binSize, h2) || h1 != h2) ok = false;
+    if (maxdiff > 1e-4) ok = false;
+
+    double tage0 = timeIt([&]{ for (auto const& c : centers) sink = sink + comboHitAGE(hhits, c, rmed); });
+    double tage1 = timeIt([&]{
+        for (auto const& c : centers) {
+          ws.fillRadii(c.x(), c.y());
+          sink = sink + ws.absDevSum(rmed)*ws.size()/ws.weightSum();
+        }
+      });
+    AGESums sums;
+    double tsum0 = timeIt([&]{ for (auto const& c : centers) { comboHitSums(hhits, c, rmed, rwind, sums); sink = sink + sums._sco; } });
+    double tsum1 = timeIt([&]{ for (auto const& c : centers) { ws.fillAGESums(c.x(), c.y(), rmed, rwind, sums); sink = sink + sums._sco; } });
+    unsigned ndz = std::max(ntrials/20, 1u);
+    double tdz0  = timeIt([&]{ for (unsigned i=0; i<ndz; ++i) { std::fill(h2.begin(), h2.end(), 0); sink = sink + comboHitDzHist(hhits, 0., binSize, h2); } });
+    double tdz1  = timeIt([&]{ for (unsigned i=0; i<ndz; ++i) { std::fill(h1.begin(), h1.end(), 0); sink = sink + ws.fillDzHist(0., binSize, h1); } });
+
+    auto pr = [](double t0, double t1, unsigned n) {
+      std::ostringstream os;
+      os << std::fixed << std::setprecision(2) << t0/n*1e6 << " / " << t1/n*1e6;
+      return os.str();
+    };
+    std::cout << std::setw(6) << nhits << std::setw(16) << pr(tage0,tage1,ntrials) << std::setw(16) << pr(tsum0,tsum1,ntrials)
+              << std::setw(16) << pr(tdz0,tdz1,ndz) << std::setw(12) << std::scientific << std::setprecision(1) << maxdiff << std::endl;
+  }
+
+  if (!ok) std::cout << "ERROR: workspace results differ from the ComboHit loops" << std::endl;
+  return ok ? 0 : 1;
+}